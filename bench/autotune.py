@@ -0,0 +1,318 @@
+"""
+Per-program auto-tuning of the compiler's tuning parameters (pass thresholds,
+pipelines; `./compiler -X list` prints them all).
+
+Each candidate setting is written as a parameter file, the program is compiled
+with `-C file`, and its cost is measured by one of the evaluators:
+    sim    cycles of the sifive-u74 model (`-R input`, no toolchain needed)
+    qemu   retired instructions under qemu-riscv64 with the insn plugin
+    wall   wall time of the linked binary (native on the board, or --runner)
+A candidate whose program output differs from the reference (the .out file
+next to the program, or the output with default parameters) is rejected.
+
+The search starts from the defaults, then does coordinate descent over the
+search space (each parameter in turn, keep the best value) until the budget is
+used; remaining budget goes to random samples. The best setting per program
+is saved as <out>/<program>.conf, usable as `./compiler ... -C <program>.conf`.
+
+python ./bench/autotune.py ./compiler test/2023/performance/fft0.sy
+python ./bench/autotune.py ./compiler test/2023/performance --cost qemu --budget 40 --out tuned
+python ./bench/autotune.py ./compiler prog.sy --space space.json  # {"name": [values, ...]}
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# default search space; pipelines keep the default first
+SEARCH_SPACE = {
+    "regalloc.vreg-threshold": [1000, 2000, 3000, 5000, 8000],
+    "peephole.constant-hoist-num": [0, 4, 8, 12, 16],
+    "peephole.primary-path-threshold": [0.2, 0.3, 0.4, 0.5, 0.6],
+    "unroll.max-body-insts": [250, 500, 1000, 2000],
+    "unroll.max-factor": [2, 4, 8, 16],
+    "unroll.target-body-insts": [16, 32, 64],
+    "unroll.function-budget": [1500, 3000, 6000],
+    "unroll.int-regs": [16, 20, 24, 28],
+    "unroll.jam-max-factor": [0, 2, 4],
+    "pipeline.loop": [
+        "loopsimplify,gcm,gvn,licm,arraylayout,loopidiom,bitidiom,looprec",
+        "loopsimplify,gcm,gvn,licm,loopidiom,bitidiom,looprec",
+        "loopsimplify,gcm,gvn,licm,loopidiom,looprec",
+        "loopsimplify,gcm,gvn,licm,loopidiom",
+        "loopsimplify,gcm,gvn,licm",
+        "loopsimplify,licm,gcm,gvn,loopidiom,bitidiom,looprec",
+        "loopsimplify,gcm,gvn,licm,loopidiom,bitidiom,looprec,loopsimplify,unroll",
+    ],
+    "pipeline.parallel": [
+        "loopsimplify,gcm,gvn,licm,loopsimplify,blocksort,cfgprint,parallel,inline,simplifycfg",
+        "loopsimplify,gcm,gvn,licm,LoopInterChange,loopsimplify,blocksort,parallel,inline,simplifycfg",
+        "loopsimplify,gcm,gvn,licm,simplifycfg",
+    ],
+}
+
+QEMU = "qemu-riscv64 -L /usr/riscv64-linux-gnu/ -cpu rv64,zba=true,zbb=true"
+GCC = "riscv64-linux-gnu-gcc-12 -march=rv64gc -mabi=lp64d -mcmodel=medlow"
+
+
+def read_defaults(compiler):
+    """name -> default value string, from `compiler -X list`"""
+    proc = subprocess.run([compiler, "-f", "-", "-X", "list"], capture_output=True, text=True)
+    params = {}
+    for line in proc.stdout.splitlines():
+        line = line.strip()
+        if not line or line.startswith("#") or "=" not in line:
+            continue
+        name, value = line.split("=", 1)
+        params[name.strip()] = value.strip()
+    if not params:
+        sys.exit(f"cannot read the parameter list: {proc.stderr.strip()}")
+    return params
+
+
+def write_conf(path, setting, comment=""):
+    with open(path, "w") as f:
+        if comment:
+            f.write(f"# {comment}\n")
+        for name, value in sorted(setting.items()):
+            f.write(f"{name} = {value}\n")
+
+
+class Evaluator:
+    """compile + run one candidate, returns (cost, program output) or (None, error)"""
+
+    def __init__(self, args, work_dir):
+        self.args = args
+        self.work_dir = work_dir
+
+    def compile(self, program, conf, asm):
+        cmd = [self.args.compiler, "-f", program, "-S", "-o", asm, f"-O{self.args.opt}", "-C", conf]
+        return cmd
+
+    def run(self, program, input_file, conf):
+        raise NotImplementedError
+
+
+class SimEvaluator(Evaluator):
+    def run(self, program, input_file, conf):
+        asm = os.path.join(self.work_dir, "cand.s")
+        cmd = self.compile(program, conf, asm) + ["-R", input_file or os.devnull]
+        try:
+            proc = subprocess.run(cmd, capture_output=True, timeout=self.args.timeout)
+        except subprocess.TimeoutExpired:
+            return None, "timeout"
+        report = proc.stderr.decode(errors="replace")
+        cycles = re.search(r"^cycles\s*:\s*(\d+)", report, re.M)
+        exit_code = re.search(r"^exit code\s*:\s*(-?\d+)", report, re.M)
+        if proc.returncode != 0 or cycles is None or "error        :" in report:
+            return None, report[-400:]
+        output = proc.stdout.decode(errors="replace")
+        return int(cycles.group(1)), output + f"\nexit {int(exit_code.group(1)) & 0xFF}"
+
+
+class BinaryEvaluator(Evaluator):
+    """qemu / wall: assemble + link with the SysY runtime, then run"""
+
+    def build(self, program, conf):
+        asm = os.path.join(self.work_dir, "cand.s")
+        exe = os.path.join(self.work_dir, "cand")
+        for cmd in (
+            self.compile(program, conf, asm),
+            GCC.split() + ["-o", exe, asm, self.args.sylib],
+        ):
+            proc = subprocess.run(cmd, capture_output=True, timeout=self.args.timeout)
+            if proc.returncode != 0:
+                return None, proc.stderr.decode(errors="replace")[-400:]
+        return exe, None
+
+    def execute(self, cmd, input_file):
+        stdin = open(input_file, "rb") if input_file else subprocess.DEVNULL
+        try:
+            start = time.perf_counter()
+            proc = subprocess.run(cmd, stdin=stdin, capture_output=True, timeout=self.args.timeout)
+            elapsed = time.perf_counter() - start
+        except subprocess.TimeoutExpired:
+            return None, None, "timeout"
+        finally:
+            if input_file:
+                stdin.close()
+        output = proc.stdout.decode(errors="replace") + f"\nexit {proc.returncode & 0xFF}"
+        return proc, elapsed, output
+
+
+class QemuEvaluator(BinaryEvaluator):
+    def run(self, program, input_file, conf):
+        exe, error = self.build(program, conf)
+        if exe is None:
+            return None, error
+        cmd = QEMU.split() + ["-plugin", self.args.qemu_plugin, "-d", "plugin", exe]
+        proc, _, output = self.execute(cmd, input_file)
+        if proc is None:
+            return None, output
+        insns = re.search(r"insns:\s*(\d+)", proc.stderr.decode(errors="replace"))
+        if insns is None:
+            return None, "no instruction count from the qemu plugin"
+        return int(insns.group(1)), output
+
+
+class WallEvaluator(BinaryEvaluator):
+    def run(self, program, input_file, conf):
+        exe, error = self.build(program, conf)
+        if exe is None:
+            return None, error
+        cmd = (self.args.runner.split() if self.args.runner else []) + [exe]
+        best, output = None, None
+        for _ in range(self.args.repeat):
+            proc, elapsed, output = self.execute(cmd, input_file)
+            if proc is None:
+                return None, output
+            best = elapsed if best is None else min(best, elapsed)
+        return best, output
+
+
+EVALUATORS = {"sim": SimEvaluator, "qemu": QemuEvaluator, "wall": WallEvaluator}
+
+
+def tune(program, evaluator, defaults, space, args, work_dir):
+    base = os.path.splitext(program)[0]
+    input_file = base + ".in" if os.path.exists(base + ".in") else None
+    expected = None
+    if os.path.exists(base + ".out"):
+        with open(base + ".out", errors="replace") as f:
+            expected = f.read()
+
+    conf = os.path.join(work_dir, "cand.conf")
+    cache = {}
+
+    def evaluate(setting):
+        key = tuple(sorted(setting.items()))
+        if key not in cache:
+            write_conf(conf, setting)
+            cost, output = evaluator.run(program, input_file, conf)
+            cache[key] = (cost, output)
+        return cache[key]
+
+    def same_output(output):
+        reference = expected if expected is not None else default_output
+        return output.strip().split() == reference.strip().split()
+
+    setting = {name: defaults[name] for name in space if name in defaults}
+    best_cost, default_output = evaluate(setting)
+    if best_cost is None:
+        print(f"  default setting fails: {default_output}")
+        return None
+    if expected is not None and not same_output(default_output):
+        print("  warning: default output differs from the .out file, using it as reference")
+        expected = None
+    default_cost = best_cost
+    best = dict(setting)
+    print(f"  default: {default_cost}")
+
+    budget = args.budget - 1
+
+    def try_setting(candidate):
+        nonlocal best, best_cost, budget
+        if budget <= 0:
+            return
+        key = tuple(sorted(candidate.items()))
+        fresh = key not in cache
+        cost, output = evaluate(candidate)
+        if fresh:
+            budget -= 1
+        if cost is None or not same_output(output):
+            return
+        if cost < best_cost:
+            best, best_cost = dict(candidate), cost
+            changed = {k: v for k, v in candidate.items() if v != defaults.get(k)}
+            print(f"  better: {cost} {changed}")
+
+    # coordinate descent
+    for _ in range(args.rounds):
+        start = dict(best)
+        for name, values in space.items():
+            for value in values:
+                try_setting({**best, name: str(value)})
+        if best == start:
+            break
+    # random samples
+    rng = random.Random(args.seed)
+    while budget > 0 and len(cache) < args.budget * 4:
+        try_setting({name: str(rng.choice(values)) for name, values in space.items()})
+
+    speedup = default_cost / best_cost if best_cost else 1.0
+    return best, best_cost, default_cost, speedup
+
+
+def collect_programs(paths):
+    programs = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                programs += [os.path.join(root, f) for f in sorted(files) if f.endswith(".sy")]
+        else:
+            programs.append(path)
+    return programs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("compiler")
+    parser.add_argument("programs", nargs="+", help=".sy files or directories")
+    parser.add_argument("--cost", choices=EVALUATORS, default="sim")
+    parser.add_argument("--space", help="JSON search space {name: [values]}, default: built-in")
+    parser.add_argument("--budget", type=int, default=30, help="candidate compilations per program")
+    parser.add_argument("--rounds", type=int, default=2, help="coordinate descent rounds")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("-O", "--opt", type=int, default=1)
+    parser.add_argument("--out", default="tuned", help="directory of the best <program>.conf")
+    parser.add_argument("--timeout", type=int, default=600)
+    parser.add_argument("--sylib", default="test/sysy/sylib.c", help="qemu/wall: SysY runtime")
+    parser.add_argument("--qemu-plugin", default="/usr/lib/qemu/plugins/libinsn.so")
+    parser.add_argument("--runner", default="", help="wall: command prefix, e.g. qemu-riscv64 -L ...")
+    parser.add_argument("--repeat", type=int, default=3, help="wall: runs per candidate, min is kept")
+    args = parser.parse_args()
+
+    defaults = read_defaults(args.compiler)
+    space = SEARCH_SPACE
+    if args.space:
+        with open(args.space) as f:
+            space = json.load(f)
+    unknown = [name for name in space if name not in defaults]
+    if unknown:
+        print(f"ignoring unknown parameters: {', '.join(unknown)}")
+        space = {name: values for name, values in space.items() if name in defaults}
+
+    os.makedirs(args.out, exist_ok=True)
+    summary = {}
+    with tempfile.TemporaryDirectory() as work_dir:
+        evaluator = EVALUATORS[args.cost](args, work_dir)
+        for program in collect_programs(args.programs):
+            name = os.path.splitext(os.path.basename(program))[0]
+            print(f"{name}:")
+            result = tune(program, evaluator, defaults, space, args, work_dir)
+            if result is None:
+                summary[name] = {"error": "default setting fails"}
+                continue
+            best, best_cost, default_cost, speedup = result
+            changed = {k: v for k, v in best.items() if v != defaults[k]}
+            write_conf(
+                os.path.join(args.out, f"{name}.conf"),
+                changed,
+                f"{name}: {args.cost} cost {best_cost} (default {default_cost}, x{speedup:.3f})",
+            )
+            summary[name] = {"cost": best_cost, "default": default_cost, "speedup": speedup, "params": changed}
+            print(f"  best: {best_cost} (x{speedup:.3f})")
+
+    with open(os.path.join(args.out, "summary.json"), "w") as f:
+        json.dump({"cost": args.cost, "opt": args.opt, "programs": summary}, f, indent=2)
+    return 0 if all("error" not in r for r in summary.values()) else 2
+
+
+if __name__ == "__main__":
+    sys.exit(main())
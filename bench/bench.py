@@ -0,0 +1,185 @@
+"""
+Compiler throughput benchmark: measures how fast (and how much memory) the
+compiler itself needs, not the speed of the generated code.
+
+Every program of the corpus (bench/corpus + synthetic stress programs from
+gen.py + any --corpus directory) is compiled at each requested opt level with
+`-P stats.json`, which makes the compiler dump its utils::Profiler stage
+times, peak RSS and arena bytes. Results are written as JSON and compared
+against a stored baseline. The baseline is machine specific and not committed:
+the first run without one records it (bench/baseline.json, git-ignored), later
+runs compare against it.
+
+python ./bench/bench.py ./compiler                       # compare with bench/baseline.json, record it if missing
+python ./bench/bench.py ./compiler --save-baseline       # run + store as new baseline
+python ./bench/bench.py ./compiler --corpus test/2023/performance -O 1
+
+exit code: 0 ok, 1 regression over threshold, 2 compile failure
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+from datetime import datetime
+
+import gen
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+def collect_programs(args, work_dir):
+    programs = []
+    corpus_dirs = [os.path.join(BENCH_DIR, "corpus")] + args.corpus
+    for corpus in corpus_dirs:
+        for root, _, files in os.walk(corpus):
+            for name in sorted(files):
+                if name.endswith(".sy"):
+                    programs.append(os.path.join(root, name))
+    if not args.no_gen:
+        programs += gen.generate(os.path.join(work_dir, "gen"), args.scale)
+    return programs
+
+
+def compile_once(compiler, program, opt, work_dir, timeout):
+    name = os.path.splitext(os.path.basename(program))[0]
+    asm = os.path.join(work_dir, f"{name}.O{opt}.s")
+    stats = os.path.join(work_dir, f"{name}.O{opt}.json")
+    cmd = [compiler, "-f", program, "-S", "-o", asm, f"-O{opt}", "-P", stats]
+    try:
+        proc = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, timeout=timeout)
+    except subprocess.TimeoutExpired:
+        return None, "timeout"
+    if proc.returncode != 0 or not os.path.exists(stats):
+        return None, proc.stderr.decode(errors="replace")[-400:]
+    with open(stats) as f:
+        return json.load(f), None
+
+
+def merge_runs(runs):
+    """min over repeats for times (least noisy), max for memory"""
+    best = dict(runs[0])
+    best["total_ms"] = min(r["total_ms"] for r in runs)
+    best["peak_rss_kb"] = max(r["peak_rss_kb"] for r in runs)
+    best["stages"] = {
+        stage: {
+            "ms": min(r["stages"].get(stage, {"ms": 0.0})["ms"] for r in runs),
+            "count": value["count"],
+        }
+        for stage, value in runs[0]["stages"].items()
+    }
+    return best
+
+
+def run_bench(args):
+    work_dir = args.work_dir or tempfile.mkdtemp(prefix="sysyc-bench-")
+    os.makedirs(work_dir, exist_ok=True)
+    results = {}
+    failures = []
+    for program in collect_programs(args, work_dir):
+        name = os.path.splitext(os.path.basename(program))[0]
+        for opt in args.O:
+            key = f"{name}@O{opt}"
+            runs = []
+            for _ in range(args.repeat):
+                stats, err = compile_once(args.compiler, program, opt, work_dir, args.timeout)
+                if stats is None:
+                    failures.append((key, err))
+                    break
+                runs.append(stats)
+            if len(runs) != args.repeat:
+                print(f"[FAIL] {key}")
+                continue
+            results[key] = merge_runs(runs)
+            r = results[key]
+            print(f"[ OK ] {key:36s} {r['total_ms']:10.2f} ms {r['peak_rss_kb'] / 1024:8.1f} MiB")
+    meta = {
+        "date": datetime.now().isoformat(timespec="seconds"),
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "repeat": args.repeat,
+        "scale": args.scale,
+    }
+    return {"meta": meta, "results": results}, failures
+
+
+def compare(current, baseline, args):
+    """return the list of regressions (key, metric, base, now)"""
+    regressions = []
+    for key, base in baseline["results"].items():
+        now = current["results"].get(key)
+        if now is None:
+            continue
+        checks = [("total_ms", args.time_threshold, args.min_ms)]
+        checks += [("peak_rss_kb", args.mem_threshold, 0)]
+        for metric, threshold, floor in checks:
+            b, n = base[metric], now[metric]
+            if n > b * (1.0 + threshold) and n - b > floor:
+                regressions.append((key, metric, b, n))
+        for kind in ("IR", "MIR"):
+            b, n = base["arena_bytes"][kind], now["arena_bytes"][kind]
+            if n > b * (1.0 + args.mem_threshold) and n - b > 0:
+                regressions.append((key, f"arena_bytes.{kind}", b, n))
+        for stage, value in base["stages"].items():
+            b = value["ms"]
+            n = now["stages"].get(stage, {"ms": 0.0})["ms"]
+            if n > b * (1.0 + args.time_threshold) and n - b > args.min_ms:
+                regressions.append((key, f"stage:{stage}", b, n))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compiler throughput benchmark")
+    parser.add_argument("compiler", help="path to the compiler executable")
+    parser.add_argument("--corpus", action="append", default=[], help="extra directory of .sy files")
+    parser.add_argument("-O", type=int, action="append", help="opt levels (default: 0 and 1)")
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--scale", type=float, default=1.0, help="size factor of synthetic programs")
+    parser.add_argument("--no-gen", action="store_true", help="skip synthetic stress programs")
+    parser.add_argument("--timeout", type=float, default=300)
+    parser.add_argument("--work-dir", default=None)
+    parser.add_argument("--output", default=os.path.join(BENCH_DIR, "results.json"))
+    parser.add_argument("--baseline", default=os.path.join(BENCH_DIR, "baseline.json"))
+    parser.add_argument("--save-baseline", action="store_true")
+    parser.add_argument("--time-threshold", type=float, default=0.15, help="relative slowdown allowed")
+    parser.add_argument("--mem-threshold", type=float, default=0.10, help="relative growth allowed")
+    parser.add_argument("--min-ms", type=float, default=5.0, help="ignore time deltas below this")
+    args = parser.parse_args()
+    args.O = args.O or [0, 1]
+
+    current, failures = run_bench(args)
+    with open(args.output, "w") as f:
+        json.dump(current, f, indent=2)
+    print(f"results written to {args.output}")
+
+    for key, err in failures:
+        print(f"compile failed: {key}\n{err}")
+
+    if args.save_baseline or not os.path.exists(args.baseline):
+        if failures:
+            print(f"compile failures, baseline not recorded at {args.baseline}")
+            return 2
+        with open(args.baseline, "w") as f:
+            json.dump(current, f, indent=2)
+        reason = "" if args.save_baseline else " (none yet, nothing to compare)"
+        print(f"baseline recorded at {args.baseline}{reason}")
+    else:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        if baseline["meta"].get("host") != current["meta"]["host"]:
+            print(f"warning: baseline recorded on {baseline['meta'].get('host')}, times may not compare")
+        regressions = compare(current, baseline, args)
+        for key, metric, b, n in regressions:
+            print(f"[REGRESSION] {key:36s} {metric:48s} {b:12.2f} -> {n:12.2f} ({(n / b - 1) * 100 if b else 0:+.1f}%)")
+        if regressions:
+            return 1
+        print("no regression against baseline")
+
+    return 2 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
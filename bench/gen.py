@@ -0,0 +1,114 @@
+"""
+Synthetic SysY stress programs for the compiler throughput benchmark.
+
+Each generator stresses a different part of the compiler:
+  deep_nest      deeply nested loops            (loop analyses, LICM, GCM)
+  huge_function  one very long straight-line/branchy function (RA, scheduling)
+  large_init     large constant global initialisers (frontend, data emission)
+  many_functions many small functions and calls  (inline, IPRA, call graph)
+
+python ./bench/gen.py output_dir [scale]
+"""
+
+import os
+import sys
+
+
+def deep_nest(depth: int) -> str:
+    lines = ["int a[64];", "int main() {", "  int s = 0;"]
+    for d in range(depth):
+        lines.append("  " * (d + 1) + f"int i{d} = 0;")
+        lines.append("  " * (d + 1) + f"while (i{d} < 3) {{")
+    inner = "  " * (depth + 1)
+    idx = " + ".join(f"i{d}" for d in range(depth))
+    lines.append(inner + f"a[({idx}) % 64] = a[({idx}) % 64] + {depth};")
+    lines.append(inner + f"s = s + a[({idx}) % 64];")
+    for d in reversed(range(depth)):
+        lines.append("  " * (d + 2) + f"i{d} = i{d} + 1;")
+        lines.append("  " * (d + 1) + "}")
+    lines += ["  putint(s);", "  return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+def huge_function(stmts: int) -> str:
+    lines = ["int main() {", "  int x = getint();"]
+    nvars = 64
+    for v in range(nvars):
+        lines.append(f"  int v{v} = x + {v};")
+    for k in range(stmts):
+        a, b, c = k % nvars, (k * 7 + 3) % nvars, (k * 13 + 5) % nvars
+        if k % 5 == 0:
+            lines.append(f"  if (v{b} > v{c}) v{a} = v{b} - v{c}; else v{a} = v{c} * 3 + {k % 17};")
+        else:
+            lines.append(f"  v{a} = (v{b} + v{c} * {k % 11 + 1}) % 1000007;")
+    lines.append("  int s = 0;")
+    for v in range(nvars):
+        lines.append(f"  s = s + v{v};")
+    lines += ["  putint(s);", "  return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+def large_init(elems: int) -> str:
+    vals = ", ".join(str((i * 2654435761) % 1000) for i in range(elems))
+    lines = [
+        f"const int table[{elems}] = {{{vals}}};",
+        f"int data[{elems}] = {{{vals}}};",
+        "int main() {",
+        "  int i = 0;",
+        "  int s = 0;",
+        f"  while (i < {elems}) {{",
+        "    s = (s + table[i] * data[i]) % 65536;",
+        "    i = i + 1;",
+        "  }",
+        "  putint(s);",
+        "  return 0;",
+        "}",
+    ]
+    return "\n".join(lines) + "\n"
+
+
+def many_functions(funcs: int) -> str:
+    lines = []
+    for f in range(funcs):
+        callee = f"f{f - 1}(x + {f % 7})" if f > 0 else "x"
+        lines.append(f"int f{f}(int x) {{")
+        lines.append(f"  if (x > {1000 + f}) return x - {f};")
+        lines.append(f"  return {callee} + {f % 13};")
+        lines.append("}")
+    lines += ["int main() {", "  int s = 0;"]
+    for f in range(0, funcs, max(1, funcs // 32)):
+        lines.append(f"  s = s + f{f}({f % 5});")
+    lines += ["  putint(s);", "  return 0;", "}"]
+    return "\n".join(lines) + "\n"
+
+
+GENERATORS = {
+    "deep_nest": (deep_nest, 12),
+    "huge_function": (huge_function, 4000),
+    "large_init": (large_init, 20000),
+    "many_functions": (many_functions, 600),
+}
+
+
+def generate(output_dir: str, scale: float = 1.0):
+    """write every synthetic program to output_dir, return the file paths"""
+    os.makedirs(output_dir, exist_ok=True)
+    files = []
+    for name, (gen, size) in GENERATORS.items():
+        arg = max(1, int(size * scale))
+        if name == "deep_nest":
+            arg = min(max(arg, 2), 24)  # deeper nests only stress the parser stack
+        path = os.path.join(output_dir, f"gen_{name}.sy")
+        with open(path, "w") as f:
+            f.write(gen(arg))
+        files.append(path)
+    return files
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: python gen.py output_dir [scale]")
+        sys.exit(1)
+    scale = float(sys.argv[2]) if len(sys.argv) > 2 else 1.0
+    for path in generate(sys.argv[1], scale):
+        print(path)
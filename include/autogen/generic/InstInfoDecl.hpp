@@ -32,6 +32,9 @@ enum GENERICInst {
   SMax,
   Neg,
   Abs,
+  CPop,
+  Clz,
+  Ctz,
   FAdd,
   FSub,
   FMul,
@@ -672,6 +672,90 @@ public:
   }
 };
 
+class GENERICInstInfoCPop final : public InstInfo {
+public:
+  GENERICInstInfoCPop() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "GENERIC.CPop"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "CPop" << " " << mir::GENERIC::OperandDumper{inst.operand(0)} << ", "
+        << mir::GENERIC::OperandDumper{inst.operand(1)};
+  }
+};
+
+class GENERICInstInfoClz final : public InstInfo {
+public:
+  GENERICInstInfoClz() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "GENERIC.Clz"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "Clz" << " " << mir::GENERIC::OperandDumper{inst.operand(0)} << ", "
+        << mir::GENERIC::OperandDumper{inst.operand(1)};
+  }
+};
+
+class GENERICInstInfoCtz final : public InstInfo {
+public:
+  GENERICInstInfoCtz() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "GENERIC.Ctz"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "Ctz" << " " << mir::GENERIC::OperandDumper{inst.operand(0)} << ", "
+        << mir::GENERIC::OperandDumper{inst.operand(1)};
+  }
+};
+
 class GENERICInstInfoFAdd final : public InstInfo {
 public:
   GENERICInstInfoFAdd() = default;
@@ -1539,6 +1623,9 @@ class GENERICInstInfo final : public TargetInstInfo {
   GENERICInstInfoSMax _instinfoSMax;
   GENERICInstInfoNeg _instinfoNeg;
   GENERICInstInfoAbs _instinfoAbs;
+  GENERICInstInfoCPop _instinfoCPop;
+  GENERICInstInfoClz _instinfoClz;
+  GENERICInstInfoCtz _instinfoCtz;
   GENERICInstInfoFAdd _instinfoFAdd;
   GENERICInstInfoFSub _instinfoFSub;
   GENERICInstInfoFMul _instinfoFMul;
@@ -1617,6 +1704,12 @@ public:
         return _instinfoNeg;
       case GENERICInst::Abs:
         return _instinfoAbs;
+      case GENERICInst::CPop:
+        return _instinfoCPop;
+      case GENERICInst::Clz:
+        return _instinfoClz;
+      case GENERICInst::Ctz:
+        return _instinfoCtz;
       case GENERICInst::FAdd:
         return _instinfoFAdd;
       case GENERICInst::FSub:
@@ -174,6 +174,27 @@ static bool matchInstAbs(MIRInst* inst, MIROperand& dst, MIROperand& src) {
   return true;
 }
 
+static bool matchInstCPop(MIRInst* inst, MIROperand& dst, MIROperand& src) {
+  if (inst->opcode() != InstCPop) return false;
+  dst = inst->operand(0);
+  src = inst->operand(1);
+  return true;
+}
+
+static bool matchInstClz(MIRInst* inst, MIROperand& dst, MIROperand& src) {
+  if (inst->opcode() != InstClz) return false;
+  dst = inst->operand(0);
+  src = inst->operand(1);
+  return true;
+}
+
+static bool matchInstCtz(MIRInst* inst, MIROperand& dst, MIROperand& src) {
+  if (inst->opcode() != InstCtz) return false;
+  dst = inst->operand(0);
+  src = inst->operand(1);
+  return true;
+}
+
 static bool matchInstFAdd(MIRInst* inst, MIROperand& dst, MIROperand& src1, MIROperand& src2) {
   if (inst->opcode() != InstFAdd) return false;
   dst = inst->operand(0);
@@ -2997,6 +3018,127 @@ static bool matchAndSelectPattern80(MIRInst* inst1, ISelContext& ctx) {
 
 /* InstSExt matchAndSelectPatternInstSExtend */
 
+/* InstTrunc matchAndSelectPatternInstTrunc begin */
+static bool matchAndSelectPattern81(MIRInst* inst1, ISelContext& ctx) {
+  uint32_t rootOpcode = InstTrunc;
+  /** Match Inst **/
+  /* match inst InstTrunc */
+  MIROperand op1;
+  MIROperand op2;
+  if (not matchInstTrunc(inst1, op1, op2)) {
+    return false;
+  }
+
+  /* match predicate for operands  */
+  if (not(isOperandIReg(op2))) {
+    return false;
+  }
+
+  /** Select Inst **/
+  auto op4 = (op1);
+  auto op5 = (op2);
+  auto op6 = (MIROperand::asImm(0, OperandType::Int32));
+  /* select inst ADDIW */
+  auto inst2 = ctx.insertMIRInst(ADDIW, {op4, op5, op6});
+
+  /* Replace Operand */
+  ctx.replace_operand(ctx.getInstDefOperand(inst1), ctx.getInstDefOperand(inst2));
+  ctx.remove_inst(inst1);
+  return true;
+}
+
+/* InstTrunc matchAndSelectPatternInstTruncend */
+
+/* InstCPop matchAndSelectPatternInstCPop begin */
+static bool matchAndSelectPattern82(MIRInst* inst1, ISelContext& ctx) {
+  uint32_t rootOpcode = InstCPop;
+  /** Match Inst **/
+  /* match inst InstCPop */
+  MIROperand op1;
+  MIROperand op2;
+  if (not matchInstCPop(inst1, op1, op2)) {
+    return false;
+  }
+
+  /* match predicate for operands  */
+  if (not(isOperandIReg(op2) && isOperandI32(op1))) {
+    return false;
+  }
+
+  /** Select Inst **/
+  auto op4 = (op1);
+  auto op5 = (op2);
+  /* select inst CPOPW */
+  auto inst2 = ctx.insertMIRInst(CPOPW, {op4, op5});
+
+  /* Replace Operand */
+  ctx.replace_operand(ctx.getInstDefOperand(inst1), ctx.getInstDefOperand(inst2));
+  ctx.remove_inst(inst1);
+  return true;
+}
+
+/* InstCPop matchAndSelectPatternInstCPopend */
+
+/* InstClz matchAndSelectPatternInstClz begin */
+static bool matchAndSelectPattern83(MIRInst* inst1, ISelContext& ctx) {
+  uint32_t rootOpcode = InstClz;
+  /** Match Inst **/
+  /* match inst InstClz */
+  MIROperand op1;
+  MIROperand op2;
+  if (not matchInstClz(inst1, op1, op2)) {
+    return false;
+  }
+
+  /* match predicate for operands  */
+  if (not(isOperandIReg(op2) && isOperandI32(op1))) {
+    return false;
+  }
+
+  /** Select Inst **/
+  auto op4 = (op1);
+  auto op5 = (op2);
+  /* select inst CLZW */
+  auto inst2 = ctx.insertMIRInst(CLZW, {op4, op5});
+
+  /* Replace Operand */
+  ctx.replace_operand(ctx.getInstDefOperand(inst1), ctx.getInstDefOperand(inst2));
+  ctx.remove_inst(inst1);
+  return true;
+}
+
+/* InstClz matchAndSelectPatternInstClzend */
+
+/* InstCtz matchAndSelectPatternInstCtz begin */
+static bool matchAndSelectPattern84(MIRInst* inst1, ISelContext& ctx) {
+  uint32_t rootOpcode = InstCtz;
+  /** Match Inst **/
+  /* match inst InstCtz */
+  MIROperand op1;
+  MIROperand op2;
+  if (not matchInstCtz(inst1, op1, op2)) {
+    return false;
+  }
+
+  /* match predicate for operands  */
+  if (not(isOperandIReg(op2) && isOperandI32(op1))) {
+    return false;
+  }
+
+  /** Select Inst **/
+  auto op4 = (op1);
+  auto op5 = (op2);
+  /* select inst CTZW */
+  auto inst2 = ctx.insertMIRInst(CTZW, {op4, op5});
+
+  /* Replace Operand */
+  ctx.replace_operand(ctx.getInstDefOperand(inst1), ctx.getInstDefOperand(inst2));
+  ctx.remove_inst(inst1);
+  return true;
+}
+
+/* InstCtz matchAndSelectPatternInstCtzend */
+
 static bool matchAndSelectImpl(MIRInst* inst, ISelContext& ctx, bool debugMatchSelect) {
   bool success = false;
   switch (inst->opcode()) {
@@ -3422,6 +3564,34 @@ static bool matchAndSelectImpl(MIRInst* inst, ISelContext& ctx, bool debugMatchS
       }
       break;
     }
+    case InstTrunc: {
+      if (matchAndSelectPattern81(inst, ctx)) {
+        success = true;
+        break;
+      }
+      break;
+    }
+    case InstCPop: {
+      if (matchAndSelectPattern82(inst, ctx)) {
+        success = true;
+        break;
+      }
+      break;
+    }
+    case InstClz: {
+      if (matchAndSelectPattern83(inst, ctx)) {
+        success = true;
+        break;
+      }
+      break;
+    }
+    case InstCtz: {
+      if (matchAndSelectPattern84(inst, ctx)) {
+        success = true;
+        break;
+      }
+      break;
+    }
     default:
       break;
   }
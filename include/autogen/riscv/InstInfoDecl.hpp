@@ -29,6 +29,9 @@ enum RISCVInst {
   SLLW,
   SRLW,
   SRAW,
+  CLZW,
+  CTZW,
+  CPOPW,
   SLLI_UW,
   ADDIW,
   BEQ,
@@ -105,6 +108,7 @@ enum RISCVInst {
   SH,
   SW,
   SD,
+  PREFETCH_R,
   JAL,
   J,
   RET,
@@ -595,6 +595,90 @@ public:
   }
 };
 
+class RISCVInstInfoCLZW final : public InstInfo {
+public:
+  RISCVInstInfoCLZW() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "RISCV.CLZW"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "clzw" << " " << mir::RISCV::OperandDumper{inst.operand(0)} << ", "
+        << mir::RISCV::OperandDumper{inst.operand(1)};
+  }
+};
+
+class RISCVInstInfoCTZW final : public InstInfo {
+public:
+  RISCVInstInfoCTZW() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "RISCV.CTZW"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "ctzw" << " " << mir::RISCV::OperandDumper{inst.operand(0)} << ", "
+        << mir::RISCV::OperandDumper{inst.operand(1)};
+  }
+};
+
+class RISCVInstInfoCPOPW final : public InstInfo {
+public:
+  RISCVInstInfoCPOPW() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagDef;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone; }
+
+  std::string_view name() const override { return "RISCV.CPOPW"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "cpopw" << " " << mir::RISCV::OperandDumper{inst.operand(0)} << ", "
+        << mir::RISCV::OperandDumper{inst.operand(1)};
+  }
+};
+
 class RISCVInstInfoSLLI_UW final : public InstInfo {
 public:
   RISCVInstInfoSLLI_UW() = default;
@@ -2957,6 +3041,34 @@ public:
   }
 };
 
+class RISCVInstInfoPREFETCH_R final : public InstInfo {
+public:
+  RISCVInstInfoPREFETCH_R() = default;
+
+  uint32_t operand_num() const override { return 2; }
+
+  OperandFlag operand_flag(uint32_t idx) const override {
+    switch (idx) {
+      case 0:
+        return OperandFlagMetadata;
+      case 1:
+        return OperandFlagUse;
+      default:
+        return OperandFlagNone;
+        assert(false && "Invalid operand index");
+    }
+  }
+
+  uint32_t inst_flag() const override { return InstFlagNone | InstFlagLoad; }
+
+  std::string_view name() const override { return "RISCV.PREFETCH_R"; }
+
+  void print(std::ostream& out, MIRInst& inst, bool comment) const override {
+    out << "prefetch.r" << " " << mir::RISCV::OperandDumper{inst.operand(0)} << "("
+        << mir::RISCV::OperandDumper{inst.operand(1)} << ")";
+  }
+};
+
 class RISCVInstInfoJAL final : public InstInfo {
 public:
   RISCVInstInfoJAL() = default;
@@ -3715,6 +3827,9 @@ class RISCVInstInfo final : public TargetInstInfo {
   RISCVInstInfoSLLW _instinfoSLLW;
   RISCVInstInfoSRLW _instinfoSRLW;
   RISCVInstInfoSRAW _instinfoSRAW;
+  RISCVInstInfoCLZW _instinfoCLZW;
+  RISCVInstInfoCTZW _instinfoCTZW;
+  RISCVInstInfoCPOPW _instinfoCPOPW;
   RISCVInstInfoSLLI_UW _instinfoSLLI_UW;
   RISCVInstInfoADDIW _instinfoADDIW;
   RISCVInstInfoBEQ _instinfoBEQ;
@@ -3791,6 +3906,7 @@ class RISCVInstInfo final : public TargetInstInfo {
   RISCVInstInfoSH _instinfoSH;
   RISCVInstInfoSW _instinfoSW;
   RISCVInstInfoSD _instinfoSD;
+  RISCVInstInfoPREFETCH_R _instinfoPREFETCH_R;
   RISCVInstInfoJAL _instinfoJAL;
   RISCVInstInfoJ _instinfoJ;
   RISCVInstInfoRET _instinfoRET;
@@ -3859,6 +3975,12 @@ public:
         return _instinfoSRLW;
       case RISCVInst::SRAW:
         return _instinfoSRAW;
+      case RISCVInst::CLZW:
+        return _instinfoCLZW;
+      case RISCVInst::CTZW:
+        return _instinfoCTZW;
+      case RISCVInst::CPOPW:
+        return _instinfoCPOPW;
       case RISCVInst::SLLI_UW:
         return _instinfoSLLI_UW;
       case RISCVInst::ADDIW:
@@ -4011,6 +4133,8 @@ public:
         return _instinfoSW;
       case RISCVInst::SD:
         return _instinfoSD;
+      case RISCVInst::PREFETCH_R:
+        return _instinfoPREFETCH_R;
       case RISCVInst::JAL:
         return _instinfoJAL;
       case RISCVInst::J:
@@ -118,6 +118,7 @@ public:
       case SW:
       case LD:
       case SD:
+      case PREFETCH_R:
       case InstStoreRegToStack:
       case LR_W:
       case SC_W:
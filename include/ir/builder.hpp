@@ -290,6 +290,11 @@ public:  // Position management methods
    */
   Value* makeBinary(BinaryOp op, Value* lhs, Value* rhs);
 
+  /**
+   * @brief The instruction kind makeBinary creates for op on operands of type
+   */
+  static ValueId binaryValueId(BinaryOp op, const Type* type);
+
   /**
    * @brief Creates a unary instruction
    * @param vid The value ID for the unary operation
@@ -210,6 +210,7 @@ protected:
   size_t mVarCnt = 0;                  ///< Counter for local variable naming
   size_t argCnt = 0;                   ///< Number of formal arguments
   Attribute<FunctionAttribute> mAttribute; ///< Function attributes
+  bool mChanged = true;                ///< Changed since the last IRCheck
 
 public:
   /**
@@ -310,6 +311,7 @@ public:  // Mutator methods
    * @param bb The basic block to use as entry
    */
   void setEntry(ir::BasicBlock* bb) {
+    if (mEntry) mEntry->markChanged();
     mEntry = bb;
     bb->set_parent(this);
   }
@@ -319,6 +321,7 @@ public:  // Mutator methods
    * @param bb The basic block to use as exit
    */
   void setExit(ir::BasicBlock* bb) {
+    if (mExit) mExit->markChanged();
     mExit = bb;
     bb->set_parent(this);
   }
@@ -393,6 +396,29 @@ public:  // Mutator methods
   void delArgumant(size_t idx) {
     assert(idx < argCnt && "idx out of args vector");
     mArguments.erase(mArguments.begin() + idx);
+    markChanged();
+  }
+
+  /**
+   * @brief Checks whether the function changed since IRCheck last verified it
+   *
+   * Set by every IR mutation of the function, its blocks and their
+   * instructions; a new function starts out changed.
+   */
+  bool changed() const { return mChanged; }
+
+  /**
+   * @brief Marks the function for re-verification by IRCheck
+   */
+  void markChanged() { mChanged = true; }
+
+  /**
+   * @brief Clears the change marks of the function and its blocks once verified
+   */
+  void clearChanged() {
+    mChanged = false;
+    for (auto block : mBlocks)
+      block->clearChanged();
   }
 
 public:  // Utility functions
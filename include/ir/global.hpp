@@ -20,6 +20,7 @@ protected:
   bool mIsConst = false;
   bool mIsInit = true;
   std::vector<Value*> mInitValues;
+  size_t mAlign = 0;  // bytes, 0: the default of the target
 
 public:
   GlobalVariable(Type* base_type,
@@ -101,6 +102,8 @@ public:  // get function
   }
   auto init_cnt() const { return mInitValues.size(); }
   auto init(size_t index) const { return mInitValues.at(index); }
+  auto align() const { return mAlign; }
+  void setAlign(size_t align) { mAlign = align; }
 
   Type* baseType() const {
     assert(dyn_cast<PointerType>(type()) && "type error");
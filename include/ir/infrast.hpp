@@ -50,6 +50,9 @@ protected:
 
   size_t mIdx = 0;
 
+  // changed since the last IRCheck; a new block starts out changed
+  bool mChanged = true;
+
 public:
   BasicBlock(const_str_ref name="", Function* parent=nullptr)
     : Value(Type::TypeLabel(), vBASIC_BLOCK, name), mFunction(parent) {};
@@ -64,7 +67,18 @@ public:
   //* get Data Attributes
   auto function() const { return mFunction; }
 
-  void set_parent(Function* parent) { mFunction = parent; }
+  void set_parent(Function* parent) {
+    mFunction = parent;
+    markChanged();
+  }
+
+  //* change tracking for IRCheck
+  auto changed() const { return mChanged; }
+  // mark this block and its function for re-verification
+  void markChanged();
+  void clearChanged() { mChanged = false; }
+  // mark the blocks of all instructions using def, e.g. before def goes away
+  static void markUsersChanged(Value* def);
 
   auto& insts() { return mInsts; }
 
@@ -100,14 +114,19 @@ public:  // for CFG
   static void block_link(ir::BasicBlock* pre, ir::BasicBlock* next) {
     pre->next_blocks().emplace_back(next);
     next->pre_blocks().emplace_back(pre);
+    pre->markChanged();
+    next->markChanged();
   }
   static void delete_block_link(ir::BasicBlock* pre, ir::BasicBlock* next) {
     pre->next_blocks().remove(next);
     next->pre_blocks().remove(pre);
+    pre->markChanged();
+    next->markChanged();
   }
   void clear_block_link() {
     mNextBlocks.clear();
     mPreBlocks.clear();
+    markChanged();
   }
   bool isTerminal() const;
 public:  // utils function
@@ -221,7 +221,8 @@ public:  // check function
     return v->valueId() >= vBINARY_BEGIN && v->valueId() <= vBINARY_END;
   }
   bool isCommutative() const {
-    return valueId() == vADD || valueId() == vFADD || valueId() == vMUL || valueId() == vFMUL;
+    return valueId() == vADD || valueId() == vFADD || valueId() == vMUL || valueId() == vFMUL ||
+           valueId() == vSMIN || valueId() == vSMAX;
   }
 
 public:  // get function
@@ -231,6 +232,8 @@ public:  // get function
 public:  // utils function
   void print(std::ostream& os) const override;
   Value* getConstantRepl(bool recursive = false) override;
+  /* kind of lhs and rhs, nullptr if the result is left to runtime (see ConstantReplace.cpp) */
+  static Value* foldConstant(ValueId kind, ConstantValue* lhs, ConstantValue* rhs);
   Instruction* copy(std::function<Value*(Value*)> getValue) const override;
   Instruction* clone() const override;
 };
@@ -441,6 +444,28 @@ public:  // utils function
   Instruction* copy(std::function<Value*(Value*)> getValue) const override;
 };
 
+/*
+ * @brief: PrefetchInst
+ * @details:
+ *    llvm.prefetch(<ptr>, i32 0, i32 3, i32 1): read, high locality, data cache
+ *    a hint, never faults; kept alive like a store (see LoopPrefetch)
+ */
+class PrefetchInst : public Instruction {
+public:
+  explicit PrefetchInst(Value* ptr, BasicBlock* parent = nullptr)
+    : Instruction(vPREFETCH, Type::void_type(), parent) {
+    addOperand(ptr);
+  }
+
+public:  // get function
+  auto ptr() const { return operand(0); }
+
+public:  // utils function
+  static bool classof(const Value* v) { return v->valueId() == vPREFETCH; }
+  void print(std::ostream& os) const override;
+  Instruction* copy(std::function<Value*(Value*)> getValue) const override;
+};
+
 /*
  * @brief GetElementPtr Instruction
  * @details:
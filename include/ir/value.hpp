@@ -202,6 +202,7 @@ enum ValueId {
   vLOAD,         ///< Memory load
   vSTORE,        ///< Memory store
   vGETELEMENTPTR,///< Get element pointer instruction
+  vPREFETCH,     ///< Read prefetch hint (llvm.prefetch)
 
   // Terminator instructions
   vRETURN,       ///< Return instruction
@@ -242,6 +243,12 @@ enum ValueId {
   vBITCAST,      ///< Bitwise cast
   vPTRTOINT,     ///< Pointer to integer
   vINTTOPTR,     ///< Integer to pointer
+
+  // Bit manipulation intrinsics (llvm.abs/ctpop/ctlz/cttz)
+  vABS,          ///< Integer absolute value
+  vCTPOP,        ///< Population count
+  vCTLZ,         ///< Count leading zeros
+  vCTTZ,         ///< Count trailing zeros
   vUNARY_END,    ///< End marker for unary instructions
 
   // Binary arithmetic instructions
@@ -258,6 +265,8 @@ enum ValueId {
   vUREM,         ///< Unsigned integer remainder
   vSREM,         ///< Signed integer remainder
   vFREM,         ///< Floating-point remainder
+  vSMIN,         ///< Signed integer minimum (llvm.smin)
+  vSMAX,         ///< Signed integer maximum (llvm.smax)
   vBINARY_END,   ///< End marker for binary instructions
 
   // Special instructions
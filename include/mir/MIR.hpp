@@ -179,6 +179,11 @@ enum MIRGenericInst : uint32_t {
   InstNeg,
   InstAbs,
 
+  // Bit counting
+  InstCPop,
+  InstClz,
+  InstCtz,
+
   // Float
   InstFAdd,
   InstFSub,
@@ -209,7 +214,7 @@ enum MIRGenericInst : uint32_t {
   InstLoadImm,
   InstLoadStackObjectAddr,
   InstCopyFromReg,
-  InstCopyToReg,  // 45
+  InstCopyToReg,  // 48
   InstLoadImmToReg,
   InstLoadRegFromStack,
   InstStoreRegToStack,
@@ -457,6 +462,7 @@ public:
   MIRFunction(const std::string& name, MIRModule* parent)
     : MIRRelocable(name), mModule(parent) {}
 
+  auto module() const { return mModule; }
   auto& blocks() { return mBlocks; }
   auto& args() { return mArguments; }
   auto& stackObjs() { return mStackObjects; }
@@ -490,6 +496,7 @@ public:
 
 public:
   auto is_float() const { return mIsFloat; }
+  auto size() const { return mSize; }
 
 public:
   void print(std::ostream& os, CodeGenContext& ctx) override;
@@ -510,6 +517,8 @@ public:
 public:  // check function
   auto is_readonly() const { return mIsReadonly; }
   auto is_float() const { return mIsFloat; }
+public:  // get function
+  const auto& data() const { return mData; }
 public:  // set function
   // return the index of this word
   size_t append_word(uint32_t word) {
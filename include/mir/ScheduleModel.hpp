@@ -23,6 +23,8 @@ struct MicroArchInfo {
   bool outOfOrder;
   // Memory system
   bool hardwarePrefetch;
+  bool hasPrefetchInst;  // Zicbop prefetch.r, else software prefetches are dummy loads
+  uint32_t memoryIssueWidth;
   uint32_t maxDataStreams;
   uint32_t maxStrideByBytes;
 };
@@ -348,6 +348,8 @@ class ParallelInfo : public FunctionACtx {
   // 你想并行的这里都有!
 private:
   std::unordered_map<BasicBlock*, bool> mLpIsParallel;
+  // 仅在运行时别名/单调性检查通过时可并行 (LoopVersioning)
+  std::unordered_map<BasicBlock*, bool> mLpNeedsVersioning;
   std::unordered_map<BasicBlock*, std::set<PhiInst*>> mLpPhis;
   std::unordered_map<PhiInst*, bool> mIsPhiAdd;
   std::unordered_map<PhiInst*, bool> mIsPhiSub;
@@ -366,9 +368,15 @@ public:
     }
     assert(false and "input an unexistend loop in ");
   }
+  void setNeedsVersioning(BasicBlock* header, bool b) { mLpNeedsVersioning[header] = b; }
+  bool getNeedsVersioning(BasicBlock* header) {
+    auto iter = mLpNeedsVersioning.find(header);
+    return iter != mLpNeedsVersioning.end() and iter->second;
+  }
   std::set<PhiInst*>& resPhi(BasicBlock* bb) { return mLpPhis[bb]; }
   void clearAll() {
     mLpIsParallel.clear();
+    mLpNeedsVersioning.clear();
     mLpPhis.clear();
   }
   void refresh() {}
@@ -22,6 +22,8 @@ struct DependenceAnalysisContext final {
   bool isSimplyLoopInvariant(Loop* lp, Value* val);
   bool isIDVPLUSMINUSFORMULA(IndVar* idv, Value* val, Loop* lp);
   int isTwoGepIdxPossiblySame(GepIdx* gepidx1, GepIdx* gepidx2, Loop* lp, IndVar* idv);
+  GetElementPtrInst* getIndirectIdxAddr(Value* val, Loop* lp, IndVar* idv);
+  GetElementPtrInst* isTwoGepIdxSameIndirect(GepIdx* gepidx1, GepIdx* gepidx2, Loop* lp, IndVar* idv);
   int isTwoIdxPossiblySame(Value* val1,
                            Value* val2,
                            IdxType type1,
@@ -54,6 +54,11 @@ private:
   std::unordered_map<GetElementPtrInst*, std::set<Instruction*>> subAddrToInst;  // 子地址到存取语句
   std::set<Instruction*> memInsts;  // 在当前这个循环中进行了存取的语句
 
+  // for runtime checks (LoopVersioning): parallel if all of them pass at run time
+  bool isParallelWithChecks;
+  std::set<std::pair<Value*, Value*>> aliasChecks;  // 基址对, 访问范围不能重叠
+  std::set<GetElementPtrInst*> monotonicChecks;     // b[i] 作为下标, b 在循环区间内须严格递增
+
 public:
   // utils
   // 直接根据循环相关信息对当前info进行构建
@@ -69,6 +74,9 @@ public:
     baseAddrIsCrossIterDep.clear();
     subAddrIsRead.clear();
     subAddrIsWrite.clear();
+    isParallelWithChecks = false;
+    aliasChecks.clear();
+    monotonicChecks.clear();
   }
   void getInfoFromSubLoop(Loop* subLoop, LoopDependenceInfo* subLoopDepInfo);
   void setTp(TopAnalysisInfoManager* topmana) { tp = topmana; }
@@ -85,6 +93,9 @@ public:
     return baseAddrToSubAddrs[baseaddr];
   }
   GepIdx* getGepIdx(GetElementPtrInst* subaddr) { return subAddrToGepIdx[subaddr]; }
+  bool getIsParallelWithChecks() { return isParallelWithChecks; }
+  auto& getAliasChecks() { return aliasChecks; }
+  auto& getMonotonicChecks() { return monotonicChecks; }
   std::set<Instruction*> getSubAddrInsts(GetElementPtrInst* gep) { return subAddrToInst[gep]; }
 
   // print for dbg
@@ -94,6 +105,9 @@ public:
   void setIsBaseAddrPossiblySame(bool b) { isBaseAddrPossiblySame = b; }
   void setIsParallel(bool b) { isParallelConcerningArray = b; }
   void setBaseAddrIsCrossIterDep(Value* bd, bool b) { baseAddrIsCrossIterDep[bd] = b; }
+  void setIsParallelWithChecks(bool b) { isParallelWithChecks = b; }
+  void addAliasCheck(Value* bd1, Value* bd2) { aliasChecks.emplace(bd1, bd2); }
+  void addMonotonicCheck(GetElementPtrInst* idxAddr) { monotonicChecks.insert(idxAddr); }
 
 private:
   void addPtr(Value* val, Instruction* inst);  // 用于添加一个指针进入
@@ -2,6 +2,20 @@
 #include "pass/pass.hpp"
 
 namespace pass {
+/**
+ * @brief Incremental IR verifier
+ *
+ * Only functions marked changed since the last check are verified (see
+ * ir::Function::changed): the IR mutation APIs mark the blocks they touch,
+ * and removing a def, function or global marks the blocks of its users.
+ * CFG and phi-incoming checks span the whole changed function, the
+ * per-instruction checks only its changed blocks. The amount of checking
+ * follows Config::verifyLevel:
+ * - Structural: CFG edges vs. terminators, parent links, phi placement,
+ *   single exit; linear in the size of the changed functions.
+ * - Thorough: additionally def-use chain consistency, phi incomings,
+ *   operand sanity and alloca placement.
+ */
 class IRCheck : public ModulePass {
 public:
   std::string name() const override { return "IR Check"; }
@@ -9,14 +23,14 @@ public:
 
 private:
   bool runDefUseTest(ir::Function* func);
-  bool runPhiTest(ir::Function* func);
+  bool runPhiTest(ir::Function* func, bool thorough);
   bool runCFGTest(ir::Function* func);
   bool checkDefUse(ir::Value* val);
   bool checkPhi(ir::PhiInst* phi);
   bool checkFuncInfo(ir::Function* func);
   bool checkAllocaOnlyInEntry(ir::Function* func);
   bool checkOnlyOneExit(ir::Function* func);
-  bool checkParentRelationship(ir::Function* func);
+  bool checkParentRelationship(ir::Function* func, bool thorough);
   bool checkOperands(ir::Function* func);
 };
 }  // namespace pass
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+namespace pass {
+/*
+ * Float rewrites allowed by -ffast-math, run after the last gvn/licm (config.cpp):
+ *
+ *   x / c                          -> x * (1 / c), c a non zero constant
+ *   x / d, d invariant in loop L   -> x * r, r = 1 / d once in the preheader of L
+ *   t = a * b; ... z + t (other block or t used twice)
+ *                                  -> z + a * b next to the add, fused by isel (fmadd.s)
+ *   z - a * b                      -> -(a * b) + z (fnmsub.s)
+ *
+ * Without -ffast-math the pass does nothing.
+ */
+class FastMath : public FunctionPass {
+public:
+  void run(ir::Function* func, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "FastMath"; }
+};
+}  // namespace pass
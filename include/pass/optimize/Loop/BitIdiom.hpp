@@ -0,0 +1,35 @@
+#pragma once
+#include <set>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Bit manipulation idiom recognition, lowered to Zbb (cpop/clz/ctz/min/max):
+ *
+ *   while (x > K) { c += x % 2; x /= 2; }   c = c0 + ctpop(smax(x0, K)) - K
+ *   while (x > K) { c += s; x /= 2; }       c = c0 + s * (32 - K - ctlz(smax(x0, K)))
+ *   while (x % 2 == 0) { c += s; x /= 2; }  c = c0 + s * cttz(x0)
+ *
+ * with K = 0 (bit length) or K = 1 (floor log2), x = smin(x0, K) after the first two.
+ * `c += x % 2` may also be written `if (x % 2 == 1) c = c + s`. The results are computed
+ * in the preheader and the loop, left without users, is removed by adce.
+ *
+ * The trailing-zero loop never ends for x0 == 0 (0 / 2 == 0); it becomes cttz(0) = 32 and
+ * the program goes on with c = c0 + 32 * s instead of hanging.
+ *
+ * A phi selecting between the operands of the compare that controls it becomes
+ * smin/smax, `x < 0 ? -x : x` becomes abs.
+ */
+class BitIdiom : public FunctionPass {
+public:
+  void run(Function* func, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "BitIdiom"; }
+};
+
+}  // namespace pass
@@ -0,0 +1,30 @@
+#pragma once
+#include <set>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Loop idiom recognition: a counted loop (i from beg to end by 1, i < end) whose only
+ * memory access is one contiguous word store per iteration becomes one runtime call
+ * in the preheader:
+ *
+ *   for (i) p[i] = c;      -> sysycMemfill(&p[beg], c, (end - beg) * 4)
+ *   for (i) p[i] = q[i];   -> sysycMemcpy(&p[beg], &q[beg], (end - beg) * 4)
+ *
+ * Loops are visited innermost first, so the call left by an inner loop that covers a
+ * whole row is folded again by the outer loop (row-major a[i][j] = 0 -> one call).
+ * The emptied loop is left to adce.
+ */
+class LoopIdiom : public FunctionPass {
+public:
+  void run(Function* func, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "LoopIdiom"; }
+};
+
+}  // namespace pass
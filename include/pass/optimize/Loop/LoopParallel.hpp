@@ -18,6 +18,7 @@ public:
 private:
   static bool isConstant(Value* val);
   bool runImpl(Function* func, TopAnalysisInfoManager* tp);
+  bool fuseRegions(Function* func, TopAnalysisInfoManager* tp);
 };
 
 }  // namespace pass
\ No newline at end of file
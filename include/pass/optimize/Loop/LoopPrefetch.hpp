@@ -0,0 +1,30 @@
+#pragma once
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Software prefetch for -fprefetch-loops, run last before reg2mem (config.cpp).
+ *
+ * The read streams of an innermost counted loop (i < end, constant step > 0) are the
+ * subaddresses of the dependence analysis whose load runs every iteration and advances
+ * by a constant stride. The hardware prefetcher of the target (MicroArchInfo) tracks
+ * the maxDataStreams smallest strides up to maxStrideByBytes; a read stream it misses
+ * and that changes cache line every iteration gets
+ *
+ *   for (i) ... a[i][j] ...   ->   for (i) { prefetch(&a[ahead][j]); ... a[i][j] ... }
+ *   ahead = smin(i + d * step, end - step)
+ *
+ * d covers the miss latency with the estimated cycles of one iteration (UnrollCostModel).
+ * The clamp keeps the address in the range the loop loads anyway, so on a core without
+ * prefetch instructions the hint lowers to a load into x0 that cannot fault.
+ */
+class LoopPrefetch : public FunctionPass {
+public:
+  void run(Function* func, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "LoopPrefetch"; }
+};
+
+}  // namespace pass
@@ -0,0 +1,36 @@
+#pragma once
+#include <set>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Final value replacement of loop recurrences: in a pure counted loop (i from beg to
+ * end by 1, i < end, no subloop) whose only results are header phis, every result
+ * x is computed in closed form and the loop is left dead:
+ *
+ *   x = x + P(i)          P of degree <= 3, x0 + sum of P over [beg, end)
+ *   x = (x + P(i)) % m    P with non-negative coefficients, sums mod m in i64
+ *   x = x * c             x0 * c^n by square-and-multiply
+ *   x = (x * c) % m       in i64, every product reduced mod m
+ *
+ * A modular recurrence only equals the modular sum while no x + P(i) overflows,
+ * which is checked at runtime when end is not a constant:
+ *
+ * preheader -> checks (beg < end, ...) -> closed form -> exit
+ *                   \---> fallback -> header -> ... -> exit
+ *
+ * The constant checks are folded by sccp, the dead loop is removed by adce/simplifycfg.
+ */
+class LoopRecurrence : public FunctionPass {
+public:
+  void run(Function* func, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "LoopRecurrence"; }
+};
+
+}  // namespace pass
@@ -0,0 +1,23 @@
+#pragma once
+#include <set>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Loop versioning for LoopParallel: the loop is guarded by the runtime checks
+ * of its LoopDependenceInfo (index arrays strictly increasing over [beg, end),
+ * accessed ranges of possibly aliasing base addresses disjoint). The original
+ * loop runs if they pass, a serial clone otherwise.
+ *
+ * preheader -> checks -> header
+ *                  \---> fallback -> clone of the loop -> exits
+ */
+bool versionLoop(Function* func, Loop* loop, IndVar* indVar, TopAnalysisInfoManager* tp);
+
+}  // namespace pass
@@ -18,10 +18,17 @@ struct ParallelBodyInfo final {
   Value* beg;
   Value* end;
 
+  /*
+   * captures: value -> byte offset in the payload, passed by pointer; word 0 of the
+   * payload is reserved for chunkAlignment
+   */
   std::vector<std::pair<Value*, size_t>> payload;
-  GlobalVariable* payloadStorage;
+  Type* payloadType;
+  Value* payloadStorage;  // alloca in the caller
   Value* givOffset;
   std::vector<Value*> payloadStoreInsts;
+  /* iterations per cache line of the stores indexed by the indvar, read by the runtime */
+  uint32_t chunkAlignment;
 };
 
 class ParallelBodyExtract : public FunctionPass {
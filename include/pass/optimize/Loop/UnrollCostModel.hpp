@@ -0,0 +1,52 @@
+#pragma once
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+
+namespace pass {
+/* per-iteration shape of a loop body, see UnrollCostModel::analyze */
+struct LoopBodyStats final {
+  uint32_t insts = 0;
+  bool hasCall = false;
+  /* live values: defined outside and used inside / header phis / peak of body-local ones */
+  uint32_t intInvariants = 0, fpInvariants = 0;
+  uint32_t intCarried = 0, fpCarried = 0;
+  uint32_t intPeak = 0, fpPeak = 0;
+  /* cycles: longest dependence chain of one iteration / of a loop-carried recurrence */
+  uint32_t criticalPath = 0;
+  uint32_t recurrence = 0;
+};
+
+/*
+ * Unroll (and unroll-and-jam) factor selection for LoopUnroll:
+ * - frequency: profiled trips (-fprofile-use) or the static trip product of the
+ *   loop nest (10 per unknown level); cold loops are not unrolled
+ * - latency: enough copies to overlap the longest dependence chain of the body
+ *   at dual issue, unless a loop-carried recurrence bounds the loop anyway
+ *   (sifive-u74 latencies, target/riscv/RISCVLatency.hpp)
+ * - register pressure: invariants + carried values + factor x body-local peak
+ *   must fit the integer and fp register budgets
+ * - size: per-loop body limit and a per-function growth budget that every
+ *   accepted factor is charged against
+ */
+class UnrollCostModel final {
+  uint32_t mBudget = 0;
+
+public:
+  explicit UnrollCostModel(Function* func);
+
+  static LoopBodyStats analyze(Loop* loop);
+  static uint32_t latency(Instruction* inst);
+  /* estimated header executions per run; tripCount <= 0: unknown */
+  static double frequency(Loop* loop, int tripCount);
+  static bool isCold(Loop* loop, int tripCount);
+
+  /* factor for an innermost loop, 1: keep it; charges the growth budget */
+  uint32_t unrollFactor(Loop* loop, int tripCount);
+  /* factor jamming outer copies around inner, dividing tripCount, 1: keep it */
+  uint32_t jamFactor(Loop* outer, Loop* inner, int tripCount);
+
+  auto budget() const { return mBudget; }
+};
+}  // namespace pass
@@ -0,0 +1,36 @@
+#pragma once
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+using namespace ir;
+
+namespace pass {
+/*
+ * Whole-program layout of global arrays (pipeline.loop, after licm).
+ *
+ * An array qualifies when every use is visible: full gep chains (one index per
+ * dimension) feeding loads and stores only, indices affine in the loop of the access
+ * (constants, induction variables, values fixed in that loop; +, -, * constant).
+ * Passing the array or a row to a call disqualifies it. Rewrites, all gep chains
+ * rebuilt at the access, initializers permuted:
+ *
+ *   transpose   [N x [M x T]] -> [M x [N x T]]   a[i][j] -> a'[j][i]
+ *               inner loops walk the rows (first index) more than the columns, and
+ *               the last index is not a constant field selector at every access
+ *   pad         [.. x [M x T]] -> [.. x [M + 16 x T]]
+ *               M * 4 a multiple of layout.pad-stride and an inner loop still walks
+ *               a leading index: rows no longer map to the same cache sets
+ *   interleave  a[N], b[N] -> ab[N x [2 x T]]   a[i] -> ab[i][0], b[i] -> ab[i][1]
+ *               every access of one comes with the same index on the other in the
+ *               same block, one stream instead of two
+ *
+ * None of the rewrites applies to its own result again, so running the pass twice
+ * changes nothing the first run did not.
+ *
+ * Every global array of at least a cache line is aligned to the line.
+ */
+class GlobalArrayLayout : public ModulePass {
+public:
+  void run(ir::Module* module, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "GlobalArrayLayout"; }
+};
+}  // namespace pass
@@ -0,0 +1,26 @@
+#pragma once
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+using namespace ir;
+
+namespace pass {
+/*
+ * -finstrument-loops: hook calls at function entry/return and loop
+ * preheaders/exits, an inline trip counter in every loop header, the runtime
+ * (runtime/LoopProfile.cpp) writes the per-loop report at exit.
+ * -fprofile-use={file}: attach the measured records to the loop headers
+ * (utils::LoopProfileData::find), read by UnrollCostModel and LoopParallel.
+ * Both modes must run at the same point of the pipeline: loops are matched by
+ * (function name, header position in the block list).
+ */
+class LoopProfile : public ModulePass {
+  static std::vector<Loop*> profileOrder(Function* func, LoopInfo* lpctx);
+  static uint32_t loopDepth(Loop* loop);
+  static void annotate(Module* module, TopAnalysisInfoManager* tp);
+  static void instrument(Module* module, TopAnalysisInfoManager* tp);
+
+public:
+  void run(ir::Module* module, TopAnalysisInfoManager* tp) override;
+  std::string name() const override { return "LoopProfile"; }
+};
+}  // namespace pass
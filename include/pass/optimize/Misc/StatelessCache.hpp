@@ -5,7 +5,12 @@ using namespace ir;
 
 namespace pass {
 class StatelessCache : public FunctionPass {
-  static Function* getLookupFunction(Module* module, ArrayType* entryType, ArrayType* lutType);
+  /* hash buckets of the lookup table */
+  static constexpr int32_t lutSlots = 1021;
+  static Function* getLookupFunction(Module* module,
+                                     ArrayType* entryType,
+                                     ArrayType* lutType,
+                                     size_t keys);
   static bool has2MoreRecursiveCalls(Function* func);
   bool runImpl(ir::Function* func, TopAnalysisInfoManager* tp);
 
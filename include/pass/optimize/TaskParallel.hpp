@@ -0,0 +1,49 @@
+#pragma once
+#include <set>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "ir/ir.hpp"
+#include "pass/pass.hpp"
+
+using namespace ir;
+namespace pass {
+
+/*
+ * Task parallelism of recursive divide-and-conquer functions: two sibling self calls
+ * of f that are proven independent (SideEffectInfo: f writes no global and has no
+ * other side effect, pointer arguments written by one call are based on distinct
+ * local arrays the other call never touches) run as two tasks of the work-stealing
+ * runtime while the recursion depth is below parallel.task-depth:
+ *
+ *   r1 = f(a1); r2 = f(a2)
+ * ->
+ *   if (depth < cutoff) parallelInvoke2(f_task, {depth + 1, a1, r1}, f_task, {depth + 1, a2, r2})
+ *   else { r1 = f(a1, depth + 1); r2 = f(a2, depth + 1); }
+ *
+ * f takes the recursion depth as a trailing i32 argument, callers outside f pass 0.
+ */
+class TaskParallel : public ModulePass {
+  struct CallPair final {
+    CallInst* first;
+    CallInst* second;
+  };
+  static bool isCandidate(Function* func, SideEffectInfo* sideEffect);
+  static bool isIndependentPair(Function* func,
+                                CallInst* first,
+                                CallInst* second,
+                                SideEffectInfo* sideEffect);
+  static std::vector<CallPair> findPairs(Function* func, SideEffectInfo* sideEffect);
+  static Function* buildTask(Function* func, ArrayType* payloadType);
+  static void spawnPair(Function* func,
+                        const CallPair& pair,
+                        Function* task,
+                        ArrayType* payloadType,
+                        uint32_t cutoff);
+
+public:
+  std::string name() const override { return "TaskParallel"; }
+  void run(Module* module, TopAnalysisInfoManager* tp) override;
+};
+
+}  // namespace pass
@@ -6,12 +6,14 @@
 #include "pass/analysis/ControlFlowGraph.hpp"
 #include "ir/ir.hpp"
 #include "pass/pass.hpp"
+#include "pass/optimize/Loop/UnrollCostModel.hpp"
 
 using namespace ir;
 namespace pass {
 struct LoopUnrollContext final {
   LoopInfo* lpctx;
   IndVarInfo* ivctx;
+  UnrollCostModel* costmodel = nullptr;
   static std::unordered_map<Value*, Value*> copymap;
   std::vector<Instruction*> headuseouts;
   BasicBlock* nowlatchnext;
@@ -19,12 +21,13 @@ struct LoopUnrollContext final {
   void insertremainderloop(Loop* loop, Function* func);
   void copyloop(std::vector<BasicBlock*> bbs, BasicBlock* begin, Loop* L, Function* func);
   void copyloopremainder(std::vector<BasicBlock*> bbs, BasicBlock* begin, Loop* L, Function* func);
-  int calunrolltime(Loop* loop, int times);
-  void doconstunroll(Loop* loop, IndVar* iv, int times);
-  void dodynamicunroll(Loop* loop, IndVar* iv);
+  int consttimes(IndVar* iv);
+  void doconstunroll(Loop* loop, IndVar* iv, int times, int unrolltimes);
+  void dodynamicunroll(Loop* loop, IndVar* iv, int unrolltimes);
   void dynamicunroll(Loop* loop, IndVar* iv);
   void constunroll(Loop* loop, IndVar* iv);
   void dofullunroll(Loop* loop, IndVar* iv, int times);
+  bool unrollandjam(Loop* loop, ParallelInfo* parallelctx);
   bool isconstant(IndVar* iv);
   void getdefinuseout(Loop* L);
   void replaceuseout(Instruction* inst, Instruction* copyinst, Loop* L);
@@ -2,12 +2,19 @@
 #include "ir/ir.hpp"
 #include "pass/pass.hpp"
 namespace pass {
+/*
+ * Reassociation of float fadd/fmul trees, only under -ffast-math (see FastMath.hpp).
+ * A tree is a root and its single use operands of the same opcode in the same block;
+ * it is rebuilt by pairing the two operands that are ready first, so that
+ *
+ *   s = (((s + a0) + a1) + a2) + a3    ->  s = s + ((a0 + a1) + (a2 + a3))
+ *
+ * A phi leaf is the accumulator of a reduction and is paired last: an unrolled
+ * reduction then carries one fadd per iteration instead of one per copy.
+ */
 class Reassociate : public FunctionPass {
 public:
   void run(ir::Function* func, TopAnalysisInfoManager* tp) override;
-
-private:
-  void DFSPostOrderBB(ir::BasicBlock* bb);
-  void buildRankMap();
+  std::string name() const override { return "Reassociate"; }
 };
 }  // namespace pass
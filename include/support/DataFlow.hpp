@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "support/Graph.hpp"
+
+/*
+ * Generic dataflow engine over any graph of utils::Graph form: the blocks of a MIRFunction
+ * (BlockGraph, liveness in LiveInterval.cpp) or the call graph (SideEffectAnalysis.cpp).
+ *
+ * A problem describes the lattice and the transfer of one node:
+ *
+ *   struct Problem {
+ *     using Value = ...;                                   // needs operator==
+ *     static constexpr DataFlowDirection direction = ...;
+ *     Value top() const;                                   // identity of meet
+ *     Value boundary() const;                              // into entry / out of exits
+ *     void meet(Value& into, const Value& from) const;
+ *     bool transfer(NodeIndex node, const Value& in, Value& out) const;  // true: changed
+ *   };
+ *
+ * Forward: in = meet(out of preds), out = transfer(in). Backward: out = meet(in of
+ * succs), in = transfer(out). The worklist visits nodes in reverse post order (post
+ * order backward), so acyclic regions settle in one pass. Dense problems use BitVector
+ * (GenKillProblem), sparse ones any value type, e.g. std::set.
+ */
+namespace utils {
+class BitVector final {
+  std::vector<uint64_t> mWords;
+  size_t mSize = 0;
+
+  void clearTail() {
+    if (mSize % 64) mWords.back() &= (uint64_t{1} << (mSize % 64)) - 1;
+  }
+
+public:
+  BitVector() = default;
+  explicit BitVector(size_t size, bool value = false)
+    : mWords((size + 63) / 64, value ? ~uint64_t{0} : 0), mSize(size) {
+    clearTail();
+  }
+
+  size_t size() const { return mSize; }
+  bool test(size_t idx) const { return mWords[idx / 64] >> (idx % 64) & 1; }
+  void set(size_t idx) { mWords[idx / 64] |= uint64_t{1} << (idx % 64); }
+  void reset(size_t idx) { mWords[idx / 64] &= ~(uint64_t{1} << (idx % 64)); }
+  bool any() const {
+    return std::any_of(mWords.begin(), mWords.end(), [](uint64_t word) { return word; });
+  }
+  size_t count() const {
+    size_t cnt = 0;
+    for (auto word : mWords)
+      cnt += __builtin_popcountll(word);
+    return cnt;
+  }
+
+  BitVector& operator|=(const BitVector& rhs) {
+    for (size_t idx = 0; idx < mWords.size(); idx++)
+      mWords[idx] |= rhs.mWords[idx];
+    return *this;
+  }
+  BitVector& operator&=(const BitVector& rhs) {
+    for (size_t idx = 0; idx < mWords.size(); idx++)
+      mWords[idx] &= rhs.mWords[idx];
+    return *this;
+  }
+  BitVector& subtract(const BitVector& rhs) {
+    for (size_t idx = 0; idx < mWords.size(); idx++)
+      mWords[idx] &= ~rhs.mWords[idx];
+    return *this;
+  }
+  /* this = gen | (in - kill), true if it changed */
+  bool assignTransfer(const BitVector& in, const BitVector& gen, const BitVector& kill) {
+    bool changed = false;
+    for (size_t idx = 0; idx < mWords.size(); idx++) {
+      const auto word = gen.mWords[idx] | (in.mWords[idx] & ~kill.mWords[idx]);
+      changed |= word != mWords[idx];
+      mWords[idx] = word;
+    }
+    return changed;
+  }
+  bool operator==(const BitVector& rhs) const { return mWords == rhs.mWords; }
+  bool operator!=(const BitVector& rhs) const { return mWords != rhs.mWords; }
+
+  /* set bits in ascending order */
+  template <typename Func>
+  void forEach(Func&& func) const {
+    for (size_t idx = 0; idx < mWords.size(); idx++) {
+      for (auto word = mWords[idx]; word; word &= word - 1)
+        func(idx * 64 + __builtin_ctzll(word));
+    }
+  }
+};
+
+enum class DataFlowDirection { Forward, Backward };
+enum class DataFlowMeet { Union, Intersection };
+
+/* nodes reachable from entry in reverse post order, then the unreachable ones */
+std::vector<NodeIndex> reversePostOrder(const Graph& succs, NodeIndex entry);
+
+template <typename Value>
+struct DataFlowResult final {
+  std::vector<Value> in, out;
+};
+
+template <typename Problem>
+DataFlowResult<typename Problem::Value> solveDataFlow(const Graph& succs,
+                                                      NodeIndex entry,
+                                                      const Problem& problem) {
+  using Value = typename Problem::Value;
+  constexpr bool forward = Problem::direction == DataFlowDirection::Forward;
+  const auto size = static_cast<NodeIndex>(succs.size());
+  DataFlowResult<Value> result{std::vector<Value>(size, problem.top()),
+                               std::vector<Value>(size, problem.top())};
+  if (size == 0) return result;
+
+  Graph preds(size);
+  for (NodeIndex node = 0; node < size; node++) {
+    for (auto next : succs[node])
+      preds[next].push_back(node);
+  }
+  /* values flow from sources into a node and on to its sinks */
+  const auto& sources = forward ? preds : succs;
+  const auto& sinks = forward ? succs : preds;
+  auto& merged = forward ? result.in : result.out;
+  auto& transferred = forward ? result.out : result.in;
+
+  auto order = reversePostOrder(succs, entry);
+  if (not forward) std::reverse(order.begin(), order.end());
+  std::vector<NodeIndex> rank(size);
+  for (NodeIndex idx = 0; idx < size; idx++)
+    rank[order[idx]] = idx;
+
+  const auto top = problem.top(), boundary = problem.boundary();
+  std::priority_queue<NodeIndex, std::vector<NodeIndex>, std::greater<>> worklist;
+  std::vector<bool> queued(size, true);
+  for (NodeIndex idx = 0; idx < size; idx++)
+    worklist.push(idx);
+  while (not worklist.empty()) {
+    const auto node = order[worklist.top()];
+    worklist.pop();
+    queued[node] = false;
+
+    const bool isBoundary = forward ? node == entry : sources[node].empty();
+    merged[node] = isBoundary ? boundary : top;
+    for (auto source : sources[node])
+      problem.meet(merged[node], transferred[source]);
+    if (not problem.transfer(node, merged[node], transferred[node])) continue;
+    for (auto sink : sinks[node]) {
+      if (queued[sink]) continue;
+      queued[sink] = true;
+      worklist.push(rank[sink]);
+    }
+  }
+  return result;
+}
+
+/* dense bit vector problem: out = gen | (in - kill) per node, swapped backward */
+template <DataFlowDirection Direction, DataFlowMeet Meet = DataFlowMeet::Union>
+struct GenKillProblem final {
+  using Value = BitVector;
+  static constexpr DataFlowDirection direction = Direction;
+
+  std::vector<BitVector> gen, kill;
+  BitVector boundaryValue;
+
+  GenKillProblem(size_t nodes, size_t universe)
+    : gen(nodes, BitVector(universe)),
+      kill(nodes, BitVector(universe)),
+      boundaryValue(universe) {}
+
+  Value top() const { return BitVector(boundaryValue.size(), Meet == DataFlowMeet::Intersection); }
+  Value boundary() const { return boundaryValue; }
+  void meet(Value& into, const Value& from) const {
+    if constexpr (Meet == DataFlowMeet::Union) {
+      into |= from;
+    } else {
+      into &= from;
+    }
+  }
+  bool transfer(NodeIndex node, const Value& in, Value& out) const {
+    return out.assignTransfer(in, gen[node], kill[node]);
+  }
+};
+
+/* dense numbering of the blocks of a function, entry first */
+template <typename Block>
+struct BlockGraph final {
+  std::vector<Block*> blocks;
+  std::unordered_map<Block*, NodeIndex> index;
+  Graph succs;
+
+  /* succsOf(block) -> a range of Block* */
+  template <typename SuccsOf>
+  BlockGraph(std::vector<Block*> blocks, SuccsOf&& succsOf)
+    : blocks(std::move(blocks)), succs(this->blocks.size()) {
+    for (auto block : this->blocks)
+      index.emplace(block, static_cast<NodeIndex>(index.size()));
+    for (NodeIndex node = 0; node < this->blocks.size(); node++) {
+      for (auto next : succsOf(this->blocks[node]))
+        succs[node].push_back(index.at(next));
+    }
+  }
+};
+}  // namespace utils
@@ -1,7 +1,89 @@
 #pragma once
 #include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
 
 namespace utils {
-constexpr uint32_t ConstantHoistNum = 8;
-constexpr double PrimaryPathThreshold = 0.4;
-}
\ No newline at end of file
+
+/*
+ * Typed registry of tuning knobs: pass thresholds, pipelines, ...
+ * A knob is a global Parameter<T> registered under a dotted name during static
+ * initialization, next to the code that reads it. `-X name=value` and
+ * `-C {file}` override the defaults before any pass runs; `-X list` prints
+ * every knob in config-file syntax (used by bench/autotune.py).
+ */
+class ParameterBase {
+  std::string_view mName;
+  std::string_view mDesc;
+
+public:
+  ParameterBase(std::string_view name, std::string_view desc);
+  virtual ~ParameterBase() = default;
+  ParameterBase(const ParameterBase&) = delete;
+  ParameterBase& operator=(const ParameterBase&) = delete;
+
+  auto name() const { return mName; }
+  auto desc() const { return mDesc; }
+  virtual std::string_view typeName() const = 0;
+  /* returns false and keeps the value if text is not a valid value */
+  virtual bool parse(std::string_view text) = 0;
+  virtual std::string value() const = 0;
+  virtual std::string defaultValue() const = 0;
+};
+
+/* value conversions of the supported parameter types */
+bool parseValue(std::string_view text, bool& val);
+bool parseValue(std::string_view text, uint32_t& val);
+bool parseValue(std::string_view text, double& val);
+bool parseValue(std::string_view text, std::string& val);
+std::string formatValue(bool val);
+std::string formatValue(uint32_t val);
+std::string formatValue(double val);
+std::string formatValue(const std::string& val);
+std::string_view typeName(bool);
+std::string_view typeName(uint32_t);
+std::string_view typeName(double);
+std::string_view typeName(const std::string&);
+
+/* T: bool, uint32_t, double or std::string */
+template <typename T>
+class Parameter final : public ParameterBase {
+  T mValue;
+  const T mDefault;
+
+public:
+  Parameter(std::string_view name, T value, std::string_view desc)
+    : ParameterBase(name, desc), mValue(value), mDefault(std::move(value)) {}
+
+  operator const T&() const { return mValue; }
+  const T& get() const { return mValue; }
+  void set(T value) { mValue = std::move(value); }
+
+  std::string_view typeName() const override { return utils::typeName(mValue); }
+  bool parse(std::string_view text) override { return parseValue(text, mValue); }
+  std::string value() const override { return formatValue(mValue); }
+  std::string defaultValue() const override { return formatValue(mDefault); }
+};
+
+class ParameterRegistry final {
+  std::map<std::string_view, ParameterBase*> mParams;
+
+public:
+  static ParameterRegistry& get();
+
+  void add(ParameterBase* param);
+  ParameterBase* find(std::string_view name) const;
+  /* "name=value" */
+  bool set(std::string_view assignment, std::string& error);
+  /* one "name = value" per line, '#' starts a comment */
+  bool load(const std::string& path, std::string& error);
+  /* current values in config-file syntax */
+  void dump(std::ostream& os) const;
+};
+
+extern Parameter<uint32_t> ConstantHoistNum;
+extern Parameter<double> PrimaryPathThreshold;
+extern Parameter<bool> VerifyDataFlow;
+}  // namespace utils
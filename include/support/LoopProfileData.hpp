@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace ir {
+class BasicBlock;
+}
+
+namespace utils {
+
+/*
+ * Measured data of a -finstrument-loops run (sysyc.prof, see
+ * runtime/LoopProfile.cpp), loaded with -fprofile-use={file}.
+ *
+ * Loops are keyed by (function, index), index being the position of the
+ * loop header in the function block list when the loopprofile pass ran; the
+ * pass then attaches every record to its header so that later passes can
+ * query by header block.
+ */
+struct LoopProfileRecord final {
+  uint32_t depth = 0;
+  uint64_t entries = 0;
+  uint64_t trips = 0;  // header executions
+  uint64_t cycles = 0;
+  uint64_t instret = 0;
+
+  double avgTrips() const { return entries ? static_cast<double>(trips) / entries : 0.0; }
+  double cyclesPerTrip() const { return trips ? static_cast<double>(cycles) / trips : 0.0; }
+};
+
+struct FunctionProfileRecord final {
+  uint64_t calls = 0;
+  uint64_t cycles = 0;
+  uint64_t instret = 0;
+};
+
+class LoopProfileData final {
+  std::map<std::pair<std::string, uint32_t>, LoopProfileRecord> mLoops;
+  std::unordered_map<std::string, FunctionProfileRecord> mFunctions;
+  std::unordered_map<const ir::BasicBlock*, const LoopProfileRecord*> mHeaders;
+  uint64_t mTotalCycles = 0;
+
+public:
+  static LoopProfileData& get();
+
+  /* returns false (and keeps the data empty) if the file is missing or malformed */
+  bool load(const std::string& path);
+  bool empty() const { return mFunctions.empty() && mLoops.empty(); }
+
+  const LoopProfileRecord* loop(const std::string& func, uint32_t index) const;
+  const FunctionProfileRecord* function(const std::string& func) const;
+  uint64_t totalCycles() const { return mTotalCycles; }
+
+  void attach(const ir::BasicBlock* header, const LoopProfileRecord* record) {
+    mHeaders[header] = record;
+  }
+  const LoopProfileRecord* find(const ir::BasicBlock* header) const {
+    const auto iter = mHeaders.find(header);
+    return iter == mHeaders.end() ? nullptr : iter->second;
+  }
+  /* share of the whole run spent in the loop, 0 without data */
+  double hotness(const LoopProfileRecord& record) const {
+    return mTotalCycles ? static_cast<double>(record.cycles) / mTotalCycles : 0.0;
+  }
+};
+
+}  // namespace utils
@@ -7,6 +7,7 @@
 #include <chrono>
 #include <memory>
 #include <cstdint>
+#include <ostream>
 using namespace std::string_view_literals;
 
 namespace utils {
@@ -41,21 +42,32 @@ public:
   Duration duration() const noexcept { return mTotalDuration; }
   uint32_t count() const noexcept { return mCount; }
   void printNested(uint32_t depth, double total) const;
+  void dumpNested(std::ostream& os, const std::string& prefix, bool& first) const;
 };
 
 class Profiler final {
   StageStorage mRootStage;
   std::deque<std::pair<TimePoint, StageStorage*>> mStageStack;
+  bool mFinished = false;
+
+  void finish();
 
 public:
   Profiler();
+  // stages are recorded in debug mode or when a stats file is requested
+  static bool enabled();
   // performance
   void pushStage(const std::string_view& name);
   void popStage();
   void printStatistics();
+  // machine-readable statistics: stage times, peak RSS and arena usage (JSON)
+  void dumpStatistics(std::ostream& os);
   // counter
 
   static Profiler& get();
 };
 
+/* peak resident set size of the current process, in KiB */
+size_t peakRSSKiB();
+
 }  // namespace utils
@@ -22,6 +22,11 @@ class Arena final {
 
 public:
   enum class Source { IR, MIR, Max };
+
+private:
+  Source mSource = Source::Max;
+
+public:
   Arena();
   explicit Arena(Source source);
   Arena(const Arena&) = delete;
@@ -33,6 +38,9 @@ public:
 
   static Arena* get(Source source);
   static void setArena(Source source, Arena* arena);
+
+  /* bytes handed out by all arenas of a source so far (for compile-time stats) */
+  static size_t totalAllocated(Source source);
 };
 
 template <typename T>
@@ -12,6 +12,8 @@ namespace sysy {
 
 enum OptLevel : uint32_t { O0 = 0, O1 = 1, O2 = 2, O3 = 3 };
 enum LogLevel : uint32_t { SILENT, INFO, DEBUG };
+/* IRCheck depth: Structural is cheap enough for release builds */
+enum VerifyLevel : uint32_t { Structural = 0, Thorough = 1 };
 
 class Config {
 protected:
@@ -21,6 +23,13 @@ protected:
 public:
   std::string infile;
   std::string outfile;
+  std::string statsFile;  // compile-time statistics (JSON), empty: disabled
+  std::string simInput;   // stdin of the cycle-approximate simulation, empty: disabled
+  std::string profileUse;  // loop profile of an instrumented run, empty: disabled
+
+  bool instrumentLoops = false;  // -finstrument-loops
+  bool fastMath = false;         // -ffast-math: float reassociation, reciprocals, contraction
+  bool prefetchLoops = false;    // -fprefetch-loops: software prefetch of strided loads
 
   std::vector<std::string> passes;
   bool genIR = false;
@@ -28,6 +37,11 @@ public:
 
   OptLevel optLevel = OptLevel::O0;
   LogLevel logLevel = LogLevel::SILENT;
+#ifdef NDEBUG
+  VerifyLevel verifyLevel = VerifyLevel::Structural;
+#else
+  VerifyLevel verifyLevel = VerifyLevel::Thorough;
+#endif
 
 public:
   Config() : mos(&std::cout), merros(&std::cerr) {}
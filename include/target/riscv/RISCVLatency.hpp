@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+/*
+ * Result latencies (cycles) of the sifive-u74 schedule classes in
+ * RISCVScheduleModel.hpp. Kept apart from the schedule classes so that
+ * IR-level cost models (loop unrolling) can use the same numbers without
+ * depending on the MIR.
+ */
+namespace mir::RISCV::latency {
+/* integer ALU executed in AG (operands ready) / in M2 */
+constexpr uint32_t IntAluEarly = 1;
+constexpr uint32_t IntAluLate = 3;
+constexpr uint32_t Load = 3;
+constexpr uint32_t IntMul = 3;
+constexpr uint32_t IntDiv = 68;
+/* 32-bit div/rem, typical operands */
+constexpr uint32_t IntDivW = 30;
+/* fmv, fsgnj, fcvt.s.w, fmin/fmax */
+constexpr uint32_t FPMove = 2;
+/* feq/flt/fle, fcvt.w.s */
+constexpr uint32_t FPCompare = 4;
+/* fadd/fsub/fmul/fmadd */
+constexpr uint32_t FPArith = 5;
+constexpr uint32_t FPDiv = 36;
+constexpr uint32_t FPLoad = 2;
+/* dual issue */
+constexpr uint32_t IssueWidth = 2;
+}  // namespace mir::RISCV::latency
@@ -3,6 +3,7 @@
 #include "mir/MIR.hpp"
 #include "mir/instinfo.hpp"
 #include "mir/ScheduleModel.hpp"
+#include "target/riscv/RISCVLatency.hpp"
 RISCV_NAMESPACE_BEGIN
 
 enum RISCVPipeline : uint32_t { RISCVIDivPipeline, RISCVFPDivPipeline };
@@ -93,7 +94,7 @@ public:
           state.setIssued(ValidPipeline);
         }
         // dst operand reg will be ready after next cycle
-        state.makeRegisterReady(inst, 0, 1);
+        state.makeRegisterReady(inst, 0, latency::IntAluEarly);
         return true;
       }
     }
@@ -106,7 +107,7 @@ public:
         state.setIssued(ValidPipeline);
       }
       // dst operand reg will be ready after 3 cycles
-      state.makeRegisterReady(inst, 0, 3);
+      state.makeRegisterReady(inst, 0, latency::IntAluLate);
       return true;
     }
 
@@ -177,7 +178,7 @@ public:
     }
     /* def operand reg will be ready after 3 cycles */
     if (instInfo.operand_flag(0) & OperandFlagDef) {
-      state.makeRegisterReady(inst, 0, 3);
+      state.makeRegisterReady(inst, 0, latency::Load);
     }
     state.setIssued(RISCVPipelineA);
     return true;
@@ -198,7 +199,7 @@ public:
     }
     /* def operand reg will be ready after 3 cycles */
     if (instInfo.operand_flag(0) & OperandFlagDef) {
-      state.makeRegisterReady(inst, 0, 3);
+      state.makeRegisterReady(inst, 0, latency::IntMul);
     }
     state.setIssued(RISCVPipelineB);
     return true;
@@ -220,8 +221,8 @@ public:
       }
     }
 
-    state.resetPipeline(RISCVIDivPipeline, 65);
-    state.makeRegisterReady(inst, 0, 68);
+    state.resetPipeline(RISCVIDivPipeline, latency::IntDiv - 3);
+    state.makeRegisterReady(inst, 0, latency::IntDiv);
     state.setIssued(RISCVPipelineB);
     return true;
   }
@@ -262,10 +263,10 @@ public:
     // const auto hint = inst.operand(5);
     // const auto latency = estimateDivRemLatency(logDividend, logDivisor,
     // hint);
-    const auto latency = 30;
+    const auto divLatency = latency::IntDivW;
 
-    state.resetPipeline(RISCVIDivPipeline, latency - 3);
-    state.makeRegisterReady(inst, 0, latency);
+    state.resetPipeline(RISCVIDivPipeline, divLatency - 3);
+    state.makeRegisterReady(inst, 0, divLatency);
     state.setIssued(RISCVPipelineB);
     return true;
   }
@@ -293,9 +294,9 @@ public:
 };
 
 using RISCVScheduleClassFPCycle1 = RISCVScheduleClassFP<1>;
-using RISCVScheduleClassFPCycle2 = RISCVScheduleClassFP<2>;
-using RISCVScheduleClassFPCycle4 = RISCVScheduleClassFP<4>;
-using RISCVScheduleClassFPCycle5 = RISCVScheduleClassFP<5>;
+using RISCVScheduleClassFPCycle2 = RISCVScheduleClassFP<latency::FPMove>;
+using RISCVScheduleClassFPCycle4 = RISCVScheduleClassFP<latency::FPCompare>;
+using RISCVScheduleClassFPCycle5 = RISCVScheduleClassFP<latency::FPArith>;
 
 class RISCVScheduleClassFPDiv final : public ScheduleClass {
 public:
@@ -312,8 +313,8 @@ public:
       }
     }
 
-    state.resetPipeline(RISCVFPDivPipeline, 33);
-    state.makeRegisterReady(inst, 0, 36);
+    state.resetPipeline(RISCVFPDivPipeline, latency::FPDiv - 3);
+    state.makeRegisterReady(inst, 0, latency::FPDiv);
     state.setIssued(RISCVPipelineB);
     return true;
   }
@@ -333,7 +334,7 @@ public:
 
     if (instInfo.operand_flag(0) & OperandFlagDef) {
       // 2 cycles to use for FLW
-      state.makeRegisterReady(inst, 0, 2);
+      state.makeRegisterReady(inst, 0, latency::FPLoad);
       auto la = state.queryRegisterLatency(inst, 0);
       // std::cerr << "FLoad laytency: " << la << std::endl;
     }
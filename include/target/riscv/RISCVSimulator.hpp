@@ -0,0 +1,168 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "mir/MIR.hpp"
+#include "mir/target.hpp"
+#include "mir/ScheduleModel.hpp"
+#include "target/riscv/RISCV.hpp"
+
+/*
+ * Cycle-approximate simulator of the generated code.
+ *
+ * Executes the final (post-legalization) RISC-V MIR of a whole program and
+ * drives the sifive-u74 schedule classes (RISCVScheduleModel.hpp) with the
+ * dynamic instruction stream:
+ *   - dual-issue, in-order pipeline: exactly the issue rules of the
+ *     ScheduleClass of each instruction, one ScheduleState for the whole run;
+ *   - conditional branches: 2-bit bimodal predictor, BTFN initial state;
+ *   - loads/stores: L1D + L2 set-associative LRU caches, a miss delays the
+ *     loaded register by the refill latency.
+ * The SysY runtime (getint/putarray/..., parallelFor, parallelForRegionN,
+ * parallelInvoke2, _memset, sysycMemfill/sysycMemcpy) is emulated natively with a fixed cost; parallel
+ * loops run on one hart; putf is not emulated (the frontend passes it no format string) and
+ * stops the run. The report gives cycles per function (self/inclusive) and per block.
+ */
+RISCV_NAMESPACE_BEGIN
+
+/* Set-associative LRU cache, tags only. */
+class SimCache final {
+  uint32_t mLineBits;
+  uint32_t mSets;
+  uint32_t mWays;
+  std::vector<uint64_t> mTags;   // sets * ways, 0: invalid
+  std::vector<uint64_t> mStamp;  // last access, for LRU
+  uint64_t mClock = 0;
+
+public:
+  SimCache(uint32_t sizeBytes, uint32_t ways, uint32_t lineBytes);
+  /* returns true on hit; a miss allocates the line */
+  bool access(uint64_t addr);
+};
+
+struct SimConfig final {
+  uint64_t stackSize = 64ULL << 20;
+  /* sifive-u74 core complex */
+  uint32_t mispredictPenalty = 4;
+  uint32_t l1dSize = 32 << 10, l1dWays = 8;
+  uint32_t l2Size = 2 << 20, l2Ways = 16;
+  uint32_t lineBytes = 64;
+  uint32_t l2Latency = 20;    // extra cycles: L1D miss, L2 hit
+  uint32_t memLatency = 120;  // extra cycles: L2 miss
+  /* emulated runtime calls */
+  uint32_t runtimeCallCycles = 30;
+  uint32_t ioElementCycles = 20;
+  uint32_t profileHookCycles = 12;  // sysycProf*: call, rdcycle/rdinstret, counter update
+};
+
+class Simulator final {
+  struct BlockStats final {
+    uint64_t execCount = 0;
+    uint64_t instCount = 0;
+    uint64_t cycles = 0;
+    uint64_t mispredicts = 0;
+    uint64_t cacheMisses = 0;
+  };
+  struct FunctionStats final {
+    uint64_t calls = 0;
+    uint64_t totalCycles = 0;
+    uint64_t entryCycle = 0;
+    uint32_t active = 0;  // recursion depth, inclusive time counts the outermost one
+  };
+  struct Cursor final {
+    MIRFunction* func;
+    uint32_t block;
+    MIRInstList::iterator inst;
+  };
+
+  MIRModule& mModule;
+  Target& mTarget;
+  SimConfig mConfig;
+
+  /* code layout */
+  std::unordered_map<MIRFunction*, std::vector<MIRBlock*>> mLayout;
+  std::unordered_map<MIRBlock*, uint32_t> mBlockIndex;
+  std::unordered_map<const MIRRelocable*, uint64_t> mSymbolAddr;
+  std::unordered_map<uint64_t, MIRFunction*> mFunctionAt;
+  std::unordered_map<std::string, MIRFunction*> mFunctionByName;
+
+  /* memory: globals + stack */
+  uint64_t mDataBase = 0, mDataSize = 0;
+  std::vector<uint8_t> mData;
+  std::unique_ptr<uint8_t, void (*)(void*)> mStack{nullptr, nullptr};
+
+  /* architectural state */
+  int64_t mGPR[32] = {};
+  float mFPR[32] = {};
+  std::vector<Cursor> mCallStack;
+  /* parallelForRegionN bodies (parallelInvoke2 tasks) still to run when the call stack is
+   * back at depth */
+  struct RegionBody final {
+    size_t depth;
+    int32_t beg, end;
+    int64_t payload;
+    MIRFunction* body;
+    bool task = false;  // body(payload)
+  };
+  std::vector<RegionBody> mRegionBodies;
+
+  /* timing state */
+  std::unordered_map<const MIRInst*, std::unordered_map<uint32_t, uint32_t>> mRenameMap;
+  std::optional<ScheduleState> mState;
+  uint64_t mEpochCycles = 0;
+  std::unordered_map<const MIRInst*, uint8_t> mBHT;
+  SimCache mL1D, mL2;
+
+  /* statistics */
+  uint64_t mCycles = 0, mInsts = 0;
+  uint64_t mBranches = 0, mMispredicts = 0;
+  uint64_t mMemAccesses = 0, mL1DMisses = 0, mL2Misses = 0;
+  uint64_t mTimerStart = 0, mTimedCycles = 0;
+  std::unordered_map<MIRBlock*, BlockStats> mBlockStats;
+  std::unordered_map<MIRFunction*, FunctionStats> mFuncStats;
+  std::unordered_map<std::string, uint64_t> mRuntimeCycles;
+  BlockStats mRuntimeStats;  // emulated runtime calls are not part of any block
+  int32_t mExitCode = 0;
+  std::string mError;
+
+public:
+  Simulator(MIRModule& module, Target& target, SimConfig config = {});
+
+  /* run main() to completion; stdin of the program is `in`, its stdout is `out` */
+  bool run(std::istream& in, std::ostream& out);
+  void report(std::ostream& os, size_t topBlocks = 20) const;
+
+  auto cycles() const { return mCycles; }
+  auto exitCode() const { return mExitCode; }
+  const auto& error() const { return mError; }
+
+private:
+  void layoutProgram();
+  uint8_t* translate(uint64_t addr, uint32_t size);
+  template <typename T>
+  bool load(uint64_t addr, T& val);
+  template <typename T>
+  bool store(uint64_t addr, T val);
+  bool fault(const std::string& msg, const Cursor& cur);
+
+  /* timing */
+  void advance(uint64_t cycles, BlockStats& stats);
+  void issue(const MIRInst& inst, BlockStats& stats);
+  uint32_t dataAccess(uint64_t addr, BlockStats& stats);
+  bool predict(const MIRInst& inst, bool taken, bool backward);
+
+  /* calls */
+  void enterFunction(MIRFunction* func);
+  void leaveFunction(MIRFunction* func);
+  bool callRuntime(MIRFunction* callee, std::istream& in, std::ostream& out);
+
+  int64_t readGPR(const MIROperand& op) const;
+  void writeGPR(const MIROperand& op, int64_t val);
+  float readFPR(const MIROperand& op) const { return mFPR[op.reg() - FPRBegin]; }
+  void writeFPR(const MIROperand& op, float val) { mFPR[op.reg() - FPRBegin] = val; }
+  int64_t immOrAddr(const MIROperand& op) const;
+};
+
+RISCV_NAMESPACE_END
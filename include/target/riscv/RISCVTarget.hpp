@@ -16,9 +16,43 @@ namespace mir {
  * @brief: RISCVDataLayout Class
  * @note: RISC-V数据信息 (64位)
  */
-static const std::string SysYRuntime =
-#include "autogen/riscv/RuntimeWithParallelFor.hpp"
+/*
+ * runtime components (src/runtime), compiled by compile.py into the build tree, see
+ * RISCVTarget::emit_assembly: the prologue is always emitted, the others only if the
+ * module references them
+ */
+static const std::string SysYRuntimePrologue =
+#include "autogen/riscv/RuntimePrologue.hpp"
+  ;
+static const std::string SysYMemsetRuntime =
+#include "autogen/riscv/RuntimeMemset.hpp"
+  ;
+/* thread pool + parallelFor, the workers start with the first parallel call */
+static const std::string SysYParallelForRuntime =
+#include "autogen/riscv/RuntimeParallelFor.hpp"
+  ;
+/* -finstrument-loops, emitted only if the module calls sysycProfInit */
+static const std::string SysYLoopProfileRuntime =
+#include "autogen/riscv/RuntimeLoopProfile.hpp"
+  ;
+/* fork-join regions of LoopParallel, emitted with SysYParallelForRuntime if the module calls parallelForRegion* */
+static const std::string SysYParallelRegionRuntime =
+#include "autogen/riscv/RuntimeParallelRegion.hpp"
+  ;
+/* task parallelism of TaskParallel, emitted with SysYParallelForRuntime if the module calls parallelInvoke2 */
+static const std::string SysYTaskParallelRuntime =
+#include "autogen/riscv/RuntimeTaskParallel.hpp"
+  ;
+/* buffered I/O, emitted if the module calls one of SysYIORuntimeSymbols */
+static const std::string SysYIORuntime =
+#include "autogen/riscv/RuntimeIO.hpp"
   ;
+/* sylib function -> its replacement in SysYIORuntime (lowering, runtime.buffered-io) */
+static const std::unordered_map<std::string, std::string> SysYIORuntimeSymbols = {
+  {"getint", "sysycGetint"},     {"getch", "sysycGetch"},         {"getfloat", "sysycGetfloat"},
+  {"getarray", "sysycGetarray"}, {"getfarray", "sysycGetfarray"}, {"putint", "sysycPutint"},
+  {"putch", "sysycPutch"},       {"putfloat", "sysycPutfloat"},   {"putarray", "sysycPutarray"},
+  {"putfarray", "sysycPutfarray"}, {"putf", "sysycPutf"}};
 class RISCVDataLayout final : public DataLayout {
 public:
   Endian edian() const override { return Endian::Little; }
@@ -1,6 +1,7 @@
 #pragma once
 #include <any>
 #include <typeinfo>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -24,6 +25,9 @@ private:
   std::vector<size_t> _path;
   bool _is_alloca = false;
 
+  /* compile-time values of const arrays (alloca or global var), row-major */
+  std::unordered_map<ir::Value*, std::vector<ir::Value*>> mConstArrays;
+
 public:
   SysYIRGenerator() {};
   SysYIRGenerator(ir::Module* module, antlr4::ParserRuleContext* root)
@@ -76,6 +80,8 @@ public:
                               size_t capacity);
   ir::Value* visitGlobalScalar(SysYParser::VarDefContext* ctx, ir::Type* btype, bool is_const);
 
+  void recordConstArray(ir::Value* array, const std::vector<ir::Value*>& init, ir::Type* btype);
+
   std::any visitBtype(SysYParser::BtypeContext* ctx) override;
 
   std::any visitLValue(SysYParser::LValueContext* ctx) override;
@@ -96,6 +102,8 @@ public:
   //! visit EXP
   std::any visitVarExp(SysYParser::VarExpContext* ctx) override;
 
+  ir::Value* constArrayElement(ir::Value* array, const std::vector<ir::Value*>& indices);
+
   std::any visitParenExp(SysYParser::ParenExpContext* ctx) override;
 
   std::any visitNumberExp(SysYParser::NumberExpContext* ctx) override;
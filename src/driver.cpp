@@ -28,6 +28,7 @@
 
 #include "target/riscv/RISCV.hpp"
 #include "target/riscv/RISCVTarget.hpp"
+#include "target/riscv/RISCVSimulator.hpp"
 
 #include "support/config.hpp"
 #include "support/FileSystem.hpp"
@@ -161,6 +162,7 @@ void frontendPipeline(const string& infile, ir::Module& module) {
  * 2. **IR Lowering**: Converts high-level IR to Machine Intermediate Representation (MIR)
  * 3. **Code Generation**: Generates target-specific assembly code
  * 4. **Assembly Output**: Emits the final assembly code to the output file
+ * 5. **Simulation**: Optionally runs the final MIR on the sifive-u74 cycle model (-R)
  * 
  * The backend transforms the optimized IR into executable assembly code for the
  * target architecture (currently RISC-V 64-bit).
@@ -187,6 +189,15 @@ void backendPipeline(ir::Module& module, pass::TopAnalysisInfoManager& tAIM) {
   
   // Generate and output target assembly code
   dumpMIRModule(*mir_module, target, config.outfile);
+
+  // Estimate cycles of the generated code without hardware
+  if (not config.simInput.empty()) {
+    ifstream fin(config.simInput);
+    auto simulator = mir::RISCV::Simulator(*mir_module, target);
+    simulator.run(fin, std::cout);
+    std::cout.flush();
+    simulator.report(std::cerr);
+  }
 }
 
 /**
@@ -273,4 +284,9 @@ void compilerPipeline() {
   if (config.logLevel >= sysy::LogLevel::DEBUG) {
     utils::Profiler::get().printStatistics();
   }
+  // Machine-readable compile-time statistics for the benchmark suite
+  if (not config.statsFile.empty()) {
+    ofstream fout(config.statsFile);
+    utils::Profiler::get().dumpStatistics(fout);
+  }
 }
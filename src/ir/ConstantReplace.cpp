@@ -2,6 +2,7 @@
 
 #include "ir/utils_ir.hpp"
 #include "ir/ConstantValue.hpp"
+#include <bit>
 
 using namespace ir;
 
@@ -19,50 +20,46 @@ Value* BinaryInst::getConstantRepl(bool recursive) {
     }
   }
 
+  if (lval == nullptr or rval == nullptr) return nullptr;
   if (not(lval->isa<ConstantValue>() and rval->isa<ConstantValue>()))
     return nullptr;
 
-  int32_t i32val = 0;
-  float f32val = 0.0;
-
-  auto clval = lval->dynCast<ConstantValue>();
-  auto crval = rval->dynCast<ConstantValue>();
+  return foldConstant(mValueId, lval->as<ConstantValue>(), rval->as<ConstantValue>());
+}
 
-  switch (mValueId) {
+/* i32 wraps, division by zero and INT_MIN / -1 are left to runtime */
+Value* BinaryInst::foldConstant(ValueId kind, ConstantValue* lhs, ConstantValue* rhs) {
+  const auto wrap = [](uint32_t val) {
+    return ConstantInteger::gen_i32(static_cast<int32_t>(val));
+  };
+  switch (kind) {
     case vADD:
-      i32val = clval->i32() + crval->i32();
-      break;
+      return wrap(static_cast<uint32_t>(lhs->i32()) + static_cast<uint32_t>(rhs->i32()));
     case vSUB:
-      i32val = clval->i32() - crval->i32();
-      break;
+      return wrap(static_cast<uint32_t>(lhs->i32()) - static_cast<uint32_t>(rhs->i32()));
     case vMUL:
-      i32val = clval->i32() * crval->i32();
-      break;
+      return wrap(static_cast<uint32_t>(lhs->i32()) * static_cast<uint32_t>(rhs->i32()));
     case vSDIV:
-      i32val = clval->i32() / crval->i32();
-      break;
     case vSREM:
-      i32val = clval->i32() % crval->i32();
-      break;
+      if (rhs->i32() == 0 or (lhs->i32() == INT32_MIN and rhs->i32() == -1)) return nullptr;
+      return ConstantInteger::gen_i32(kind == vSDIV ? lhs->i32() / rhs->i32()
+                                                    : lhs->i32() % rhs->i32());
+    case vSMIN:
+      return ConstantInteger::gen_i32(std::min(lhs->i32(), rhs->i32()));
+    case vSMAX:
+      return ConstantInteger::gen_i32(std::max(lhs->i32(), rhs->i32()));
     case vFADD:
-      f32val = clval->f32() + crval->f32();
-      break;
+      return ConstantFloating::gen_f32(lhs->f32() + rhs->f32());
     case vFSUB:
-      f32val = clval->f32() - crval->f32();
-      break;
+      return ConstantFloating::gen_f32(lhs->f32() - rhs->f32());
     case vFMUL:
-      f32val = clval->f32() * crval->f32();
-      break;
+      return ConstantFloating::gen_f32(lhs->f32() * rhs->f32());
     case vFDIV:
-      f32val = clval->f32() / crval->f32();
-      break;
+      return ConstantFloating::gen_f32(lhs->f32() / rhs->f32());
     default:
       assert(false and "Error in BinaryInst::getConstantRepl!");
   }
-  if (type()->isFloat32())
-    return ConstantFloating::gen_f32(f32val);
-  else
-    return ConstantInteger::gen_i32(i32val);
+  return nullptr;
 }
 
 Value* UnaryInst::getConstantRepl(bool recursive) {
@@ -85,6 +82,16 @@ Value* UnaryInst::getConstantRepl(bool recursive) {
       return ConstantInteger::gen_i32(cval->i1());
     case vFNEG:
       return ConstantFloating::gen_f32(-cval->f32());
+    case vABS:
+      /* wraps at INT_MIN like llvm.abs(x, i1 false) */
+      return ConstantInteger::gen_i32(
+        static_cast<int32_t>(std::abs(static_cast<int64_t>(cval->i32()))));
+    case vCTPOP:
+      return ConstantInteger::gen_i32(std::popcount(static_cast<uint32_t>(cval->i32())));
+    case vCTLZ:
+      return ConstantInteger::gen_i32(std::countl_zero(static_cast<uint32_t>(cval->i32())));
+    case vCTTZ:
+      return ConstantInteger::gen_i32(std::countr_zero(static_cast<uint32_t>(cval->i32())));
     default:
       std::cerr << mValueId << std::endl;
       assert(false && "Invalid scid from UnaryInst::getConstantRepl");
@@ -78,6 +78,10 @@ Instruction* MemsetInst::copy(std::function<Value*(Value*)> getValue) const {
                                  getValue(operand(3)));
 }
 
+Instruction* PrefetchInst::copy(std::function<Value*(Value*)> getValue) const {
+  return utils::make<PrefetchInst>(getValue(operand(0)));
+}
+
 Instruction* GetElementPtrInst::copy(std::function<Value*(Value*)> getValue) const {
   auto newvalue = getValue(value());
   auto newidx = getValue(index());
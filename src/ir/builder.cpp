@@ -2,66 +2,67 @@
 #include "ir/ConstantValue.hpp"
 namespace ir {
 
+ValueId IRBuilder::binaryValueId(BinaryOp op, const Type* type) {
+  const auto btype = type->btype();
+  switch (btype) {
+    case BasicTypeRank::INT64: {
+      switch (op) {
+        case BinaryOp::ADD:
+          return ValueId::vADD;
+        case BinaryOp::SUB:
+          return ValueId::vSUB;
+        case BinaryOp::MUL:
+          return ValueId::vMUL;
+        case BinaryOp::DIV:
+          return ValueId::vSDIV;
+        case BinaryOp::REM:
+          return ValueId::vSREM;
+        default:
+          assert(false && "makeBinary: invalid op!");
+      }
+    }
+    case BasicTypeRank::INT32: {
+      switch (op) {
+        case BinaryOp::ADD:
+          return ValueId::vADD;
+        case BinaryOp::SUB:
+          return ValueId::vSUB;
+        case BinaryOp::MUL:
+          return ValueId::vMUL;
+        case BinaryOp::DIV:
+          return ValueId::vSDIV;
+        case BinaryOp::REM:
+          return ValueId::vSREM;
+        default:
+          assert(false && "makeBinary: invalid op!");
+      }
+    }
+    case BasicTypeRank::FLOAT: {
+      switch (op) {
+        case BinaryOp::ADD:
+          return ValueId::vFADD;
+        case BinaryOp::SUB:
+          return ValueId::vFSUB;
+        case BinaryOp::MUL:
+          return ValueId::vFMUL;
+        case BinaryOp::DIV:
+          return ValueId::vFDIV;
+        default:
+          assert(false && "makeBinary: invalid op!");
+      }
+    }
+    default:
+      assert(false && "makeBinary: invalid type!");
+  }
+  return ValueId::vInvalid;
+}
+
 Value* IRBuilder::makeBinary(BinaryOp op, Value* lhs, Value* rhs) {
   const Type *ltype = lhs->type(), *rtype = rhs->type();
   if (ltype != rtype) {
     assert(false && "create_eq_beta: type mismatch!");
   }
-
-  auto vid = [btype = ltype->btype(), op] {
-    switch (btype) {
-      case BasicTypeRank::INT64: {
-        switch (op) {
-          case BinaryOp::ADD:
-            return ValueId::vADD;
-          case BinaryOp::SUB:
-            return ValueId::vSUB;
-          case BinaryOp::MUL:
-            return ValueId::vMUL;
-          case BinaryOp::DIV:
-            return ValueId::vSDIV;
-          case BinaryOp::REM:
-            return ValueId::vSREM;
-          default:
-            assert(false && "makeBinary: invalid op!");
-        }
-      }
-      case BasicTypeRank::INT32: {
-        switch (op) {
-          case BinaryOp::ADD:
-            return ValueId::vADD;
-          case BinaryOp::SUB:
-            return ValueId::vSUB;
-          case BinaryOp::MUL:
-            return ValueId::vMUL;
-          case BinaryOp::DIV:
-            return ValueId::vSDIV;
-          case BinaryOp::REM:
-            return ValueId::vSREM;
-          default:
-            assert(false && "makeBinary: invalid op!");
-        }
-      }
-      case BasicTypeRank::FLOAT: {
-        switch (op) {
-          case BinaryOp::ADD:
-            return ValueId::vFADD;
-          case BinaryOp::SUB:
-            return ValueId::vFSUB;
-          case BinaryOp::MUL:
-            return ValueId::vFMUL;
-          case BinaryOp::DIV:
-            return ValueId::vFDIV;
-          default:
-            assert(false && "makeBinary: invalid op!");
-        }
-      }
-      default:
-        assert(false && "makeBinary: invalid type!");
-    }
-    return ValueId::vInvalid;
-  }();
-  auto res = makeInst<BinaryInst>(vid, lhs->type(), lhs, rhs);
+  auto res = makeInst<BinaryInst>(binaryValueId(op, ltype), lhs->type(), lhs, rhs);
   return res;
 }
 
@@ -99,6 +100,13 @@ Value* IRBuilder::makeUnary(ValueId vid, Value* val, Type* ty) {
     case ValueId::vINTTOPTR:
       assert(val->type()->isInt());
       break;
+    case ValueId::vABS:
+    case ValueId::vCTPOP:
+    case ValueId::vCTLZ:
+    case ValueId::vCTTZ:
+      ty = val->type();
+      assert(ty->isInt32() && "bit intrinsics must have i32 operand");
+      break;
     default:
       assert(false && "makeUnary: invalid vid!");
   }
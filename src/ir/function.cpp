@@ -66,6 +66,7 @@ bool Loop::hasDedicatedExits() const {
 BasicBlock* Function::newBlock() {
   auto nb = utils::make<BasicBlock>("", this);
   mBlocks.emplace_back(nb);
+  markChanged();
   return nb;
 }
 
@@ -73,19 +74,23 @@ BasicBlock* Function::newEntry(const_str_ref name) {
   assert(mEntry == nullptr);
   mEntry = utils::make<BasicBlock>(name, this);
   mBlocks.emplace_back(mEntry);
+  markChanged();
   return mEntry;
 }
 BasicBlock* Function::newExit(const_str_ref name) {
   mExit = utils::make<BasicBlock>(name, this);
   mBlocks.emplace_back(mExit);
+  markChanged();
   return mExit;
 }
 void Function::delBlock(BasicBlock* bb) {
   for (auto bbpre : bb->pre_blocks()) {
     bbpre->next_blocks().remove(bb);
+    bbpre->markChanged();
   }
   for (auto bbnext : bb->next_blocks()) {
     bbnext->pre_blocks().remove(bb);
+    bbnext->markChanged();
   }
   for (auto bbinstIter = bb->insts().begin(); bbinstIter != bb->insts().end();) {
     auto delinst = *bbinstIter;
@@ -93,15 +98,18 @@ void Function::delBlock(BasicBlock* bb) {
     bb->delete_inst(delinst);
   }
   mBlocks.remove(bb);
+  markChanged();
   // delete bb;
 }
 
 void Function::forceDelBlock(BasicBlock* bb) {
   for (auto bbpre : bb->pre_blocks()) {
     bbpre->next_blocks().remove(bb);
+    bbpre->markChanged();
   }
   for (auto bbnext : bb->next_blocks()) {
     bbnext->pre_blocks().remove(bb);
+    bbnext->markChanged();
   }
   for (auto bbinstIter = bb->insts().begin(); bbinstIter != bb->insts().end();) {
     auto delinst = *bbinstIter;
@@ -109,6 +117,7 @@ void Function::forceDelBlock(BasicBlock* bb) {
     bb->force_delete_inst(delinst);
   }
   mBlocks.remove(bb);
+  markChanged();
 }
 void Function::dumpAsOpernd(std::ostream& os) const {
   os << "@" << mName;
@@ -23,6 +23,7 @@ void GlobalVariable::print(std::ostream& os) const {
   } else {
     os << *scalarValue();
   }
+  if (mAlign) os << ", align " << mAlign;
 
   os << "\n";
 }
@@ -78,6 +78,7 @@ void BasicBlock::emplace_inst(inst_iterator pos, Instruction* i) {
     size_t index = std::distance(mInsts.begin(), pos);
     mPhiInsts.emplace(std::next(mPhiInsts.begin(), index), phiInst);
   }
+  markChanged();
 }
 void BasicBlock::emplace_first_inst(Instruction* inst) {
   // Warning: didn't check _is_terminal
@@ -97,6 +98,7 @@ void BasicBlock::emplace_first_inst(Instruction* inst) {
     mInsts.emplace(pos, inst);
   }
   inst->setBlock(this);
+  markChanged();
 }
 
 void BasicBlock::emplace_back_inst(Instruction* i) {
@@ -110,6 +112,7 @@ void BasicBlock::emplace_back_inst(Instruction* i) {
   if (auto phiInst = dyn_cast<PhiInst>(i))
     // assert(false and "a phi can not be inserted at the back of a bb");
     mPhiInsts.emplace_back(phiInst);
+  markChanged();
 }
 
 void BasicBlock::emplace_lastbutone_inst(Instruction* i) {
@@ -141,24 +144,42 @@ void BasicBlock::delete_inst(Instruction* inst) {
   }
   mInsts.remove(inst);
   if (auto phiInst = dyn_cast<PhiInst>(inst)) mPhiInsts.remove(phiInst);
+  markChanged();
 
   // delete inst;
 }
 
 void BasicBlock::force_delete_inst(Instruction* inst) {
   // assert(inst->uses().size()==0);
+  // the remaining users now refer to a dead def, re-verify them too
+  markUsersChanged(inst);
   for (auto op_use : inst->operands()) {
     auto op = op_use->value();
     op->uses().remove(op_use);
   }
   mInsts.remove(inst);
   if (auto phiInst = dyn_cast<PhiInst>(inst)) mPhiInsts.remove(phiInst);
+  markChanged();
 }
 
 void BasicBlock::move_inst(Instruction* inst) {
   // assert(inst->uses().size()==0);
   mInsts.remove(inst);
   if (auto phiInst = dyn_cast<PhiInst>(inst)) mPhiInsts.remove(phiInst);
+  markChanged();
+}
+
+void BasicBlock::markChanged() {
+  mChanged = true;
+  if (mFunction) mFunction->markChanged();
+}
+
+void BasicBlock::markUsersChanged(Value* def) {
+  for (auto use : def->uses()) {
+    if (auto user = use->user()->dynCast<Instruction>()) {
+      if (user->block()) user->block()->markChanged();
+    }
+  }
 }
 
 void BasicBlock::replaceinst(Instruction* old_inst, Value* new_) {
@@ -192,14 +213,15 @@ bool Instruction::isMemory() {
          mValueId == vGETELEMENTPTR;
 };
 bool Instruction::isNoName() {
-  return isTerminator() or mValueId == vSTORE or mValueId == vMEMSET;
+  return isTerminator() or mValueId == vSTORE or mValueId == vMEMSET or mValueId == vPREFETCH;
 }
 bool Instruction::isAggressiveAlive() {
   return mValueId == vSTORE or mValueId == vCALL or mValueId == vMEMSET or mValueId == vRETURN or
-         mValueId == vATOMICRMW;
+         mValueId == vATOMICRMW or mValueId == vPREFETCH;
 }
 bool Instruction::hasSideEffect() {
-  if (mValueId == vSTORE or mValueId == vMEMSET or mValueId == vRETURN) return true;
+  if (mValueId == vSTORE or mValueId == vMEMSET or mValueId == vRETURN or mValueId == vPREFETCH)
+    return true;
   return false;  // 默认call没有
 }
 
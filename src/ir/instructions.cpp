@@ -26,6 +26,10 @@ static const std::string getInstName(ValueId instID) {
       return "srem";
     case vFREM:
       return "frem";
+    case vSMIN:
+      return "smin";
+    case vSMAX:
+      return "smax";
     case vALLOCA:
       return "alloca";
     case vLOAD:
@@ -59,6 +63,14 @@ static const std::string getInstName(ValueId instID) {
       return "ptrtoint";
     case vINTTOPTR:
       return "inttoptr";
+    case vABS:
+      return "abs";
+    case vCTPOP:
+      return "ctpop";
+    case vCTLZ:
+      return "ctlz";
+    case vCTTZ:
+      return "cttz";
     // cmp
     case vIEQ:
       return "icmp eq";
@@ -167,10 +179,20 @@ void ReturnInst::print(std::ostream& os) const {
  * @brief: BinaryInst::print
  * @details:
  *    <result> = add <ty> <op1>, <op2>
+ *    <result> = call <ty> @llvm.smin.<ty>(<ty> <op1>, <ty> <op2>)
  */
 void BinaryInst::print(std::ostream& os) const {
   dumpAsOpernd(os);
   os << " = ";
+  if (mValueId == vSMIN || mValueId == vSMAX) {
+    os << "call " << *type() << " @llvm." << getInstName(mValueId) << "." << *type() << "(";
+    os << *type() << " ";
+    lValue()->dumpAsOpernd(os);
+    os << ", " << *type() << " ";
+    rValue()->dumpAsOpernd(os);
+    os << ")";
+    return;
+  }
   os << getInstName(mValueId) << " ";
   // <type>
   os << *type() << " ";
@@ -201,10 +223,20 @@ void BinaryInst::print(std::ostream& os) const {
  *    <result> = ptrtoint <ty> <value> to <ty2>
  *    <result> = inttoptr <ty> <value> to <ty2>
  *    <result> = sext <ty> <value> to <ty2>
+ *    <result> = call <ty> @llvm.ctlz.<ty>(<ty> <value>, i1 false)
  */
 void UnaryInst::print(std::ostream& os) const {
   dumpAsOpernd(os);
   os << " = ";
+  if (mValueId >= vABS && mValueId <= vCTTZ) {
+    os << "call " << *type() << " @llvm." << getInstName(mValueId) << "." << *type() << "(";
+    os << *type() << " ";
+    value()->dumpAsOpernd(os);
+    /* is_zero_poison = false: ctlz/cttz of 0 is the bit width, abs of INT_MIN wraps */
+    if (mValueId != vCTPOP) os << ", i1 false";
+    os << ")";
+    return;
+  }
   os << getInstName(mValueId) << " ";
   os << *(value()->type()) << " ";
   value()->dumpAsOpernd(os);
@@ -525,6 +557,18 @@ void MemsetInst::print(std::ostream& os) const {
   os << ")";
 }
 
+/*
+ * @brief: PrefetchInst::print
+ * @details:
+ *    call void @llvm.prefetch.p0i8(i8* <ptr>, i32 0, i32 3, i32 1)
+ */
+void PrefetchInst::print(std::ostream& os) const {
+  os << "call void @llvm.prefetch.p0i8(";
+  os << *(ptr()->type()) << " ";
+  ptr()->dumpAsOpernd(os);
+  os << ", i32 0, i32 3, i32 1)";
+}
+
 void FunctionPtrInst::print(std::ostream& os) const {}
 
 void PtrCastInst::print(std::ostream& os) const {}
@@ -33,6 +33,8 @@ Function* Module::addFunction(Type* type, const_str_ref name) {
 
 void Module::delFunction(ir::Function* func) {
   assert(findFunction(func->name()) != nullptr && "delete unexisted function!");
+  // the callers lose their callee, re-verify them
+  BasicBlock::markUsersChanged(func);
   mFuncTable.erase(func->name());
   mFunctions.erase(std::find(mFunctions.begin(), mFunctions.end(), func));
   for (auto bbiter = func->blocks().begin(); bbiter != func->blocks().end();) {
@@ -55,6 +57,7 @@ void Module::delGlobalVariable(ir::GlobalVariable* gv) {
   auto pos = std::find(mGlobalVariables.begin(), mGlobalVariables.end(), gv);
   mGlobalVariables.erase(pos);
   mGlobalVariableTable.erase(gv->name());
+  BasicBlock::markUsersChanged(gv);
 }
 
 // readable ir print
@@ -65,7 +68,15 @@ void Module::print(std::ostream& os) const {
   }
 
   // llvm inline function
-  os << "declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)\n"
+  os << "declare void @llvm.memset.p0i8.i64(i8* nocapture writeonly, i8, i64, i1 immarg)\n";
+  os << "declare void @llvm.prefetch.p0i8(i8* nocapture readonly, i32 immarg, i32 immarg, "
+        "i32 immarg)\n";
+  os << "declare i32 @llvm.smin.i32(i32, i32)\n"
+     << "declare i32 @llvm.smax.i32(i32, i32)\n"
+     << "declare i32 @llvm.abs.i32(i32, i1 immarg)\n"
+     << "declare i32 @llvm.ctpop.i32(i32)\n"
+     << "declare i32 @llvm.ctlz.i32(i32, i1 immarg)\n"
+     << "declare i32 @llvm.cttz.i32(i32, i1 immarg)\n"
      << std::endl;
 
   //! print all functions
@@ -1,6 +1,14 @@
 #include "ir/value.hpp"
+#include "ir/infrast.hpp"
 #include "support/arena.hpp"
 namespace ir {
+// an operand edit of an instruction invalidates what IRCheck verified of its block
+static void markOperandsChanged(User* user) {
+  if (auto inst = user->dynCast<Instruction>()) {
+    if (inst->block()) inst->block()->markChanged();
+  }
+}
+
 //! Use
 void Use::print(std::ostream& os) const {
   os << "use(" << mIndex << ", ";
@@ -76,12 +84,14 @@ void User::addOperand(Value* value) {
   mOperands.emplace_back(new_use);
   /* add use to value.mUses */
   value->uses().emplace_back(new_use);
+  markOperandsChanged(this);
 }
 
 void User::unuse_allvalue() {
   for (auto& operand : mOperands) {
     operand->value()->uses().remove(operand);
   }
+  markOperandsChanged(this);
 }
 void User::delete_operands(size_t index) {
   mOperands.at(index)->value()->uses().remove(mOperands.at(index));
@@ -89,6 +99,7 @@ void User::delete_operands(size_t index) {
   for (size_t idx = index + 1; idx < mOperands.size(); idx++)
     mOperands.at(idx)->set_index(idx);
   refresh_operand_index();
+  markOperandsChanged(this);
 }
 void User::refresh_operand_index() {
   size_t cnt = 0;
@@ -107,6 +118,7 @@ void User::setOperand(size_t index, Value* value) {
   auto newUse = new Use(index, this, value);
   mOperands.at(index) = newUse;
   value->uses().emplace_back(mOperands.at(index));
+  markOperandsChanged(this);
 }
 
 }  // namespace ir
\ No newline at end of file
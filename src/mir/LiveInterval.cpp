@@ -4,6 +4,8 @@
 #include "mir/LiveInterval.hpp"
 #include "mir/target.hpp"
 #include "mir/CFGAnalysis.hpp"
+#include "support/DataFlow.hpp"
+#include "support/Hyperparameters.hpp"
 
 namespace mir {
 /* utils function: 为每一条指令编号 */
@@ -104,16 +106,51 @@ void cleanupRegFlags(MIRFunction& mfunc, CodeGenContext& ctx) {
         for (auto& inst : block.get()->insts()) {
             auto& instinfo = ctx.instInfo.getInstInfo(inst);
             for (uint32_t idx = 0; idx < instinfo.operand_num(); idx++) {
-                auto op = inst->operand(idx);
+                auto& op = inst->operand(idx);
                 if (op.isReg()) {
-                    auto reg = std::get<MIRRegister>(op.storage());
-                    reg.set_flag(RegisterFlagNone);
+                    std::get<MIRRegister>(op.storage()).set_flag(RegisterFlagNone);
                 }
             }
         }
     }
 }
 
+/*
+ * -X dataflow.verify: ins/outs against the round-robin fixpoint calcLiveIntervals
+ * used before support/DataFlow.hpp, aborts on the first block that differs
+ */
+static void verifyLiveness(MIRFunction& mfunc, const CFGAnalysis& cfg, const LiveVariablesInfo& info) {
+    std::unordered_map<MIRBlock*, std::unordered_set<RegNum>> ins, outs;
+    while (true) {
+        bool modified = false;
+        for (auto& block : mfunc.blocks()) {
+            auto b = block.get();
+            auto& blockInfo = info.block2Info.at(b);
+            std::unordered_set<RegNum> out;
+            for (auto [succ, prob] : cfg.successors(b)) {
+                out.insert(ins[succ].begin(), ins[succ].end());
+            }
+            auto in = blockInfo.uses;
+            for (auto reg : out) {
+                if (!blockInfo.defs.count(reg)) in.insert(reg);
+            }
+            outs[b] = std::move(out);
+            if (in != ins[b]) {
+                ins[b] = std::move(in);
+                modified = true;
+            }
+        }
+        if (!modified) break;
+    }
+    for (auto& block : mfunc.blocks()) {
+        auto& blockInfo = info.block2Info.at(block.get());
+        if (ins[block.get()] == blockInfo.ins && outs[block.get()] == blockInfo.outs) continue;
+        std::cerr << "dataflow.verify: liveness of " << mfunc.name() << " differs in block "
+                  << block->name() << std::endl;
+        std::abort();
+    }
+}
+
 /* 全局活跃变量分析 */
 LiveVariablesInfo calcLiveIntervals(MIRFunction& mfunc, CodeGenContext& ctx) {
     constexpr bool Debug = false;
@@ -154,74 +191,79 @@ LiveVariablesInfo calcLiveIntervals(MIRFunction& mfunc, CodeGenContext& ctx) {
         }
     }
 
-    // stage 2: calculate ins and outs for each block
-    while (true) {
-        bool modified = false;
-        if (Debug) {
-            for(auto& block : mfunc.blocks()) {
-                auto& blockInfo = info.block2Info[block.get()];
-                
-                block->print(std::cerr, ctx); std::cerr << "\n";
-
-                std::cerr << "uses: ";
-                for(auto use : blockInfo.uses) {
-                    if (isVirtualReg(use)) std::cerr << "v" << (use ^ virtualRegBegin);
-                    else if (isISAReg(use)) std::cerr << "i" << use;
-                    else assert(false);
-                    std::cerr << " ";
-                }
-                std::cerr << '\n';
-
-                std::cerr << "defs: ";
-                for(auto def : blockInfo.defs) {
-                    if (isVirtualReg(def)) std::cerr << "v" << (def ^ virtualRegBegin);
-                    else if (isISAReg(def)) std::cerr << "i" << def;
-                    else assert(false);
-                    std::cerr << ' ';
-                }
-                std::cerr << '\n';
-
-                std::cerr << "ins: ";
-                for(auto in : blockInfo.ins) {
-                    if (isVirtualReg(in)) std::cerr << "v" << (in ^ virtualRegBegin);
-                    else if (isISAReg(in)) std::cerr << "i" << in;
-                    else assert(false);
-                    std::cerr << ' ';
-                }
-                std::cerr << '\n';
-
-                std::cerr << "outs: ";
-                for(auto out : blockInfo.outs) {
-                    if (isVirtualReg(out)) std::cerr << "v" << (out ^ virtualRegBegin);
-                    else if (isISAReg(out)) std::cerr << "i" << out;
-                    std::cerr << ' ';
-                }
-                std::cerr << '\n';
+    // stage 2: calculate ins and outs for each block, backward dataflow over dense bit vectors
+    std::vector<MIRBlock*> blocks;
+    for (auto& block : mfunc.blocks()) blocks.push_back(block.get());
+    const utils::BlockGraph<MIRBlock> graph{std::move(blocks), [&](MIRBlock* block) {
+        std::vector<MIRBlock*> succs;
+        for (auto [succ, prob] : cfg.successors(block)) succs.push_back(succ);
+        return succs;
+    }};
+    std::unordered_map<RegNum, uint32_t> regIndex;  // 寄存器 -> 位向量下标
+    std::vector<RegNum> regs;
+    for (auto block : graph.blocks) {
+        auto& blockInfo = info.block2Info[block];
+        for (auto& regSet : {&blockInfo.uses, &blockInfo.defs}) {
+            for (auto id : *regSet) {
+                if (regIndex.emplace(id, regs.size()).second) regs.push_back(id);
             }
         }
-        for (auto& block : mfunc.blocks()) {
-            auto b = block.get();
-            auto& blockInfo = info.block2Info[b];
-            std::unordered_set<RegNum> outs;
-            for (auto [succ, prob] : cfg.successors(b)) {  // 计算当前块的输出集合
-                for (auto in : info.block2Info[succ].ins) {
-                    outs.insert(in);
-                }
+    }
+    using LivenessProblem = utils::GenKillProblem<utils::DataFlowDirection::Backward>;
+    LivenessProblem liveness{graph.blocks.size(), regs.size()};
+    for (utils::NodeIndex node = 0; node < graph.blocks.size(); node++) {
+        auto& blockInfo = info.block2Info[graph.blocks[node]];
+        for (auto id : blockInfo.uses) liveness.gen[node].set(regIndex[id]);
+        for (auto id : blockInfo.defs) liveness.kill[node].set(regIndex[id]);
+    }
+    const auto live = utils::solveDataFlow(graph.succs, 0, liveness);
+    for (utils::NodeIndex node = 0; node < graph.blocks.size(); node++) {
+        auto& blockInfo = info.block2Info[graph.blocks[node]];
+        live.in[node].forEach([&](size_t idx) { blockInfo.ins.insert(regs[idx]); });
+        live.out[node].forEach([&](size_t idx) { blockInfo.outs.insert(regs[idx]); });
+    }
+    if (utils::VerifyDataFlow) verifyLiveness(mfunc, cfg, info);
+    if (Debug) {
+        for(auto& block : mfunc.blocks()) {
+            auto& blockInfo = info.block2Info[block.get()];
+            
+            block->print(std::cerr, ctx); std::cerr << "\n";
+
+            std::cerr << "uses: ";
+            for(auto use : blockInfo.uses) {
+                if (isVirtualReg(use)) std::cerr << "v" << (use ^ virtualRegBegin);
+                else if (isISAReg(use)) std::cerr << "i" << use;
+                else assert(false);
+                std::cerr << " ";
             }
-            std::swap(blockInfo.outs, outs);
-            auto ins = blockInfo.uses;  // other block pass the ins to the next block
-            for (auto out : blockInfo.outs) {  // 计算当前块的输入集合
-                if (!blockInfo.defs.count(out)) {
-                    ins.insert(out);
-                }
+            std::cerr << '\n';
+
+            std::cerr << "defs: ";
+            for(auto def : blockInfo.defs) {
+                if (isVirtualReg(def)) std::cerr << "v" << (def ^ virtualRegBegin);
+                else if (isISAReg(def)) std::cerr << "i" << def;
+                else assert(false);
+                std::cerr << ' ';
             }
-            if (ins != blockInfo.ins) {
-                std::swap(blockInfo.ins, ins);
-                modified = true;
+            std::cerr << '\n';
+
+            std::cerr << "ins: ";
+            for(auto in : blockInfo.ins) {
+                if (isVirtualReg(in)) std::cerr << "v" << (in ^ virtualRegBegin);
+                else if (isISAReg(in)) std::cerr << "i" << in;
+                else assert(false);
+                std::cerr << ' ';
             }
-        }
+            std::cerr << '\n';
 
-        if (!modified) break;
+            std::cerr << "outs: ";
+            for(auto out : blockInfo.outs) {
+                if (isVirtualReg(out)) std::cerr << "v" << (out ^ virtualRegBegin);
+                else if (isISAReg(out)) std::cerr << "i" << out;
+                std::cerr << ' ';
+            }
+            std::cerr << '\n';
+        }
     }
 
     // stage 3: calculate live intervals
@@ -1,5 +1,6 @@
 #include "mir/MIR.hpp"
 #include "mir/RegisterAllocator.hpp"
+#include "support/Hyperparameters.hpp"
 
 namespace mir {
 
@@ -19,7 +20,9 @@ static size_t collectVregNumber(MIRFunction& mfunc, CodeGenContext& ctx) {
   return vregNum;
 }
 
-static size_t VregNumThreshold = 3000;
+static utils::Parameter<uint32_t> VregNumThreshold{
+  "regalloc.vreg-threshold", 3000,
+  "functions with more virtual registers use the fast allocator instead of graph coloring"};
 
 void mixedRegisterAllocate(MIRFunction& mfunc, CodeGenContext& ctx, IPRAUsageCache& infoIPRA) {
   const auto vregNum = collectVregNumber(mfunc, ctx);
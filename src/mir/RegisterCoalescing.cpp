@@ -1,8 +1,186 @@
+#include <algorithm>
+#include <optional>
 #include "mir/RegisterCoalescing.hpp"
+#include "mir/LiveInterval.hpp"
+#include "mir/CFGAnalysis.hpp"
+#include "mir/target.hpp"
 #include "mir/utils.hpp"
 namespace mir {
+/*
+ * @brief: Register Coalescing (寄存器合并)
+ * @note:
+ *      phi 已在 IR 层拆分关键边 (reg2mem), 并在 emitJump 中顺序化为并行拷贝,
+ *      因此 isel 之后每条 phi 边都是一组 vreg <- vreg 拷贝. 这里基于活跃区间构造
+ *      干涉图, 对拷贝两端做保守合并:
+ *          1. 两端活跃区间不相交 (不干涉)
+ *          2. Briggs: 合并后高度数 (>= K) 邻居个数 < K
+ *          3. George: src 的每个邻居要么与 dst 干涉, 要么度数 < K
+ *      满足 1 且满足 2/3 之一即可合并, 合并后拷贝变为自拷贝并被删除.
+ *      拷贝按所在块的执行频率从高到低处理, 优先消除循环内的拷贝.
+ */
+namespace {
+struct CoalesceCandidate final {
+  RegNum dst, src;
+  double weight;
+};
+
+class CoalescingGraph final {
+  std::unordered_map<RegNum, std::unordered_set<RegNum>> mAdj;
+  std::unordered_map<RegNum, RegNum> mLeader;
+
+public:
+  RegNum find(RegNum reg) {
+    auto it = mLeader.find(reg);
+    if (it == mLeader.end() || it->second == reg) return reg;
+    return it->second = find(it->second);
+  }
+  bool interfere(RegNum lhs, RegNum rhs) { return mAdj[lhs].count(rhs); }
+  void addEdge(RegNum lhs, RegNum rhs) {
+    mAdj[lhs].insert(rhs);
+    mAdj[rhs].insert(lhs);
+  }
+
+  bool briggs(RegNum lhs, RegNum rhs, size_t k) {
+    std::unordered_set<RegNum> neighbors = mAdj[lhs];
+    neighbors.insert(mAdj[rhs].begin(), mAdj[rhs].end());
+    size_t significant = 0;
+    for (auto t : neighbors) {
+      auto degree = mAdj[t].size();
+      /* t 同时与 lhs 和 rhs 相邻时, 合并后度数减一 */
+      if (mAdj[lhs].count(t) && mAdj[rhs].count(t)) degree--;
+      if (degree >= k && ++significant >= k) return false;
+    }
+    return true;
+  }
+  bool george(RegNum src, RegNum dst, size_t k) {
+    for (auto t : mAdj[src]) {
+      if (mAdj[t].size() >= k && !mAdj[dst].count(t)) return false;
+    }
+    return true;
+  }
+
+  /* 将 src 合并进 dst */
+  void merge(RegNum dst, RegNum src) {
+    mLeader[src] = dst;
+    auto neighbors = std::move(mAdj[src]);
+    mAdj.erase(src);
+    for (auto t : neighbors) {
+      mAdj[t].erase(src);
+      addEdge(dst, t);
+    }
+  }
+};
+
+bool coalesceCopies(MIRFunction& mfunc, CodeGenContext& ctx) {
+  auto liveInfo = calcLiveIntervals(mfunc, ctx);
+  auto cfg = calcCFG(mfunc, ctx);
+  auto blockFreq = calcFreq(mfunc, cfg);
+
+  const auto allocationClass = [&](const MIROperand& op) -> std::optional<uint32_t> {
+    if (op.type() > OperandType::Float32) return std::nullopt;
+    return ctx.registerInfo->getAllocationClass(op.type());
+  };
+
+  /* stage 1: collect copy candidates */
+  std::vector<CoalesceCandidate> candidates;
+  std::unordered_map<RegNum, uint32_t> regClass;
+  for (auto& block : mfunc.blocks()) {
+    const auto weight = blockFreq.query(block.get());
+    for (auto inst : block->insts()) {
+      auto& instInfo = ctx.instInfo.getInstInfo(inst);
+      for (uint32_t idx = 0; idx < instInfo.operand_num(); idx++) {
+        auto& op = inst->operand(idx);
+        if (!isOperandVReg(op)) continue;
+        if (auto cls = allocationClass(op)) regClass.emplace(regNum(op), *cls);
+      }
+      MIROperand dst, src;
+      if (!ctx.instInfo.matchCopy(inst, dst, src)) continue;
+      if (!isOperandVReg(dst) || !isOperandVReg(src)) continue;
+      const auto dstClass = allocationClass(dst), srcClass = allocationClass(src);
+      if (!dstClass || dstClass != srcClass) continue;
+      candidates.push_back({regNum(dst), regNum(src), weight});
+    }
+  }
+  if (candidates.empty()) return false;
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.weight > rhs.weight; });
+
+  /* stage 2: build interference graph from live intervals,
+   * one sweep over the segments in begin order, O(segments x register pressure) */
+  struct Segment final {
+    InstNum begin, end;
+    RegNum reg;
+  };
+  std::vector<Segment> segments;
+  for (auto& [reg, interval] : liveInfo.reg2Interval) {
+    if (!isVirtualReg(reg) || !regClass.count(reg)) continue;
+    for (auto& [begin, end] : interval.segments)
+      segments.push_back({begin, end, reg});
+  }
+  std::sort(segments.begin(), segments.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.begin != rhs.begin ? lhs.begin < rhs.begin : lhs.reg < rhs.reg;
+  });
+  CoalescingGraph graph;
+  /* segments live at the current begin, per allocation class */
+  std::unordered_map<uint32_t, std::vector<Segment>> active;
+  for (auto& segment : segments) {
+    auto& live = active[regClass.at(segment.reg)];
+    live.erase(std::remove_if(live.begin(), live.end(),
+                              [&](const auto& other) { return other.end <= segment.begin; }),
+               live.end());
+    for (auto& other : live) {
+      if (other.reg != segment.reg) graph.addEdge(segment.reg, other.reg);
+    }
+    live.push_back(segment);
+  }
+
+  /* stage 3: conservative coalescing */
+  bool modified = false;
+  for (auto& [dstReg, srcReg, weight] : candidates) {
+    const auto dst = graph.find(dstReg), src = graph.find(srcReg);
+    if (dst == src || graph.interfere(dst, src)) continue;
+    const auto k = ctx.registerInfo->get_allocation_list(regClass.at(dst)).size();
+    if (!graph.briggs(dst, src, k) && !graph.george(src, dst, k)) continue;
+    graph.merge(dst, src);
+    modified = true;
+  }
+  if (!modified) return false;
+
+  /* stage 4: rewrite operands and remove identity copies */
+  for (auto& block : mfunc.blocks()) {
+    auto& insts = block->insts();
+    for (auto it = insts.begin(); it != insts.end();) {
+      auto inst = *it;
+      auto& instInfo = ctx.instInfo.getInstInfo(inst);
+      for (uint32_t idx = 0; idx < instInfo.operand_num(); idx++) {
+        auto& op = inst->operand(idx);
+        if (!isOperandVReg(op)) continue;
+        const auto reg = graph.find(regNum(op));
+        if (reg != op.reg()) op = MIROperand{MIRRegister{reg}, op.type()};
+      }
+      MIROperand dst, src;
+      if (ctx.instInfo.matchCopy(inst, dst, src) && dst.reg() == src.reg()) {
+        it = insts.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  return true;
+}
+}  // namespace
+
 void RegisterCoalescing(MIRFunction& mfunc, CodeGenContext& ctx) {
   while (genericPeepholeOpt(mfunc, ctx))
     ;
+  if (!ctx.registerInfo) return;
+  /* 每轮合并后重新计算活跃区间, 轮数设上限以控制编译时间 */
+  constexpr uint32_t maxRounds = 4;
+  for (uint32_t round = 0; round < maxRounds && coalesceCopies(mfunc, ctx); round++) {
+    while (genericPeepholeOpt(mfunc, ctx))
+      ;
+  }
+  /* calcLiveIntervals 留下的 Dead 标记在合并后已失效 */
+  cleanupRegFlags(mfunc, ctx);
 }
-}  // namespace mir
\ No newline at end of file
+}  // namespace mir
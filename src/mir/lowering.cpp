@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <queue>
@@ -20,9 +21,15 @@
 #include "support/Profiler.hpp"
 #include "support/Graph.hpp"
 #include "support/FileSystem.hpp"
+#include "support/Hyperparameters.hpp"
 namespace fs = std::filesystem;
 namespace mir {
 
+static utils::Parameter<bool> BufferedIO{
+  "runtime.buffered-io", false,
+  "call the buffered I/O runtime instead of sylib's getint/putint/... (putf still prints via "
+  "sylib), off until test_asm.sh passes with it"};
+
 void createMIRModule(ir::Module& ir_module,
                      MIRModule& mir_module,
                      Target& target,
@@ -63,7 +70,13 @@ void createMIRModule(ir::Module& ir_module,
 
   //! 1. for all functions, create MIRFunction
   for (auto func : ir_module.funcs()) {
-    functions.push_back(std::make_unique<MIRFunction>(func->name(), &mir_module));
+    auto name = func->name();
+    /* sylib I/O goes to the buffered runtime (RuntimeIO.hpp) */
+    if (BufferedIO and func->blocks().empty()) {
+      if (auto iter = SysYIORuntimeSymbols.find(name); iter != SysYIORuntimeSymbols.end())
+        name = iter->second;
+    }
+    functions.push_back(std::make_unique<MIRFunction>(name, &mir_module));
     func_map.emplace(func, functions.back().get());
   }
 
@@ -73,12 +86,13 @@ void createMIRModule(ir::Module& ir_module,
     /* 基础类型 (int OR float) */
     auto type = ir_gvar->type()->dynCast<ir::PointerType>()->baseType();
     const size_t size = type->size();
+    /* arrays 8 byte aligned: adjacent words can be paired into ld/sd (more: arraylayout) */
+    const size_t align = std::max<size_t>(ir_gvar->align(), type->isArray() ? 8 : 4);
     if (type->isArray()) {
       type = dyn_cast<ir::ArrayType>(type)->baseType();
     }
     const bool read_only = ir_gvar->isConst();
     const bool is_float = type->isFloat32();
-    const size_t align = 4;
 
     if (ir_gvar->isInit()) {
       /* .data: 已初始化的、可修改的全局数据 (Array and Scalar) */
@@ -339,7 +353,7 @@ void createMIRFunction(ir::Function* ir_func,
 
     const auto ir_alloca = dyn_cast<ir::AllocaInst>(ir_inst);
     auto pointee_type = ir_alloca->baseType();
-    uint32_t align = 4;  // TODO: align, need bind to ir object
+    uint32_t align = pointee_type->isArray() ? 8 : 4;  // see global objects
     auto storage = mir_func->newStackObject(codegen_ctx.nextId(),                         // id
                                             static_cast<uint32_t>(pointee_type->size()),  // size
                                             align,                                        // align
@@ -414,6 +428,7 @@ void lower(ir::CallInst* ir_inst, LoweringContext& ctx);
 void lower(ir::ReturnInst* ir_inst, LoweringContext& ctx);
 void lower(ir::BranchInst* ir_inst, LoweringContext& ctx);
 void lower(ir::MemsetInst* ir_inst, LoweringContext& ctx);
+void lower(ir::PrefetchInst* ir_inst, LoweringContext& ctx);
 void lower(ir::GetElementPtrInst* ir_inst, LoweringContext& ctx);
 void lower(ir::AtomicrmwInst* ir_inst, LoweringContext& ctx);
 
@@ -429,6 +444,10 @@ void createMIRInst(ir::Instruction* ir_inst, LoweringContext& ctx) {
     case ir::ValueId::vBITCAST:
     case ir::ValueId::vPTRTOINT:
     case ir::ValueId::vINTTOPTR:
+    case ir::ValueId::vABS:
+    case ir::ValueId::vCTPOP:
+    case ir::ValueId::vCTLZ:
+    case ir::ValueId::vCTTZ:
       lower(dyn_cast<ir::UnaryInst>(ir_inst), ctx);
       break;
     case ir::ValueId::vADD:
@@ -443,6 +462,8 @@ void createMIRInst(ir::Instruction* ir_inst, LoweringContext& ctx) {
     case ir::ValueId::vUREM:
     case ir::ValueId::vSREM:
     case ir::ValueId::vFREM:
+    case ir::ValueId::vSMIN:
+    case ir::ValueId::vSMAX:
       lower(dyn_cast<ir::BinaryInst>(ir_inst), ctx);
       break;
     case ir::ValueId::vIEQ:
@@ -485,6 +506,9 @@ void createMIRInst(ir::Instruction* ir_inst, LoweringContext& ctx) {
     case ir::ValueId::vMEMSET:
       lower(dyn_cast<ir::MemsetInst>(ir_inst), ctx);
       break;
+    case ir::ValueId::vPREFETCH:
+      lower(dyn_cast<ir::PrefetchInst>(ir_inst), ctx);
+      break;
     case ir::ValueId::vPHI:
       break;
     // case ir::ValueId::vATOMICRMW:
@@ -547,6 +571,14 @@ void lower(ir::UnaryInst* ir_inst, LoweringContext& ctx) {
       case ir::ValueId::vPTRTOINT:
       case ir::ValueId::vINTTOPTR:
         return InstBitCast;
+      case ir::ValueId::vABS:
+        return InstAbs;
+      case ir::ValueId::vCTPOP:
+        return InstCPop;
+      case ir::ValueId::vCTLZ:
+        return InstClz;
+      case ir::ValueId::vCTTZ:
+        return InstCtz;
       default:
         assert(false && "not supported unary inst");
     }
@@ -661,6 +693,10 @@ void lower(ir::BinaryInst* ir_inst, LoweringContext& ctx) {
         return InstURem;
       case ir::ValueId::vSREM:
         return InstSRem;
+      case ir::ValueId::vSMIN:
+        return InstSMin;
+      case ir::ValueId::vSMAX:
+        return InstSMax;
       default:
         assert(false && "not supported binary inst");
     }
@@ -921,6 +957,24 @@ void lower(ir::MemsetInst* ir_inst, LoweringContext& ctx) {
   ctx.emitMIRInst(RISCV::JAL, {MIROperand::asReloc(ctx.memsetFunc)});
 }
 
+/*
+ * @brief: lower PrefetchInst
+ * @note:
+ *    IR: llvm.prefetch(ptr) [ValueId: vPREFETCH]
+ *    -> MIR: prefetch.r 0(ptr)      (Zicbop)
+ *         or lw zero, 0(ptr)        (no prefetch instructions: a load nobody waits for)
+ */
+void lower(ir::PrefetchInst* ir_inst, LoweringContext& ctx) {
+  const auto addr = ctx.map2operand(ir_inst->ptr());
+  const auto offset = MIROperand::asImm(0, OperandType::Int64);
+  if (ctx.mTarget.getScheduleModel().getMicroArchInfo().hasPrefetchInst) {
+    ctx.emitMIRInst(RISCV::PREFETCH_R, {offset, addr});
+  } else {
+    const auto zero = MIROperand::asISAReg(RISCV::X0, OperandType::Int32);
+    ctx.emitMIRInst(RISCV::LW, {zero, offset, addr});
+  }
+}
+
 /*
  * @brief: lower GetElementPtrInst for Pointer
  * @note:
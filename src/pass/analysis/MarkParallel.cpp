@@ -25,7 +25,8 @@ void MarkParallelContext::runOnLoop(Loop* lp) {
   auto lpDepInfo = dpctx->getLoopDependenceInfo(lp);
   bool isParallelConcerningArray = lpDepInfo->getIsParallel();
   auto defaultIdv = idvctx->getIndvar(lp);
-  if (isParallelConcerningArray == false) {
+  parctx->setNeedsVersioning(lp->header(), false);
+  if (isParallelConcerningArray == false and not lpDepInfo->getIsParallelWithChecks()) {
     std::cerr << "Loop " << lp->header()->name() << " is not parallel concerning array."
               << std::endl;
     parctx->setIsParallel(lp->header(), false);
@@ -64,7 +65,9 @@ void MarkParallelContext::runOnLoop(Loop* lp) {
   //         parctx->setPhi(phi,res->isAdd,res->isSub,res->isMul,res->mod);
   //     }
   // }
-  parctx->setIsParallel(lp->header(), true);
+  // 数组依赖只能由运行时检查排除: 先不并行, 由 LoopParallel 做版本化
+  parctx->setIsParallel(lp->header(), isParallelConcerningArray);
+  parctx->setNeedsVersioning(lp->header(), not isParallelConcerningArray);
   return;
 }
 
@@ -75,6 +78,8 @@ void MarkParallelContext::printParallelInfo(Function* func) {
     cerr << "Parallize Loop whose header is " << lp->header()->name() << " :";
     if (parctx->getIsParallel(lp->header())) {
       cerr << "YES";
+    } else if (parctx->getNeedsVersioning(lp->header())) {
+      cerr << "YES (runtime checks)";
     } else {
       cerr << "NO";
     }
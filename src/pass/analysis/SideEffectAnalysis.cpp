@@ -1,4 +1,6 @@
 #include "pass/analysis/sideEffectAnalysis.hpp"
+#include "support/DataFlow.hpp"
+#include "support/Hyperparameters.hpp"
 using namespace pass;
 
 static std::set<ir::Function*> worklist;
@@ -59,7 +61,8 @@ void SideEffectAnalysisContext::run(ir::Module* md, TopAnalysisInfoManager* tp)
         } else if (auto callInst = inst->dynCast<ir::CallInst>()) {
           auto calleeFunc = callInst->callee();
           if (not cgctx->isLib(calleeFunc)) continue;
-          if (calleeFunc->name() == "putarray") {
+          /* sysycMemcpy (loop idiom) reads its second argument like putarray */
+          if (calleeFunc->name() == "putarray" or calleeFunc->name() == "sysycMemcpy") {
             auto rarg = callInst->rargs().at(1);
             ptr = getBaseAddr(rarg->value());
             if (ptr == nullptr)
@@ -87,7 +90,9 @@ void SideEffectAnalysisContext::run(ir::Module* md, TopAnalysisInfoManager* tp)
               sectx->funcReadGlobals(func).insert(gv);
             }
           }
-          if (calleeFunc->name() == "getarray") {
+          /* and writes its first argument like getarray, as does sysycMemfill */
+          if (calleeFunc->name() == "getarray" or calleeFunc->name() == "sysycMemfill" or
+              calleeFunc->name() == "sysycMemcpy") {
             auto rarg = callInst->rargs().at(0);
             ptr = getBaseAddr(rarg->value());
             if (ptr == nullptr)
@@ -121,10 +126,7 @@ void SideEffectAnalysisContext::run(ir::Module* md, TopAnalysisInfoManager* tp)
   }
 
   // propagate based on callgraph
-  bool isChange = false;
-  do {
-    isChange = propogateSideEffect(md);
-  } while (isChange);
+  propogateSideEffect(md);
 
   sectx->setOn();
   // infoCheck(md);
@@ -165,82 +167,175 @@ ir::Value* SideEffectAnalysisContext::getBaseAddr(ir::Value* subAddr) {
   return nullptr;
 }
 
+namespace {
+/* what a function and its callees touch, pointer arguments of the function only */
+struct SideEffectFacts final {
+  std::set<ir::GlobalVariable*> reads, writes;
+  std::set<ir::Argument*> argReads, argWrites;
+  bool callLib = false, potential = false;
+
+  bool operator==(const SideEffectFacts& rhs) const {
+    return reads == rhs.reads and writes == rhs.writes and argReads == rhs.argReads and
+           argWrites == rhs.argWrites and callLib == rhs.callLib and potential == rhs.potential;
+  }
+};
+
+/* a pointer parameter of a callee and the base address a call passes to it */
+struct ArgBinding final {
+  ir::Argument* param;
+  ir::Value* base;  // a global or an argument of the caller
+};
+
+/* backward over the call graph: a caller merges the facts of its callees */
+struct SideEffectProblem final {
+  using Value = SideEffectFacts;
+  static constexpr auto direction = utils::DataFlowDirection::Backward;
+
+  std::vector<SideEffectFacts> direct;  // of the body of each function
+  std::vector<std::vector<ArgBinding>> bindings;
+
+  Value top() const { return {}; }
+  Value boundary() const { return {}; }
+  void meet(Value& into, const Value& from) const {
+    into.reads.insert(from.reads.begin(), from.reads.end());
+    into.writes.insert(from.writes.begin(), from.writes.end());
+    /* parameters of the callees, bound to the caller by transfer */
+    into.argReads.insert(from.argReads.begin(), from.argReads.end());
+    into.argWrites.insert(from.argWrites.begin(), from.argWrites.end());
+    into.callLib |= from.callLib;
+    into.potential |= from.potential;
+  }
+  bool transfer(utils::NodeIndex node, const Value& in, Value& out) const {
+    auto facts = direct[node];
+    facts.reads.insert(in.reads.begin(), in.reads.end());
+    facts.writes.insert(in.writes.begin(), in.writes.end());
+    facts.callLib |= in.callLib;
+    facts.potential |= in.potential;
+    for (auto [param, base] : bindings[node]) {
+      const bool read = in.argReads.count(param), write = in.argWrites.count(param);
+      if (auto gv = base->dynCast<ir::GlobalVariable>()) {
+        if (read) facts.reads.insert(gv);
+        if (write) facts.writes.insert(gv);
+      } else if (auto arg = base->dynCast<ir::Argument>()) {
+        if (read) facts.argReads.insert(arg);
+        if (write) facts.argWrites.insert(arg);
+      }
+    }
+    if (facts == out) return false;
+    out = std::move(facts);
+    return true;
+  }
+};
+}  // namespace
+
 bool SideEffectAnalysisContext::propogateSideEffect(ir::Module* md) {
-  bool isChange = false;
-  for (auto func : md->funcs()) {
-    // if (func->attribute().hasAttr(ir::FunctionAttribute::LoopBody |
-    // ir::FunctionAttribute::ParallelBody)) {
-    //     assert(false);
-    // }
-    // std::cerr << "propogateSideEffect: " << func->name() << std::endl;
-    // func->rename();
-    // func->print(std::cerr);
+  const auto& funcs = md->funcs();
+  std::unordered_map<ir::Function*, utils::NodeIndex> index;
+  for (auto func : funcs)
+    index.emplace(func, static_cast<utils::NodeIndex>(index.size()));
 
+  utils::Graph callees(funcs.size());
+  SideEffectProblem problem;
+  for (auto func : funcs) {
+    SideEffectFacts facts;
+    facts.reads = sectx->funcReadGlobals(func);
+    facts.writes = sectx->funcWriteGlobals(func);
+    for (auto arg : sectx->funcArgSet(func)) {
+      if (sectx->getArgRead(arg)) facts.argReads.insert(arg);
+      if (sectx->getArgWrite(arg)) facts.argWrites.insert(arg);
+    }
+    facts.potential = sectx->getPotentialSideEffect(func);
     for (auto calleeFunc : cgctx->callees(func)) {
-      // 对于所有当前函数调用的函数
-      if (calleeFunc == func) continue;  // 全局使用，其递归无影响
-      // 将被调用函数使用的全局变量添加到调用函数使用的全局变量中去
-      for (auto gv : sectx->funcReadGlobals(calleeFunc)) {
-        auto resPair = sectx->funcReadGlobals(func).insert(gv);
-        isChange = isChange or resPair.second;
-      }
-      for (auto gv : sectx->funcWriteGlobals(calleeFunc)) {
-        auto resPair = sectx->funcWriteGlobals(func).insert(gv);
-        isChange = isChange or resPair.second;
-      }
-      if (cgctx->isLib(calleeFunc) and not sectx->getIsCallLib(func)) {
-        sectx->setFuncIsCallLib(func, true);
-        isChange = true;
-      }
-      if (sectx->getIsCallLib(calleeFunc) and not sectx->getIsCallLib(func)) {
-        sectx->setFuncIsCallLib(func, true);
-        isChange = true;
-      }
-      if (sectx->getPotentialSideEffect(calleeFunc) and not sectx->getPotentialSideEffect(func)) {
-        sectx->setPotentialSideEffect(func, true);
-        isChange = true;
-      }
+      callees[index.at(func)].push_back(index.at(calleeFunc));
+      if (cgctx->isLib(calleeFunc)) facts.callLib = true;
     }
-    // calleeInst,探讨具体对于对应gv引起的修改
+    std::vector<ArgBinding> bindings;
     for (auto calleeInst : cgctx->calleeCallInsts(func)) {
-      auto calleeFunc = calleeInst->callee();
-      for (auto pointerArg : sectx->funcArgSet(calleeFunc)) {
-        // pointerArg->dumpAsOpernd(std::cerr);
-        // std::cerr<<std::endl;
-        auto pointerArgIdx = pointerArg->index();
-        auto pointerRArg = calleeInst->rargs().at(pointerArgIdx);
-        auto pointerRArgBaseAddr = getBaseAddr(pointerRArg->value());
-        if (pointerRArgBaseAddr == nullptr) {
-          if (not sectx->getPotentialSideEffect(func)) {
-            sectx->setPotentialSideEffect(func, true);
-            isChange = true;
-          }
-          continue;
+      for (auto pointerArg : sectx->funcArgSet(calleeInst->callee())) {
+        const auto pointerRArg = calleeInst->rargs().at(pointerArg->index());
+        const auto base = getBaseAddr(pointerRArg->value());
+        if (base == nullptr) {
+          facts.potential = true;
+        } else if (not base->dynCast<ir::AllocaInst>()) {
+          bindings.push_back({pointerArg, base});
         }
+      }
+    }
+    problem.direct.push_back(std::move(facts));
+    problem.bindings.push_back(std::move(bindings));
+  }
 
-        if (pointerRArgBaseAddr->dynCast<ir::AllocaInst>()) continue;
-        if (auto gv = pointerRArgBaseAddr->dynCast<ir::GlobalVariable>()) {
-          if (sectx->getArgRead(pointerArg)) {
-            auto resPair = sectx->funcReadGlobals(func).insert(gv);
-            isChange = isChange or resPair.second;
-          }
-          if (sectx->getArgWrite(pointerArg)) {
-            auto resPair = sectx->funcWriteGlobals(func).insert(gv);
-            isChange = isChange or resPair.second;
-          }
+  const auto main = md->mainFunction();
+  const auto result = utils::solveDataFlow(callees, main ? index.at(main) : 0, problem);
+  if (utils::VerifyDataFlow) {
+    /* -X dataflow.verify: the round-robin fixpoint this replaced, from the same direct facts */
+    auto facts = problem.direct;
+    std::set<ir::Argument*> argReads, argWrites;
+    for (auto& direct : facts) {
+      argReads.insert(direct.argReads.begin(), direct.argReads.end());
+      argWrites.insert(direct.argWrites.begin(), direct.argWrites.end());
+    }
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      const auto update = [&](bool& flag) {
+        changed = changed or not flag;
+        flag = true;
+      };
+      for (auto func : funcs) {
+        auto& cur = facts[index.at(func)];
+        for (auto calleeFunc : cgctx->callees(func)) {
+          if (calleeFunc == func) continue;
+          const auto& callee = facts[index.at(calleeFunc)];
+          for (auto gv : callee.reads)
+            changed = cur.reads.insert(gv).second or changed;
+          for (auto gv : callee.writes)
+            changed = cur.writes.insert(gv).second or changed;
+          if ((cgctx->isLib(calleeFunc) or callee.callLib) and not cur.callLib) update(cur.callLib);
+          if (callee.potential and not cur.potential) update(cur.potential);
         }
-        if (auto arg = pointerRArgBaseAddr->dynCast<ir::Argument>()) {
-          if (sectx->getArgRead(pointerArg)) {
-            if (not sectx->getArgRead(arg)) isChange = true;
-            sectx->setArgRead(arg, true);
-          }
-          if (sectx->getArgWrite(pointerArg)) {
-            if (not sectx->getArgWrite(arg)) isChange = true;
-            sectx->setArgWrite(arg, true);
+        for (auto calleeInst : cgctx->calleeCallInsts(func)) {
+          for (auto pointerArg : sectx->funcArgSet(calleeInst->callee())) {
+            const auto base = getBaseAddr(calleeInst->rargs().at(pointerArg->index())->value());
+            if (base == nullptr) {
+              if (not cur.potential) update(cur.potential);
+            } else if (auto gv = base->dynCast<ir::GlobalVariable>()) {
+              if (argReads.count(pointerArg)) changed = cur.reads.insert(gv).second or changed;
+              if (argWrites.count(pointerArg)) changed = cur.writes.insert(gv).second or changed;
+            } else if (auto arg = base->dynCast<ir::Argument>()) {
+              if (argReads.count(pointerArg)) changed = argReads.insert(arg).second or changed;
+              if (argWrites.count(pointerArg)) changed = argWrites.insert(arg).second or changed;
+            }
           }
         }
       }
     }
+    for (auto func : funcs) {
+      const auto& ref = facts[index.at(func)];
+      const auto& res = result.in[index.at(func)];
+      bool same = ref.reads == res.reads and ref.writes == res.writes and
+                  ref.callLib == res.callLib and ref.potential == res.potential;
+      for (auto arg : sectx->funcArgSet(func)) {
+        same = same and argReads.count(arg) == res.argReads.count(arg) and
+               argWrites.count(arg) == res.argWrites.count(arg);
+      }
+      if (same) continue;
+      std::cerr << "dataflow.verify: side effects of " << func->name() << " differ" << std::endl;
+      std::abort();
+    }
+  }
+  bool isChange = false;
+  for (auto func : funcs) {
+    const auto& facts = result.in[index.at(func)];
+    isChange = isChange or not(facts == problem.direct[index.at(func)]);
+    sectx->funcReadGlobals(func) = facts.reads;
+    sectx->funcWriteGlobals(func) = facts.writes;
+    for (auto arg : facts.argReads)
+      sectx->setArgRead(arg, true);
+    for (auto arg : facts.argWrites)
+      sectx->setArgWrite(arg, true);
+    sectx->setFuncIsCallLib(func, facts.callLib);
+    sectx->setPotentialSideEffect(func, facts.potential);
   }
   return isChange;
 }
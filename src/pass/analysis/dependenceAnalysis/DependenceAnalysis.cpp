@@ -49,6 +49,7 @@ void DependenceAnalysisContext::runOnLoop(Loop* lp) {
   // 分析所有的inst
   depInfoForLp->makeLoopDepInfo(lp, topmana);
   // 别名分析测试
+  // 可能别名且其中之一被写的基址对记为运行时检查 (LoopVersioning: 访问范围不重叠)
   bool isSame = false;
   for (auto setIter = depInfoForLp->getBaseAddrs().begin();
        setIter != depInfoForLp->getBaseAddrs().end(); setIter++) {
@@ -56,16 +57,16 @@ void DependenceAnalysisContext::runOnLoop(Loop* lp) {
       if (setIter2 == setIter) continue;
       if (isTwoBaseAddrPossiblySame(*setIter, *setIter2, func, cgctx, topmana)) {
         isSame = true;
-        break;
+        if (depInfoForLp->getIsBaseAddrWrite(*setIter) or
+            depInfoForLp->getIsBaseAddrWrite(*setIter2))
+          depInfoForLp->addAliasCheck(*setIter2, *setIter);
       }
     }
   }
 
+  depInfoForLp->setIsBaseAddrPossiblySame(isSame);
   if (isSame) {
-    depInfoForLp->setIsBaseAddrPossiblySame(isSame);
-    depInfoForLp->setIsParallel(false);
     std::cerr << "Alias!" << std::endl;
-    return;
   }
   // 为并行设计的依赖关系分析
   //  depInfoForLp->print(std::cerr);
@@ -105,6 +106,12 @@ void DependenceAnalysisContext::runOnLoop(Loop* lp) {
           auto gepidx1 = depInfoForLp->getGepIdx(gep1);
           auto gepidx2 = depInfoForLp->getGepIdx(gep2);
           assert(gepidx1->idxList.size() == gepidx2->idxList.size());
+          // a[b[i]] 与 a[b[i]]: b 严格递增时跨迭代不同
+          if (auto idxAddr = isTwoGepIdxSameIndirect(gepidx1, gepidx2, lp, defaultIdv)) {
+            depInfoForLp->addMonotonicCheck(idxAddr);
+            if (setIter2 == setIter) break;
+            continue;
+          }
           int depType = isTwoGepIdxPossiblySame(gepidx1, gepidx2, lp, defaultIdv);
           if ((depType & dCrossIterTotallyNotSame) != 0) {
             if (setIter2 == setIter) break;
@@ -125,7 +132,9 @@ void DependenceAnalysisContext::runOnLoop(Loop* lp) {
     return isParallel;
   };
   bool isParallel = checkParallel();
-  depInfoForLp->setIsParallel(isParallel);
+  depInfoForLp->setIsParallelWithChecks(isParallel);
+  depInfoForLp->setIsParallel(isParallel and not isSame and
+                              depInfoForLp->getMonotonicChecks().empty());
   // depInfoForLp->print(std::cerr);
 }
 
@@ -245,6 +254,46 @@ int DependenceAnalysisContext::isTwoGepIdxPossiblySame(GepIdx* gepidx1,
   return res;
 }
 
+// val 为 load b[i] (b 循环不变且循环内不写, i 为本层 idv) 时返回 b[i] 的地址
+GetElementPtrInst* DependenceAnalysisContext::getIndirectIdxAddr(Value* val,
+                                                                 Loop* lp,
+                                                                 IndVar* idv) {
+  auto load = val->dynCast<LoadInst>();
+  if (load == nullptr) return nullptr;
+  auto gep = load->ptr()->dynCast<GetElementPtrInst>();
+  if (gep == nullptr or gep->index() != idv->phiinst()) return nullptr;
+  if (not isSimplyLoopInvariant(lp, gep->value()) and not gep->value()->isa<GlobalVariable>())
+    return nullptr;
+  auto baseAddr = getBaseAddr(gep, topmana);
+  if (baseAddr == nullptr) return nullptr;
+  auto depInfoForLp = dpctx->getLoopDependenceInfo(lp);
+  if (depInfoForLp->getBaseAddrs().count(baseAddr) and depInfoForLp->getIsBaseAddrWrite(baseAddr))
+    return nullptr;
+  return gep;
+}
+
+// 两个子地址除间接下标 b[i] 外各维相同, 返回 b[i] 的地址; 否则返回 nullptr
+GetElementPtrInst* DependenceAnalysisContext::isTwoGepIdxSameIndirect(GepIdx* gepidx1,
+                                                                      GepIdx* gepidx2,
+                                                                      Loop* lp,
+                                                                      IndVar* idv) {
+  if (gepidx1 == nullptr or gepidx2 == nullptr or idv == nullptr) return nullptr;
+  GetElementPtrInst* idxAddr = nullptr;
+  for (size_t i = 0; i < gepidx1->idxList.size(); i++) {
+    auto val1 = gepidx1->idxList.at(i);
+    auto val2 = gepidx2->idxList.at(i);
+    auto addr1 = val1 ? getIndirectIdxAddr(val1, lp, idv) : nullptr;
+    auto addr2 = val2 ? getIndirectIdxAddr(val2, lp, idv) : nullptr;
+    if (addr1 and addr2) {
+      if (addr1->value() != addr2->value()) return nullptr;
+      if (idxAddr == nullptr) idxAddr = addr1;
+    } else if (val1 != val2) {
+      return nullptr;
+    }
+  }
+  return idxAddr;
+}
+
 int DependenceAnalysisContext::isTwoIdxPossiblySame(Value* val1,
                                                     Value* val2,
                                                     IdxType type1,
@@ -6,20 +6,25 @@ namespace pass {
 void IRCheck::run(ir::Module* ctx, TopAnalysisInfoManager* tp) {
   const auto& config = sysy::Config::getInstance();
   const bool debug = config.logLevel >= sysy::LogLevel::DEBUG;
-  ctx->rename();
+  const bool thorough = config.verifyLevel >= sysy::VerifyLevel::Thorough;
   bool isPass = true;
   for (auto func : ctx->funcs()) {
     if (func->isOnlyDeclare()) continue;
+    if (not func->changed()) continue;
+    func->rename();
     if (debug) cerr << "Testing function " << func->name() << " ..." << endl;
 
-    isPass &= runDefUseTest(func);
     isPass &= runCFGTest(func);
-    isPass &= runPhiTest(func);
+    isPass &= runPhiTest(func, thorough);
     isPass &= checkFuncInfo(func);
-    isPass &= checkAllocaOnlyInEntry(func);
     isPass &= checkOnlyOneExit(func);
-    isPass &= checkParentRelationship(func);
-    isPass &= checkOperands(func);
+    isPass &= checkParentRelationship(func, thorough);
+    if (thorough) {
+      isPass &= runDefUseTest(func);
+      isPass &= checkAllocaOnlyInEntry(func);
+      isPass &= checkOperands(func);
+    }
+    func->clearChanged();
   }
   if (not isPass) assert(false && "didn't pass irCheck!");
 }
@@ -72,6 +77,7 @@ bool IRCheck::checkDefUse(ir::Value* val) {
 bool IRCheck::runDefUseTest(ir::Function* func) {
   bool isPass = true;
   for (auto bb : func->blocks()) {
+    if (not bb->changed()) continue;
     bool bbOK = checkDefUse(bb);
     for (auto inst : bb->insts()) {
       bbOK = bbOK and checkDefUse(inst);
@@ -113,9 +119,10 @@ bool IRCheck::checkPhi(ir::PhiInst* phi) {
   return isPass;
 }
 
-bool IRCheck::runPhiTest(ir::Function* func) {
+bool IRCheck::runPhiTest(ir::Function* func, bool thorough) {
   bool isPass = true;
   for (auto bb : func->blocks()) {
+    if (not bb->changed()) continue;
     int lim = bb->phi_insts().size();
     auto instIter = bb->insts().begin();
     auto phiIter = bb->phi_insts().begin();
@@ -125,7 +132,7 @@ bool IRCheck::runPhiTest(ir::Function* func) {
         cerr << "In BB" << bb->name() << ", we got a phiinst list error!" << endl;
         isPass = false;
       }
-      isPass = isPass and checkPhi(dyn_cast<ir::PhiInst>(*phiIter));
+      if (thorough) isPass = isPass and checkPhi(dyn_cast<ir::PhiInst>(*phiIter));
       phiIter++;
       instIter++;
     }
@@ -134,9 +141,10 @@ bool IRCheck::runPhiTest(ir::Function* func) {
       isPass = false;
     }
   }
-  // check incoming block and preblock
+  if (not thorough) return isPass;
+  // check incoming block and preblock, in every block: an edge edit elsewhere can break it
   for (auto block : func->blocks()) {
-    for (auto inst : block->insts()) {
+    for (auto inst : block->phi_insts()) {
       if (auto phi = inst->dynCast<ir::PhiInst>()) {
         for (auto [pre, val] : phi->incomings()) {
           const auto iter = std::find(pre->next_blocks().begin(), pre->next_blocks().end(), block);
@@ -157,8 +165,11 @@ bool IRCheck::runPhiTest(ir::Function* func) {
 
 bool IRCheck::runCFGTest(ir::Function* func) {
   std::unordered_map<ir::BasicBlock*, int> bbPreSize;
-  for (auto bb : func->blocks())
+  std::unordered_set<ir::BasicBlock*> funcBlocks;
+  for (auto bb : func->blocks()) {
     bbPreSize.emplace(bb, 0);
+    funcBlocks.insert(bb);
+  }
   bool isPass = true;
   // check succ
   for (auto bb : func->blocks()) {
@@ -201,17 +212,14 @@ bool IRCheck::runCFGTest(ir::Function* func) {
     }
   }
   for (auto block : func->blocks()) {
-    if (not block->verify(std::cerr)) {
+    if (block->changed() and not block->verify(std::cerr)) {
       std::cerr << "block->verify() failed" << std::endl;
     }
     const auto backInst = block->insts().back();
     if (auto brInst = backInst->dynCast<ir::BranchInst>()) {
       if (brInst->is_cond()) {
         // block -> block.iftrue / block.iffalse
-        auto trueIter = std::find(func->blocks().begin(), func->blocks().end(), brInst->iftrue());
-        auto falseIter = std::find(func->blocks().begin(), func->blocks().end(), brInst->iffalse());
-
-        if (trueIter == func->blocks().end() and falseIter == func->blocks().end()) {
+        if (not funcBlocks.count(brInst->iftrue()) and not funcBlocks.count(brInst->iffalse())) {
           std::cerr << "BranchInst's succ block not in function!" << std::endl;
           std::cerr << "BranchInst: ";
           brInst->print(std::cerr);
@@ -219,8 +227,7 @@ bool IRCheck::runCFGTest(ir::Function* func) {
         }
       } else {
         // block -> block.next
-        auto nextIter = std::find(func->blocks().begin(), func->blocks().end(), brInst->dest());
-        if (nextIter == func->blocks().end()) {
+        if (not funcBlocks.count(brInst->dest())) {
           std::cerr << "BranchInst's dest block not in function!" << std::endl;
           std::cerr << "BranchInst: ";
           brInst->print(std::cerr);
@@ -250,6 +257,7 @@ bool IRCheck::checkAllocaOnlyInEntry(ir::Function* func) {
   bool isPass = true;
 
   for (auto bb : func->blocks()) {
+    if (not bb->changed()) continue;
     for (auto inst : bb->insts()) {
       if (inst->isa<ir::AllocaInst>() and bb != func->entry()) {
         isPass = false;
@@ -264,6 +272,11 @@ bool IRCheck::checkOnlyOneExit(ir::Function* func) {
   bool isPass = true;
   int exitNum = 0;
   for (auto bb : func->blocks()) {
+    // a return can only hide in the middle of a block that changed
+    if (not bb->changed()) {
+      if (bb->insts().back()->isa<ir::ReturnInst>()) exitNum++;
+      continue;
+    }
     for (auto inst : bb->insts()) {
       if (inst->isa<ir::ReturnInst>()) {
         if (bb != func->exit()) {
@@ -288,7 +301,7 @@ bool IRCheck::checkOnlyOneExit(ir::Function* func) {
   return isPass;
 }
 
-bool IRCheck::checkParentRelationship(ir::Function* func) {
+bool IRCheck::checkParentRelationship(ir::Function* func, bool thorough) {
   bool isPass = true;
   for (auto block : func->blocks()) {
     if (block->function() != func) {
@@ -302,6 +315,7 @@ bool IRCheck::checkParentRelationship(ir::Function* func) {
   }
 
   for (auto block : func->blocks()) {
+    if (not block->changed()) continue;
     for (auto inst : block->insts()) {
       if (inst->block() != block) {
         std::cerr << "inst father wrong!" << std::endl;
@@ -316,7 +330,9 @@ bool IRCheck::checkParentRelationship(ir::Function* func) {
     }
   }
 
+  if (not thorough) return isPass;
   for (auto block : func->blocks()) {
+    if (not block->changed()) continue;
     for (auto inst : block->insts()) {
       for (auto operandUse : inst->operands()) {
         auto operand = operandUse->value();
@@ -354,6 +370,7 @@ bool IRCheck::checkParentRelationship(ir::Function* func) {
 bool IRCheck::checkOperands(ir::Function* func) {
   bool isPass = true;
   for (auto block : func->blocks()) {
+    if (not block->changed()) continue;
     for (auto inst : block->insts()) {
       for (auto use : inst->operands()) {
         if (use == nullptr) {
@@ -134,6 +134,7 @@ bool SimplifyCFG::MergeBlock(ir::Function* func) {
       // 因为这些语句没有消失,不能使用一般的delete接口直接删除use
       mergeBlock->insts().clear();
       func->blocks().remove(mergeBlock);
+      func->markChanged();
       mergeBlock = getMergeBlock(bb);
     }
   }
@@ -0,0 +1,299 @@
+#include "pass/optimize/TaskParallel.hpp"
+#include "pass/analysis/ControlFlowGraph.hpp"
+#include "pass/optimize/Utils/BlockUtils.hpp"
+#include "support/Hyperparameters.hpp"
+#include <algorithm>
+#include <unordered_set>
+
+using namespace ir;
+namespace pass {
+/* must stay small: every spawned call keeps a payload in its frame until the join */
+static utils::Parameter<uint32_t> TaskDepth{
+  "parallel.task-depth", 4,
+  "recursion depth below which independent sibling self calls run as tasks, 0: off"};
+
+/*
+ * payload of a task, by 8-byte slots: [0] depth of the spawned call (i32),
+ * [1 + i] argument i of f, [1 + args] result of f
+ */
+static size_t argumentOffset(size_t idx) {
+  return 8 + 8 * idx;
+}
+static Value* payloadSlot(IRBuilder& builder, Value* base, size_t offset, Type* type) {
+  const auto ptr = builder.makeBinary(BinaryOp::ADD, base, ConstantInteger::gen_i64(offset));
+  return builder.makeUnary(ValueId::vINTTOPTR, ptr, Type::TypePointer(type));
+}
+
+/**
+ * void parallelInvoke2(void (*func0)(void* payload), void* payload0,
+ *                      void (*func1)(void* payload), void* payload1);
+ *
+ * func0(payload0) and func1(payload1) as two tasks of the worker team, joined
+ * before returning
+ */
+static Function* lookupParallelInvoke2(Module* module) {
+  if (auto func = module->findFunction("parallelInvoke2")) {
+    return func;
+  }
+  const auto voidType = Type::void_type();
+  const auto payloadType = Type::TypePointer(Type::TypeInt32());
+  const auto taskType = FunctionType::gen(voidType, {payloadType});
+  const auto invokeType =
+    FunctionType::gen(voidType, {taskType, payloadType, taskType, payloadType});
+
+  auto parallelInvoke = module->addFunction(invokeType, "parallelInvoke2");
+  parallelInvoke->attribute().addAttr(FunctionAttribute::Builtin);
+  return parallelInvoke;
+}
+
+/* base of a pointer passed to f: global, alloca or argument of the caller, nullptr: unknown */
+static Value* baseAddrOf(Value* ptr) {
+  while (auto gep = ptr->dynCast<GetElementPtrInst>())
+    ptr = gep->value();
+  if (ptr->isa<AllocaInst>() or ptr->isa<GlobalVariable>() or ptr->isa<Argument>()) return ptr;
+  return nullptr;
+}
+
+bool TaskParallel::isCandidate(Function* func, SideEffectInfo* sideEffect) {
+  if (func->isOnlyDeclare() or func->name() == "main") return false;
+  if (func->attribute().hasAttr(FunctionAttribute::Builtin | FunctionAttribute::LoopBody |
+                                FunctionAttribute::ParallelBody))
+    return false;
+  if (sideEffect->getIsLIb(func) or sideEffect->getIsCallLib(func)) return false;
+  if (sideEffect->getPotentialSideEffect(func)) return false;
+  return sideEffect->funcWriteGlobals(func).empty();
+}
+
+/*
+ * first ... second in one block: nothing between them touches memory or uses first,
+ * so first can run next to second; neither call writes memory the other accesses.
+ */
+bool TaskParallel::isIndependentPair(Function* func,
+                                     CallInst* first,
+                                     CallInst* second,
+                                     SideEffectInfo* sideEffect) {
+  const auto& insts = first->block()->insts();
+  for (auto iter = std::next(std::find(insts.begin(), insts.end(), first)); *iter != second;
+       ++iter) {
+    const auto inst = *iter;
+    if (inst->isa<LoadInst>() or inst->isa<StoreInst>() or inst->isa<CallInst>() or
+        inst->isa<AtomicrmwInst>() or inst->isa<AllocaInst>())
+      return false;
+    for (auto use : inst->operands())
+      if (use->value() == first) return false;
+  }
+  for (auto use : second->rargs())
+    if (use->value() == first) return false;
+
+  const auto& readGlobals = sideEffect->funcReadGlobals(func);
+  const CallInst* calls[2] = {first, second};
+  /* bases of the pointer arguments read/written by each call, nullptr: unknown base */
+  std::unordered_set<Value*> read[2], written[2];
+  for (size_t k = 0; k < 2; ++k) {
+    for (size_t idx = 0; idx < func->args().size(); ++idx) {
+      const auto arg = func->arg_i(idx);
+      if (not arg->type()->isPointer()) continue;
+      const bool reads = sideEffect->getArgRead(arg), writes = sideEffect->getArgWrite(arg);
+      if (not reads and not writes) continue;
+      const auto base = baseAddrOf(calls[k]->rargs().at(idx)->value());
+      if (writes) {
+        /* ranges of one array passed down are not told apart */
+        if (base == nullptr or base->isa<Argument>()) return false;
+        if (auto global = base->dynCast<GlobalVariable>(); global and readGlobals.count(global))
+          return false;
+        written[k].insert(base);
+      }
+      if (reads) read[k].insert(base);
+    }
+  }
+  for (size_t k = 0; k < 2; ++k) {
+    const auto& other = read[1 - k];
+    if (not written[k].empty() and other.count(nullptr)) return false;
+    for (auto base : written[k])
+      if (written[1 - k].count(base) or other.count(base)) return false;
+  }
+  return true;
+}
+
+std::vector<TaskParallel::CallPair> TaskParallel::findPairs(Function* func,
+                                                            SideEffectInfo* sideEffect) {
+  std::vector<CallPair> pairs;
+  for (auto block : func->blocks()) {
+    CallInst* first = nullptr;
+    for (auto inst : block->insts()) {
+      const auto call = inst->dynCast<CallInst>();
+      if (call == nullptr or call->callee() != func) continue;
+      if (first and isIndependentPair(func, first, call, sideEffect)) {
+        pairs.push_back(CallPair{first, call});
+        first = nullptr;
+      } else {
+        first = call;
+      }
+    }
+  }
+  return pairs;
+}
+
+/* void f_task(payload): result = f(args..., depth) */
+Function* TaskParallel::buildTask(Function* func, ArrayType* payloadType) {
+  const auto argCount = func->args().size() - 1;  // without depth
+  const auto taskType = FunctionType::gen(Type::void_type(), {Type::TypePointer(payloadType)});
+  auto task = func->module()->addFunction(taskType, func->name() + "_task");
+  task->attribute().addAttr(FunctionAttribute::ParallelBody);
+  const auto payload = task->new_arg(Type::TypePointer(payloadType), "payload");
+
+  const auto entry = task->newEntry("task_entry");
+  const auto exit = task->newExit("task_exit");
+  IRBuilder builder;
+  builder.set_pos(entry, entry->insts().end());
+  const auto base = builder.makeUnary(ValueId::vPTRTOINT, payload, Type::TypeInt64());
+  std::vector<Value*> args;
+  for (size_t idx = 0; idx < argCount; ++idx) {
+    const auto type = func->arg_i(idx)->type();
+    args.push_back(builder.makeLoad(payloadSlot(builder, base, argumentOffset(idx), type)));
+  }
+  args.push_back(builder.makeLoad(payloadSlot(builder, base, 0, Type::TypeInt32())));
+  const auto call = builder.makeInst<CallInst>(func, args);
+  if (not func->retType()->isVoid()) {
+    builder.makeInst<StoreInst>(
+      call, payloadSlot(builder, base, argumentOffset(argCount), func->retType()));
+  }
+  builder.makeInst<BranchInst>(exit);
+  builder.set_pos(exit, exit->insts().end());
+  builder.makeInst<ReturnInst>();
+  return task;
+}
+
+/*
+ * block: ... first second rest
+ * -> block: ... br depth < cutoff, spawn, serial
+ *    spawn: payloads, parallelInvoke2, results    serial: first second
+ *    join: phi of the results, rest
+ */
+void TaskParallel::spawnPair(Function* func,
+                             const CallPair& pair,
+                             Function* task,
+                             ArrayType* payloadType,
+                             uint32_t cutoff) {
+  const auto block = pair.first->block();
+  auto& insts = block->insts();
+  block->move_inst(pair.first);
+  block->emplace_inst(std::find(insts.begin(), insts.end(), pair.second), pair.first);
+
+  const auto serial = func->newBlock();
+  serial->setComment("task serial");
+  const auto spawn = func->newBlock();
+  spawn->setComment("task spawn");
+  const auto join = func->newBlock();
+  join->setComment("task join");
+  for (auto iter = std::find(insts.begin(), insts.end(), pair.first); iter != insts.end();) {
+    const auto inst = *iter;
+    iter = insts.erase(iter);
+    (inst == pair.first or inst == pair.second ? serial : join)->emplace_back_inst(inst);
+  }
+  if (auto br = join->terminator()->dynCast<BranchInst>()) {
+    fixPhiIncomingBlock(br->is_cond() ? br->iftrue() : br->dest(), block, join);
+    if (br->is_cond()) fixPhiIncomingBlock(br->iffalse(), block, join);
+  }
+  if (func->exit() == block) func->setExit(join);
+
+  IRBuilder builder;
+  builder.set_pos(block, insts.end());
+  const auto depth = func->args().back();
+  const auto limit = ConstantInteger::gen_i32(static_cast<int32_t>(cutoff));
+  const auto inCutoff = builder.makeInst<ICmpInst>(vISLT, depth, limit);
+  builder.makeInst<BranchInst>(inCutoff, spawn, serial);
+  builder.set_pos(serial, serial->insts().end());
+  builder.makeInst<BranchInst>(join);
+
+  builder.set_pos(spawn, spawn->insts().end());
+  const auto argCount = func->args().size() - 1;
+  std::vector<Value*> invokeArgs;
+  std::vector<Value*> bases;
+  for (auto call : {pair.first, pair.second}) {
+    const auto payload = builder.makeAlloca(payloadType);
+    const auto base = builder.makeUnary(ValueId::vPTRTOINT, payload, Type::TypeInt64());
+    const auto& rargs = call->rargs();
+    for (size_t idx = 0; idx < argCount; ++idx) {
+      const auto value = rargs.at(idx)->value();
+      builder.makeInst<StoreInst>(value,
+                                  payloadSlot(builder, base, argumentOffset(idx), value->type()));
+    }
+    builder.makeInst<StoreInst>(rargs.back()->value(),
+                                payloadSlot(builder, base, 0, Type::TypeInt32()));
+    invokeArgs.insert(invokeArgs.end(), {task, payload});
+    bases.push_back(base);
+  }
+  builder.makeInst<CallInst>(lookupParallelInvoke2(func->module()), invokeArgs);
+
+  const auto retType = func->retType();
+  size_t idx = 0;
+  for (auto call : {pair.first, pair.second}) {
+    const auto base = bases.at(idx++);
+    if (retType->isVoid() or call->uses().empty()) continue;
+    const auto resultPtr = payloadSlot(builder, base, argumentOffset(argCount), retType);
+    const auto result = builder.makeLoad(resultPtr);
+    const auto phi = utils::make<PhiInst>(nullptr, retType);
+    join->emplace_first_inst(phi);
+    call->replaceAllUseWith(phi);
+    phi->addIncoming(call, serial);
+    phi->addIncoming(result, spawn);
+  }
+  builder.makeInst<BranchInst>(join);
+}
+
+void TaskParallel::run(Module* module, TopAnalysisInfoManager* tp) {
+  const uint32_t cutoff = TaskDepth;
+  if (cutoff == 0) return;
+  /* analysis first: the rewrite changes the signatures of the callees */
+  const auto sideEffect = tp->getSideEffectInfo();
+  std::vector<std::pair<Function*, std::vector<CallPair>>> candidates;
+  for (auto func : module->funcs()) {
+    if (not isCandidate(func, sideEffect)) continue;
+    auto pairs = findPairs(func, sideEffect);
+    if (not pairs.empty()) candidates.emplace_back(func, std::move(pairs));
+  }
+  if (candidates.empty()) return;
+
+  std::unordered_map<Function*, std::vector<CallInst*>> callSites;
+  for (auto func : module->funcs()) {
+    for (auto block : func->blocks()) {
+      for (auto inst : block->insts()) {
+        if (auto call = inst->dynCast<CallInst>()) callSites[call->callee()].push_back(call);
+      }
+    }
+  }
+  for (auto& [func, pairs] : candidates) {
+    const auto argCount = func->args().size();
+    const auto depth = func->new_arg(Type::TypeInt32(), "depth");
+    func->updateTypeFromArgs();
+    /* external callers start at depth 0, self calls go one level deeper */
+    for (auto call : callSites[func]) {
+      if (call->block()->function() != func) {
+        call->addOperand(ConstantInteger::gen_i32(0));
+        continue;
+      }
+      IRBuilder builder;
+      auto& insts = call->block()->insts();
+      builder.set_pos(call->block(), std::find(insts.begin(), insts.end(), call));
+      call->addOperand(builder.makeBinary(BinaryOp::ADD, depth, ConstantInteger::gen_i32(1)));
+    }
+    const auto words = (argumentOffset(argCount) + 8) / 4;
+    const auto payloadType = ArrayType::gen(Type::TypeInt32(), {words}, words);
+    const auto task = buildTask(func, payloadType);
+    for (auto& pair : pairs)
+      spawnPair(func, pair, task, payloadType, cutoff);
+    fixAllocaInEntry(*func);
+#ifdef DEBUG
+    std::cerr << "task parallel: " << func->name() << ", " << pairs.size() << " spawned pairs"
+              << std::endl;
+#endif
+    CFGAnalysisHHW().run(func, tp);
+    CFGAnalysisHHW().run(task, tp);
+    blockSortDFS(*func, tp);
+    tp->CFGChange(func);
+  }
+  tp->CallChange();
+}
+
+}  // namespace pass
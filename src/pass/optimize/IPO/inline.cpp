@@ -45,6 +45,7 @@ void InlineContext::callinline(ir::CallInst* call) {
       retBB->emplace_back_inst(inst);
       it = nowBB->insts().erase(it);
     }
+    nowBB->markChanged();
   }
 
   // 将nowBB的后继变为retBB的后继
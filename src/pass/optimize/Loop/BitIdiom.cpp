@@ -0,0 +1,350 @@
+#include "pass/optimize/Loop/BitIdiom.hpp"
+#include <algorithm>
+#include <optional>
+
+using namespace ir;
+namespace pass {
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+static std::optional<int32_t> constantOf(Value* val) {
+  const auto constant = val->dynCast<ConstantInteger>();
+  if (constant == nullptr or not constant->type()->isInt32()) return std::nullopt;
+  return constant->i32();
+}
+
+static bool isBinary(Value* val, ValueId vid, Value* lhs, int32_t rhs) {
+  const auto binary = val->dynCast<BinaryInst>();
+  return binary and binary->valueId() == vid and binary->lValue() == lhs and
+         constantOf(binary->rValue()) == rhs;
+}
+
+namespace {
+/* icmp with a constant operand moved to the right */
+struct Compare final {
+  ValueId pred;
+  Value* lhs;
+  Value* rhs;
+
+  explicit Compare(ICmpInst* cmp) : pred(cmp->valueId()), lhs(cmp->lhs()), rhs(cmp->rhs()) {
+    if (not constantOf(lhs) or constantOf(rhs)) return;
+    std::swap(lhs, rhs);
+    if (pred == vISLT) pred = vISGT;
+    else if (pred == vISGT) pred = vISLT;
+    else if (pred == vISLE) pred = vISGE;
+    else if (pred == vISGE) pred = vISLE;
+  }
+  bool isLess() const { return pred == vISLT or pred == vISLE; }
+  bool isGreater() const { return pred == vISGT or pred == vISGE; }
+};
+
+/* x from x0 by x /= 2 until the header test fails */
+struct BitLoop final {
+  PhiInst* x;
+  bool trailing;      // while (x % 2 == 0), otherwise while (x > bound)
+  int32_t bound = 0;  // 0 or 1
+};
+
+/* c from c0 by c += step every iteration, or only on those with x odd */
+struct Counter final {
+  PhiInst* phi;
+  int32_t step;
+  bool oddOnly;
+};
+}  // namespace
+
+/* the header branch is the only exit, taken when its condition fails */
+static BranchInst* exitBranch(Loop* loop) {
+  if (not loop->subLoops().empty() or loop->exits().size() != 1) return nullptr;
+  if (loop->getLoopPreheader() == nullptr or loop->getLoopLatch() == nullptr) return nullptr;
+  const auto br = loop->header()->insts().back()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond()) return nullptr;
+  if (not loop->contains(br->iftrue()) or loop->contains(br->iffalse())) return nullptr;
+  for (auto block : loop->blocks()) {
+    if (block == loop->header()) continue;
+    for (auto next : block->next_blocks()) {
+      if (not loop->contains(next)) return nullptr;
+    }
+  }
+  return br;
+}
+
+static std::optional<BitLoop> matchControl(Loop* loop, BranchInst* br) {
+  const auto cmp = br->cond()->dynCast<ICmpInst>();
+  if (cmp == nullptr or cmp->block() != loop->header()) return std::nullopt;
+  const Compare compare{cmp};
+  const auto rhs = constantOf(compare.rhs);
+  if (not rhs) return std::nullopt;
+
+  BitLoop bitLoop{nullptr, false};
+  Value* x = compare.lhs;
+  if (compare.pred == vIEQ and *rhs == 0) {
+    const auto parity = x->dynCast<BinaryInst>();
+    if (parity == nullptr or not isBinary(parity, vSREM, parity->lValue(), 2))
+      return std::nullopt;
+    x = parity->lValue();
+    bitLoop.trailing = true;
+  } else if (compare.pred == vISGT or compare.pred == vISGE) {
+    bitLoop.bound = compare.pred == vISGT ? *rhs : *rhs - 1;
+    if (bitLoop.bound != 0 and bitLoop.bound != 1) return std::nullopt;
+  } else {
+    return std::nullopt;
+  }
+
+  bitLoop.x = x->dynCast<PhiInst>();
+  if (bitLoop.x == nullptr or bitLoop.x->block() != loop->header()) return std::nullopt;
+  if (not bitLoop.x->type()->isInt32()) return std::nullopt;
+  const auto next = bitLoop.x->getvalfromBB(loop->getLoopLatch());
+  if (not isBinary(next, vSDIV, bitLoop.x, 2)) return std::nullopt;
+  return bitLoop;
+}
+
+/* c + s or c - s */
+static std::optional<int32_t> stepOf(Value* val, PhiInst* phi) {
+  const auto binary = val->dynCast<BinaryInst>();
+  if (binary == nullptr) return std::nullopt;
+  if (binary->valueId() == vADD) {
+    if (binary->lValue() == phi) return constantOf(binary->rValue());
+    if (binary->rValue() == phi) return constantOf(binary->lValue());
+  } else if (binary->valueId() == vSUB and binary->lValue() == phi) {
+    if (auto step = constantOf(binary->rValue())) return -*step;
+  }
+  return std::nullopt;
+}
+
+/* whether cond, a test of x % 2 with x > 0, holds exactly when x is odd */
+static std::optional<bool> isOddTest(Value* cond, PhiInst* x) {
+  const auto cmp = cond->dynCast<ICmpInst>();
+  if (cmp == nullptr) return std::nullopt;
+  const Compare compare{cmp};
+  const auto rhs = constantOf(compare.rhs);
+  if (not rhs or not isBinary(compare.lhs, vSREM, x, 2)) return std::nullopt;
+  if (compare.pred == vIEQ and (*rhs == 0 or *rhs == 1)) return *rhs == 1;
+  if (compare.pred == vINE and (*rhs == 0 or *rhs == 1)) return *rhs == 0;
+  return std::nullopt;
+}
+
+static std::optional<Counter> matchCounter(Loop* loop, PhiInst* phi, const BitLoop& bitLoop) {
+  if (not phi->type()->isInt32()) return std::nullopt;
+  const auto next = phi->getvalfromBB(loop->getLoopLatch());
+  if (auto step = stepOf(next, phi)) return Counter{phi, *step, false};
+  if (bitLoop.trailing) return std::nullopt;
+
+  /* c += x % 2 */
+  if (const auto add = next->dynCast<BinaryInst>(); add and add->valueId() == vADD) {
+    const auto lhs = add->lValue(), rhs = add->rValue();
+    if ((lhs == phi and isBinary(rhs, vSREM, bitLoop.x, 2)) or
+        (rhs == phi and isBinary(lhs, vSREM, bitLoop.x, 2)))
+      return Counter{phi, 1, true};
+  }
+
+  /* if (x % 2 == 1) c = c + s: the increment is merged on the edge taken for odd x */
+  const auto merge = next->dynCast<PhiInst>();
+  if (merge == nullptr or merge->getsize() != 2 or not isDefinedIn(loop, merge))
+    return std::nullopt;
+  for (size_t k = 0; k < 2; k++) {
+    const auto step = stepOf(merge->getValue(k), phi);
+    if (not step or merge->getValue(1 - k) != phi) continue;
+    const auto arm = merge->getBlock(k), other = merge->getBlock(1 - k);
+    if (arm->pre_blocks().size() != 1 or arm->next_blocks().size() != 1) return std::nullopt;
+    const auto branchBlock = arm->pre_blocks().front();
+    if (other != branchBlock) {
+      if (other->pre_blocks().size() != 1 or other->next_blocks().size() != 1 or
+          other->pre_blocks().front() != branchBlock)
+        return std::nullopt;
+    }
+    const auto br = branchBlock->terminator()->dynCast<BranchInst>();
+    if (br == nullptr or not br->is_cond()) return std::nullopt;
+    const auto oddOnTrue = isOddTest(br->cond(), bitLoop.x);
+    if (oddOnTrue and *oddOnTrue == (br->iftrue() == arm)) return Counter{phi, *step, true};
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+static void replaceOutsideUses(Loop* loop, Value* val, Value* res) {
+  std::vector<Use*> outside;
+  for (auto use : val->uses()) {
+    if (not loop->contains(use->user()->as<Instruction>()->block())) outside.push_back(use);
+  }
+  for (auto use : outside)
+    use->user()->setOperand(use->index(), res);
+}
+
+/* computes the results of a matching loop in its preheader */
+static void rewriteLoop(Loop* loop) {
+  const auto br = exitBranch(loop);
+  if (br == nullptr) return;
+  const auto bitLoop = matchControl(loop, br);
+  if (not bitLoop) return;
+
+  bool pure = true;
+  std::vector<PhiInst*> results;
+  for (auto block : loop->blocks()) {
+    for (auto inst : block->insts()) {
+      pure &= inst->isa<BinaryInst>() or inst->isa<UnaryInst>() or inst->isa<ICmpInst>() or
+              inst->isa<PhiInst>() or inst->isa<BranchInst>();
+      for (auto use : inst->uses()) {
+        if (loop->contains(use->user()->as<Instruction>()->block())) continue;
+        const auto phi = inst->dynCast<PhiInst>();
+        if (phi and phi->block() == loop->header()) {
+          if (std::find(results.begin(), results.end(), phi) == results.end())
+            results.push_back(phi);
+        } else {
+          pure = false;
+        }
+      }
+    }
+  }
+  if (not pure or results.empty()) return;
+
+  std::vector<Counter> counters;
+  bool keepsX = false;
+  for (auto phi : results) {
+    if (phi == bitLoop->x) {
+      if (bitLoop->trailing) return;
+      keepsX = true;
+    } else if (auto counter = matchCounter(loop, phi, *bitLoop)) {
+      counters.push_back(*counter);
+    } else {
+      return;
+    }
+  }
+
+  const auto preHeader = loop->getLoopPreheader();
+  const auto i32 = Type::TypeInt32();
+  const auto bound = ConstantInteger::gen_i32(bitLoop->bound);
+  const auto x0 = bitLoop->x->getvalfromBB(preHeader);
+  IRBuilder builder;
+  builder.set_pos(preHeader, std::prev(preHeader->insts().end()));
+
+  Value* clamped = nullptr;
+  Value* iterations = nullptr;
+  Value* oddIterations = nullptr;
+  const auto countOf = [&](bool oddOnly) -> Value* {
+    if (not bitLoop->trailing and clamped == nullptr)
+      clamped = builder.makeInst<BinaryInst>(vSMAX, i32, x0, bound);
+    if (oddOnly) {
+      if (oddIterations == nullptr) {
+        oddIterations = builder.makeUnary(vCTPOP, clamped);
+        if (bitLoop->bound)
+          oddIterations = builder.makeBinary(BinaryOp::SUB, oddIterations, bound);
+      }
+      return oddIterations;
+    }
+    if (iterations == nullptr) {
+      if (bitLoop->trailing) {
+        /* x0 == 0 loops forever in the source, cttz(0) = 32 ends it */
+        iterations = builder.makeUnary(vCTTZ, x0);
+      } else {
+        iterations = builder.makeBinary(BinaryOp::SUB,
+                                        ConstantInteger::gen_i32(32 - bitLoop->bound),
+                                        builder.makeUnary(vCTLZ, clamped));
+      }
+    }
+    return iterations;
+  };
+
+  for (auto& [phi, step, oddOnly] : counters) {
+    Value* res = countOf(oddOnly);
+    if (step != 1) res = builder.makeBinary(BinaryOp::MUL, res, ConstantInteger::gen_i32(step));
+    const auto c0 = phi->getvalfromBB(preHeader);
+    if (constantOf(c0) != 0) res = builder.makeBinary(BinaryOp::ADD, c0, res);
+    replaceOutsideUses(loop, phi, res);
+  }
+  if (keepsX) {
+    replaceOutsideUses(loop, bitLoop->x, builder.makeInst<BinaryInst>(vSMIN, i32, x0, bound));
+  }
+#ifdef DEBUG
+  std::cerr << "bit idiom loop " << loop->header()->name() << ": " << counters.size()
+            << " counters" << std::endl;
+#endif
+}
+
+/* the compare choosing between the two incomings of phi, on a diamond or triangle */
+static ICmpInst* selectOf(PhiInst* phi, Value*& onTrue, Value*& onFalse) {
+  const auto merge = phi->block();
+  if (phi->getsize() != 2 or merge->pre_blocks().size() != 2) return nullptr;
+  const auto isArm = [&](BasicBlock* arm, BasicBlock* branchBlock) {
+    return arm->pre_blocks().size() == 1 and arm->pre_blocks().front() == branchBlock and
+           arm->next_blocks().size() == 1;
+  };
+  const auto b0 = phi->getBlock(0), b1 = phi->getBlock(1);
+  BasicBlock* branchBlock = nullptr;
+  if (isArm(b0, b1)) {
+    branchBlock = b1;
+  } else if (isArm(b1, b0)) {
+    branchBlock = b0;
+  } else if (b0->pre_blocks().size() == 1 and isArm(b0, b0->pre_blocks().front()) and
+             isArm(b1, b0->pre_blocks().front())) {
+    branchBlock = b0->pre_blocks().front();
+  }
+  if (branchBlock == nullptr or branchBlock == merge) return nullptr;
+
+  const auto br = branchBlock->terminator()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond()) return nullptr;
+  const auto cmp = br->cond()->dynCast<ICmpInst>();
+  if (cmp == nullptr or not cmp->lhs()->type()->isInt32()) return nullptr;
+  /* the incoming from the block entered when cmp holds (the branch block itself on a
+   * triangle reaches merge on the other edge) */
+  const bool firstOnTrue = b0 == br->iftrue() or (b0 == branchBlock and b1 != br->iftrue());
+  onTrue = phi->getValue(firstOnTrue ? 0 : 1);
+  onFalse = phi->getValue(firstOnTrue ? 1 : 0);
+  return cmp;
+}
+
+static Instruction* matchSelect(PhiInst* phi) {
+  if (not phi->type()->isInt32()) return nullptr;
+  Value* onTrue = nullptr;
+  Value* onFalse = nullptr;
+  const auto cmp = selectOf(phi, onTrue, onFalse);
+  if (cmp == nullptr) return nullptr;
+  const Compare compare{cmp};
+  if (not compare.isLess() and not compare.isGreater()) return nullptr;
+  const auto i32 = Type::TypeInt32();
+
+  /* a < b ? a : b */
+  const auto lhs = compare.lhs, rhs = compare.rhs;
+  if ((onTrue == lhs and onFalse == rhs) or (onTrue == rhs and onFalse == lhs)) {
+    const bool minOnTrue = compare.isLess() == (onTrue == lhs);
+    return utils::make<BinaryInst>(minOnTrue ? vSMIN : vSMAX, i32, lhs, rhs);
+  }
+
+  /* x < 0 ? 0 - x : x */
+  if (constantOf(rhs) != 0) return nullptr;
+  const auto negOf = [&](Value* val) {
+    const auto sub = val->dynCast<BinaryInst>();
+    return sub and sub->valueId() == vSUB and constantOf(sub->lValue()) == 0 and
+           sub->rValue() == lhs;
+  };
+  const bool isAbs = compare.isLess() ? negOf(onTrue) and onFalse == lhs
+                                      : onTrue == lhs and negOf(onFalse);
+  if (not isAbs) return nullptr;
+  return utils::make<UnaryInst>(vABS, i32, lhs);
+}
+
+void BitIdiom::run(Function* func, TopAnalysisInfoManager* tp) {
+  if (func->isOnlyDeclare()) return;
+  const auto lpctx = tp->getLoopInfo(func);
+
+  for (auto loop : lpctx->sortedLoops(true))
+    rewriteLoop(loop);
+
+  for (auto block : func->blocks()) {
+    std::vector<PhiInst*> phis;
+    for (auto inst : block->phi_insts())
+      phis.push_back(inst->as<PhiInst>());
+    for (auto phi : phis) {
+      const auto select = matchSelect(phi);
+      if (select == nullptr) continue;
+      block->emplace_first_inst(select);
+      phi->replaceAllUseWith(select);
+      block->delete_inst(phi);
+    }
+  }
+}
+
+}  // namespace pass
@@ -0,0 +1,279 @@
+#include "pass/optimize/Loop/LoopIdiom.hpp"
+#include "support/Hyperparameters.hpp"
+#include <bit>
+#include <optional>
+#include <unordered_map>
+
+using namespace ir;
+namespace pass {
+/* below this many words the call costs more than the stores it replaces */
+static utils::Parameter<uint32_t> MinElements{
+  "loopidiom.min-elements", 8, "loops with a constant trip count storing fewer words stay loops"};
+
+static const std::string fillName = "sysycMemfill";
+static const std::string copyName = "sysycMemcpy";
+
+/**
+ * void sysycMemfill(int* dst, int val, int len);        dst[k] = val
+ * void sysycMemcpy(int* dst, const int* src, int len);  dst[k] = src[k], k ascending
+ *
+ * len in bytes, nothing is written for len <= 0 (src/runtime/memset.cpp)
+ */
+static Function* lookupRuntime(Module* module, const std::string& name) {
+  if (auto func = module->findFunction(name)) {
+    return func;
+  }
+  const auto i32 = Type::TypeInt32();
+  const auto ptr = Type::TypePointer(i32);
+  const auto type =
+    FunctionType::gen(Type::void_type(), {ptr, name == copyName ? ptr : i32, i32});
+  auto func = module->addFunction(type, name);
+  func->attribute().addAttr(FunctionAttribute::Builtin);
+  return func;
+}
+
+static size_t typeBytes(Type* type) {
+  if (auto arrayType = type->dynCast<ArrayType>()) {
+    size_t count = 1;
+    for (auto dim : arrayType->dims())
+      count *= dim;
+    return count * typeBytes(arrayType->baseType());
+  }
+  return type->size();
+}
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+namespace {
+/* one word store (or runtime call of an inner loop) per iteration */
+struct Idiom final {
+  Instruction* inst;
+  LoadInst* load = nullptr;  // copy source of a store
+  Value* dst = nullptr;      // address written in the iteration
+  Value* src = nullptr;      // copy: address read in the iteration
+  Value* val = nullptr;      // fill: i32 value
+  size_t bytes = 0;          // bytes written per iteration
+};
+
+class IdiomMatcher final {
+  Loop* mLoop;
+  PhiInst* mPhi;
+  std::unordered_map<Value*, bool> mInvariant;
+
+public:
+  IdiomMatcher(Loop* loop, PhiInst* phi) : mLoop(loop), mPhi(phi) {}
+
+  /* computable in the preheader: defined outside or a pure function of such values */
+  bool isInvariant(Value* val) {
+    if (val == mPhi) return false;
+    if (not isDefinedIn(mLoop, val)) return true;
+    if (auto iter = mInvariant.find(val); iter != mInvariant.end()) return iter->second;
+    mInvariant[val] = false;
+
+    const auto inst = val->as<Instruction>();
+    bool pure = inst->isa<GetElementPtrInst>() or inst->valueId() == vBITCAST;
+    if (auto binary = inst->dynCast<BinaryInst>()) {
+      pure = binary->valueId() == vADD or binary->valueId() == vSUB or
+             binary->valueId() == vMUL;
+    }
+    if (not pure) return false;
+    for (auto op : inst->operands()) {
+      if (not isInvariant(op->value())) return false;
+    }
+    return mInvariant[val] = true;
+  }
+
+  /* bytes ptr advances per iteration, if it is an invariant base indexed by i + c */
+  std::optional<size_t> strideOf(Value* ptr) {
+    if (not isDefinedIn(mLoop, ptr)) return std::nullopt;
+    if (ptr->valueId() == vBITCAST) return strideOf(ptr->as<UnaryInst>()->value());
+    const auto gep = ptr->dynCast<GetElementPtrInst>();
+    if (gep == nullptr) return std::nullopt;
+
+    const auto idx = gep->index();
+    bool affine = idx == mPhi;
+    if (auto binary = idx->dynCast<BinaryInst>(); binary and binary->valueId() == vADD) {
+      const auto lhs = binary->lValue(), rhs = binary->rValue();
+      affine = (lhs == mPhi and isInvariant(rhs)) or (rhs == mPhi and isInvariant(lhs));
+    }
+    if (affine and isInvariant(gep->value())) return typeBytes(gep->baseType());
+    if (isInvariant(idx)) return strideOf(gep->value());
+    return std::nullopt;
+  }
+
+  /* val at i = beg, built before the preheader terminator */
+  Value* materialize(Value* val, Value* beg, BasicBlock* preHeader) {
+    if (val == mPhi) return beg;
+    if (not isDefinedIn(mLoop, val)) return val;
+    const auto copy = val->as<Instruction>()->copy(
+      [&](Value* op) { return materialize(op, beg, preHeader); });
+    preHeader->emplace_lastbutone_inst(copy);
+    return copy;
+  }
+};
+}  // namespace
+
+/* i from beg to end by 1, exits only through i < end in the header */
+static bool isCountedLoop(Loop* loop, IndVar* indVar) {
+  if (loop->exits().size() != 1 or loop->getLoopLatch() == nullptr) return false;
+  if (loop->getLoopPreheader() == nullptr) return false;
+  if (not indVar->getStep() or indVar->getStep()->i32() != 1) return false;
+  if (isDefinedIn(loop, indVar->beginValue()) or isDefinedIn(loop, indVar->endValue()))
+    return false;
+
+  const auto phi = indVar->phiinst();
+  const auto cmp = indVar->cmpInst()->dynCast<ICmpInst>();
+  if (cmp == nullptr or cmp->block() != loop->header()) return false;
+  const bool isLess = (cmp->valueId() == vISLT and cmp->lhs() == phi) or
+                      (cmp->valueId() == vISGT and cmp->rhs() == phi);
+  if (not isLess) return false;
+  const auto br = loop->header()->insts().back()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond() or br->cond() != cmp) return false;
+  if (not loop->contains(br->iftrue()) or loop->contains(br->iffalse())) return false;
+
+  for (auto block : loop->blocks()) {
+    if (block == loop->header()) continue;
+    for (auto next : block->next_blocks()) {
+      if (not loop->contains(next)) return false;
+    }
+  }
+  return true;
+}
+
+static std::optional<Idiom> matchIdiom(Loop* loop,
+                                       IdiomMatcher& matcher,
+                                       LoopInfo* lpctx,
+                                       DomTree* domctx) {
+  std::vector<Instruction*> writes;
+  std::vector<LoadInst*> loads;
+  for (auto block : loop->blocks()) {
+    for (auto inst : block->insts()) {
+      if (auto load = inst->dynCast<LoadInst>()) {
+        loads.push_back(load);
+      } else if (inst->isa<StoreInst>()) {
+        writes.push_back(inst);
+      } else if (auto call = inst->dynCast<CallInst>()) {
+        const auto& callee = call->callee()->name();
+        if (callee != fillName and callee != copyName) return std::nullopt;
+        writes.push_back(inst);
+      } else if (inst->isa<MemsetInst>() or inst->isa<AllocaInst>() or inst->isa<ReturnInst>()) {
+        return std::nullopt;
+      }
+    }
+  }
+  if (writes.size() != 1 or loads.size() > 1) return std::nullopt;
+
+  /* exactly once per iteration, not in the header that also runs on exit */
+  Idiom idiom{writes.front()};
+  const auto block = idiom.inst->block();
+  if (block == loop->header() or lpctx->getinnermostLoop(block) != loop) return std::nullopt;
+  if (not domctx->dominate(block, loop->getLoopLatch())) return std::nullopt;
+
+  if (auto store = idiom.inst->dynCast<StoreInst>()) {
+    const auto val = store->value();
+    idiom.dst = store->ptr();
+    idiom.bytes = typeBytes(val->type());
+    if (idiom.bytes != 4) return std::nullopt;
+    if (not loads.empty()) {
+      const auto load = loads.front();
+      if (val != load or load->block() != block or load->uses().size() != 1) return std::nullopt;
+      idiom.load = load;
+      idiom.src = load->ptr();
+    } else if (auto constant = val->dynCast<ConstantFloating>()) {
+      idiom.val = ConstantInteger::gen_i32(std::bit_cast<int32_t>(constant->getVal()));
+    } else if (val->type()->isInt32() and matcher.isInvariant(val)) {
+      idiom.val = val;
+    } else {
+      return std::nullopt;
+    }
+  } else {
+    const auto call = idiom.inst->as<CallInst>();
+    if (not loads.empty()) return std::nullopt;
+    const auto args = call->rargs();
+    const auto len = args.at(2)->value()->dynCast<ConstantInteger>();
+    if (len == nullptr or len->i32() <= 0) return std::nullopt;
+    idiom.dst = args.at(0)->value();
+    idiom.bytes = static_cast<size_t>(len->i32());
+    if (call->callee()->name() == copyName) {
+      idiom.src = args.at(1)->value();
+    } else if (matcher.isInvariant(args.at(1)->value())) {
+      idiom.val = args.at(1)->value();
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  if (matcher.strideOf(idiom.dst) != idiom.bytes) return std::nullopt;
+  if (idiom.src and matcher.strideOf(idiom.src) != idiom.bytes) return std::nullopt;
+  return idiom;
+}
+
+static void replaceWithCall(Loop* loop, IndVar* indVar, IdiomMatcher& matcher, Idiom& idiom) {
+  const auto preHeader = loop->getLoopPreheader();
+  const auto beg = indVar->beginValue();
+  const auto end = indVar->endValue();
+  const auto i32 = Type::TypeInt32();
+  const auto ptrType = Type::TypePointer(i32);
+
+  IRBuilder builder;
+  builder.set_pos(preHeader, std::prev(preHeader->insts().end()));
+  const auto startOf = [&](Value* ptr) -> Value* {
+    const auto start = matcher.materialize(ptr, beg, preHeader);
+    if (start->type() == ptrType) return start;
+    return builder.makeInst<UnaryInst>(vBITCAST, ptrType, start);
+  };
+  const auto dst = startOf(idiom.dst);
+  const auto src =
+    idiom.src ? startOf(idiom.src) : matcher.materialize(idiom.val, beg, preHeader);
+
+  Value* len = nullptr;
+  const auto begConst = beg->dynCast<ConstantInteger>();
+  const auto endConst = end->dynCast<ConstantInteger>();
+  if (begConst and endConst) {
+    len = ConstantInteger::gen_i32((endConst->i32() - begConst->i32()) *
+                                   static_cast<int32_t>(idiom.bytes));
+  } else {
+    const auto trip =
+      begConst and begConst->i32() == 0 ? end : builder.makeBinary(BinaryOp::SUB, end, beg);
+    len = builder.makeBinary(BinaryOp::MUL, trip,
+                             ConstantInteger::gen_i32(static_cast<int32_t>(idiom.bytes)));
+  }
+  const auto runtime = lookupRuntime(loop->function()->module(), idiom.src ? copyName : fillName);
+  builder.makeInst<CallInst>(runtime, std::vector<Value*>{dst, src, len});
+
+  idiom.inst->block()->delete_inst(idiom.inst);
+  if (idiom.load) idiom.load->block()->delete_inst(idiom.load);
+}
+
+void LoopIdiom::run(Function* func, TopAnalysisInfoManager* tp) {
+  if (func->isOnlyDeclare()) return;
+  const auto lpctx = tp->getLoopInfo(func);
+  const auto ivctx = tp->getIndVarInfo(func);
+  const auto domctx = tp->getDomTree(func);
+
+  bool modified = false;
+  /* innermost first, the CFG is left as is so the analyses stay valid */
+  for (auto loop : lpctx->sortedLoops(true)) {
+    const auto indVar = ivctx->getIndvar(loop);
+    if (indVar == nullptr or not isCountedLoop(loop, indVar)) continue;
+    IdiomMatcher matcher{loop, indVar->phiinst()};
+    auto idiom = matchIdiom(loop, matcher, lpctx, domctx);
+    if (not idiom) continue;
+
+    const auto begConst = indVar->beginValue()->dynCast<ConstantInteger>();
+    const auto endConst = indVar->endValue()->dynCast<ConstantInteger>();
+    if (begConst and endConst) {
+      const auto words = static_cast<int64_t>(endConst->i32() - begConst->i32()) *
+                         static_cast<int64_t>(idiom->bytes / 4);
+      if (words < static_cast<int64_t>(MinElements)) continue;
+    }
+    replaceWithCall(loop, indVar, matcher, *idiom);
+    modified = true;
+  }
+  if (modified) tp->CallChange();
+}
+
+}  // namespace pass
@@ -5,10 +5,13 @@
 #include "pass/analysis/ControlFlowGraph.hpp"
 #include "pass/optimize/Loop/LoopBodyExtract.hpp"
 #include "pass/optimize/Loop/ParallelBodyExtract.hpp"
+#include "pass/optimize/Loop/LoopVersioning.hpp"
 #include "pass/optimize/Utils/BlockUtils.hpp"
 #include "pass/analysis/MarkParallel.hpp"
 
 #include "pass/optimize/Loop/LoopUtils.hpp"
+#include "support/Hyperparameters.hpp"
+#include "support/LoopProfileData.hpp"
 #include <set>
 #include <cassert>
 #include <map>
@@ -18,6 +21,26 @@
 
 using namespace ir;
 namespace pass {
+/* must not exceed maxRegionLoops of the runtime (parallelForRegion2..4) */
+static utils::Parameter<uint32_t> RegionMaxLoops{
+  "parallel.region-max-loops", 4, "parallel loops fused into one fork-join region (2-4), <2: off"};
+static utils::Parameter<bool> LoopVersioning{
+  "parallel.loop-versioning", true,
+  "parallelize loops behind runtime alias/monotonicity checks, serial clone otherwise"};
+static utils::Parameter<double> ParallelMinHotness{
+  "parallel.min-hotness", 0.01,
+  "profiled share of the run below which a loop stays serial (-fprofile-use)"};
+
+/* -fprofile-use: a loop that hardly runs does not pay for the fork-join */
+static bool isProfiledCold(Loop* loop) {
+  const auto& profile = utils::LoopProfileData::get();
+  if (profile.empty()) return false;
+  if (const auto record = profile.find(loop->header()))
+    return profile.totalCycles() and profile.hotness(*record) < ParallelMinHotness;
+  const auto funcRecord = profile.function(loop->header()->function()->name());
+  return funcRecord and funcRecord->calls == 0;
+}
+
 bool LoopParallel::isConstant(Value* val) {
   if (val->isa<ConstantValue>() or val->isa<GlobalVariable>()) {
     return true;
@@ -29,9 +52,12 @@ bool LoopParallel::isConstant(Value* val) {
   return false;
 }
 /**
- * void parallelFor(int32_t beg, int32_t end, void (*)(int32_t beg, int32_t end) func);
+ * void parallelFor(int32_t beg, int32_t end,
+ *                  void (*)(int32_t beg, int32_t end, void* payload) func, void* payload);
  *
- * void @parallelFor(i32 %beg, i32 %end, void (i32, i32)* %parallel_body_ptr);
+ * void @parallelFor(i32 %beg, i32 %end, void (i32, i32, i32*)* %parallel_body_ptr, i32* %payload);
+ *
+ * payload: captures of the body in the caller's frame
  */
 static Function* loopupParallelFor(Module* module) {
   if (auto func = module->findFunction("parallelFor")) {
@@ -39,10 +65,12 @@ static Function* loopupParallelFor(Module* module) {
   }
   const auto voidType = Type::void_type();
   const auto i32 = Type::TypeInt32();
+  const auto payloadType = Type::TypePointer(i32);
 
-  const auto parallelBodyPtrType = FunctionType::gen(voidType, {i32, i32});
+  const auto parallelBodyPtrType = FunctionType::gen(voidType, {i32, i32, payloadType});
 
-  const auto parallelForType = FunctionType::gen(voidType, {i32, i32, parallelBodyPtrType});
+  const auto parallelForType =
+    FunctionType::gen(voidType, {i32, i32, parallelBodyPtrType, payloadType});
 
   auto parallelFor = module->addFunction(parallelForType, "parallelFor");
   parallelFor->attribute().addAttr(FunctionAttribute::Builtin);
@@ -50,6 +78,150 @@ static Function* loopupParallelFor(Module* module) {
   return parallelFor;
 }
 
+/**
+ * void parallelForRegionN(int32_t beg0, int32_t end0, void (*func0)(int32_t, int32_t, void*),
+ *                         void* payload0, ...);
+ *
+ * N (2..4) loops run by one wake/join of the worker team, with an in-team
+ * barrier between two loops.
+ */
+static Function* lookupParallelForRegion(Module* module, size_t count) {
+  const auto name = "parallelForRegion" + std::to_string(count);
+  if (auto func = module->findFunction(name)) {
+    return func;
+  }
+  const auto voidType = Type::void_type();
+  const auto i32 = Type::TypeInt32();
+  const auto payloadType = Type::TypePointer(i32);
+  const auto parallelBodyPtrType = FunctionType::gen(voidType, {i32, i32, payloadType});
+
+  std::vector<Type*> argTypes;
+  for (size_t idx = 0; idx < count; idx++) {
+    argTypes.insert(argTypes.end(), {i32, i32, parallelBodyPtrType, payloadType});
+  }
+  auto region = module->addFunction(FunctionType::gen(voidType, std::move(argTypes)), name);
+  region->attribute().addAttr(FunctionAttribute::Builtin);
+  return region;
+}
+
+static bool isParallelForCall(Instruction* inst) {
+  if (auto call = inst->dynCast<CallInst>()) {
+    return call->callee()->name() == "parallelFor";
+  }
+  return false;
+}
+
+/* may be moved above a parallelFor call: no memory access, no call */
+static bool isPureInst(Instruction* inst) {
+  const auto id = inst->valueId();
+  return inst->isBinary() or inst->isUnary() or id == vGETELEMENTPTR or
+         (id > vICMP_BEGIN and id < vICMP_END) or (id > vFCMP_BEGIN and id < vFCMP_END);
+}
+
+/*
+ * alloca of `store v, inttoptr(ptrtoint(payload) + offset)`, the captures of a parallel
+ * body; the chunk alignment hint at offset 0 may have lost its add
+ */
+static Value* storedPayload(StoreInst* store) {
+  const auto toPtr = store->ptr()->dynCast<UnaryInst>();
+  if (not toPtr or toPtr->valueId() != vINTTOPTR) return nullptr;
+  auto address = toPtr->value();
+  if (const auto add = address->dynCast<BinaryInst>()) address = add->lValue();
+  const auto toInt = address->dynCast<UnaryInst>();
+  if (not toInt or toInt->valueId() != vPTRTOINT) return nullptr;
+  return toInt->value()->dynCast<AllocaInst>();
+}
+
+/*
+ * Fork-join region fusion: parallelFor calls that follow each other on a
+ * straight-line path (unconditional branches into single-predecessor blocks
+ * without phis), with only pure instructions and the payload stores of the
+ * next call in between, become one parallelForRegionN call. Those are hoisted
+ * above it: they only depend on values computed before the first call, and
+ * a payload is only read by its own call.
+ */
+bool LoopParallel::fuseRegions(Function* func, TopAnalysisInfoManager* tp) {
+  const auto maxLoops = std::min<uint32_t>(RegionMaxLoops, 4);
+  if (maxLoops < 2) return false;
+
+  bool modified = false;
+  for (auto block : func->blocks()) {
+    for (auto iter = block->insts().begin(); iter != block->insts().end(); ++iter) {
+      if (not isParallelForCall(*iter)) continue;
+
+      std::vector<CallInst*> calls{(*iter)->as<CallInst>()};
+      std::vector<Instruction*> between;
+      std::vector<StoreInst*> payloadStores;  // since the last call
+      size_t hoistCount = 0;
+      auto curBlock = block;
+      auto cur = std::next(iter);
+      while (calls.size() < maxLoops and cur != curBlock->insts().end()) {
+        const auto inst = *cur;
+        if (isParallelForCall(inst)) {
+          const auto payload = inst->operand(3);
+          if (not std::all_of(payloadStores.begin(), payloadStores.end(),
+                              [&](StoreInst* store) { return storedPayload(store) == payload; }))
+            break;
+          calls.push_back(inst->as<CallInst>());
+          hoistCount = between.size();
+          payloadStores.clear();
+          ++cur;
+        } else if (isPureInst(inst)) {
+          between.push_back(inst);
+          ++cur;
+        } else if (inst->isa<StoreInst>() and storedPayload(inst->as<StoreInst>())) {
+          between.push_back(inst);
+          payloadStores.push_back(inst->as<StoreInst>());
+          ++cur;
+        } else if (auto br = inst->dynCast<BranchInst>()) {
+          const auto next = br->is_cond() ? nullptr : br->iftrue();
+          if (next == nullptr or next == block or next->pre_blocks().size() != 1 or
+              not next->phi_insts().empty())
+            break;
+          curBlock = next;
+          cur = curBlock->insts().begin();
+        } else {
+          break;
+        }
+      }
+      if (calls.size() < 2) continue;
+
+      /* hoist, then the region call takes the place of the first parallelFor */
+      const auto first = calls.front();
+      auto pos = std::find(block->insts().begin(), block->insts().end(), first);
+      for (size_t idx = 0; idx < hoistCount; idx++) {
+        const auto inst = between[idx];
+        inst->block()->move_inst(inst);
+        block->emplace_inst(pos, inst);
+      }
+      std::vector<Value*> args;
+      for (auto call : calls) {
+        for (auto use : call->rargs())
+          args.push_back(use->value());
+      }
+      IRBuilder builder;
+      builder.set_pos(block, pos);
+      builder.makeInst<CallInst>(lookupParallelForRegion(func->module(), calls.size()), args);
+      const auto regionPos = std::prev(pos);
+      for (auto call : calls) {
+        call->block()->delete_inst(call);
+      }
+#ifdef DEBUG
+      std::cerr << "fork-join region: " << calls.size() << " parallel loops" << std::endl;
+#endif
+      modified = true;
+      /* continue behind the region call, the fused calls are gone */
+      iter = regionPos;
+    }
+  }
+  if (modified) {
+    CFGAnalysisHHW().run(func, tp);
+    blockSortDFS(*func, tp);
+    tp->CallChange();
+  }
+  return modified;
+}
+
 void LoopParallel::run(Function* func, TopAnalysisInfoManager* tp) {
   runImpl(func, tp);
 }
@@ -66,7 +238,8 @@ bool parallelLoop(Function* func, TopAnalysisInfoManager* tp, Loop* loop, IndVar
   IRBuilder builder;
   const auto callBlock = parallelBodyInfo.callBlock;
   auto& insts = parallelBodyInfo.callBlock->insts();
-  std::vector<Value*> args = {parallelBodyInfo.beg, parallelBodyInfo.end, parallelBody};
+  std::vector<Value*> args = {parallelBodyInfo.beg, parallelBodyInfo.end, parallelBody,
+                              parallelBodyInfo.payloadStorage};
 
   const auto iter = std::find(insts.begin(), insts.end(), parallelBodyInfo.callInst);
   // assert(iter != insts.end());  // must find
@@ -108,8 +281,16 @@ bool LoopParallel::runImpl(Function* func, TopAnalysisInfoManager* tp) {
 
   // lpctx->print(std::cerr);
   for (auto loop : loops) {  // for all loops
+    if (isProfiledCold(loop)) continue;
     const auto indVar = indVarctx->getIndvar(loop);
-    if (not checkLoopParallel(loop, lpctx, indVarctx, parallelctx, extractedLoops)) continue;
+    /* parallel only if the runtime checks pass, versioned just before extraction */
+    const bool needsChecks = LoopVersioning and parallelctx->getNeedsVersioning(loop->header());
+    if (needsChecks) parallelctx->setIsParallel(loop->header(), true);
+    if (not checkLoopParallel(loop, lpctx, indVarctx, parallelctx, extractedLoops) or
+        (needsChecks and not versionLoop(func, loop, indVar, tp))) {
+      if (needsChecks) parallelctx->setIsParallel(loop->header(), false);
+      continue;
+    }
 #ifdef DEBUG
     std::cerr << "loop level: " << lpctx->looplevel(loop->header());
     loop->print(std::cerr);
@@ -124,6 +305,7 @@ bool LoopParallel::runImpl(Function* func, TopAnalysisInfoManager* tp) {
       // indVar->print(std::cerr);
     }
   }
+  if (modified) fuseRegions(func, tp);
 
   return modified;
 }
@@ -0,0 +1,260 @@
+#include "pass/optimize/Loop/LoopPrefetch.hpp"
+#include "pass/analysis/dependenceAnalysis/DependenceAnalysis.hpp"
+#include "pass/optimize/Loop/UnrollCostModel.hpp"
+#include "target/riscv/RISCVTarget.hpp"
+#include "support/Hyperparameters.hpp"
+#include "support/config.hpp"
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <unordered_map>
+
+using namespace ir;
+namespace pass {
+static utils::Parameter<uint32_t> PrefetchLatency{
+  "prefetch.latency", 120, "cycles a software prefetch has to hide (L2 miss)"};
+static utils::Parameter<uint32_t> PrefetchMaxDistance{
+  "prefetch.max-distance", 16, "max iterations a prefetch runs ahead of its load"};
+static utils::Parameter<uint32_t> PrefetchMaxStreams{
+  "prefetch.max-streams", 4, "max software prefetched streams per loop"};
+
+/* sifive-u74 L1D and L2 line */
+static constexpr size_t CacheLineBytes = 64;
+
+static size_t typeBytes(Type* type) {
+  if (auto arrayType = type->dynCast<ArrayType>()) {
+    size_t count = 1;
+    for (auto dim : arrayType->dims())
+      count *= dim;
+    return count * typeBytes(arrayType->baseType());
+  }
+  return type->size();
+}
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+static void insertBefore(Instruction* pos, Instruction* inst) {
+  auto& insts = pos->block()->insts();
+  pos->block()->emplace_inst(std::find(insts.begin(), insts.end(), pos), inst);
+}
+
+namespace {
+/* a subaddress of the loop, the same base and stride count once */
+struct Stream final {
+  GetElementPtrInst* gep;
+  size_t stride;             // bytes per iteration
+  LoadInst* load = nullptr;  // a load of gep that runs in every iteration, not on exit
+};
+
+class StreamMatcher final {
+  Loop* mLoop;
+  PhiInst* mPhi;
+  std::unordered_map<Value*, bool> mInvariant;
+
+public:
+  StreamMatcher(Loop* loop, PhiInst* phi) : mLoop(loop), mPhi(phi) {}
+
+  /* the same value in every iteration: defined outside or a pure function of such values */
+  bool isInvariant(Value* val) {
+    if (val == mPhi) return false;
+    if (not isDefinedIn(mLoop, val)) return true;
+    if (auto iter = mInvariant.find(val); iter != mInvariant.end()) return iter->second;
+    mInvariant[val] = false;
+
+    const auto inst = val->as<Instruction>();
+    bool pure = inst->isa<GetElementPtrInst>() or inst->valueId() == vBITCAST;
+    if (auto binary = inst->dynCast<BinaryInst>()) {
+      pure = binary->valueId() == vADD or binary->valueId() == vSUB or
+             binary->valueId() == vMUL;
+    }
+    if (not pure) return false;
+    for (auto op : inst->operands()) {
+      if (not isInvariant(op->value())) return false;
+    }
+    return mInvariant[val] = true;
+  }
+
+  /* bytes ptr advances per unit of i, if it is an invariant base indexed by i + c */
+  std::optional<size_t> strideOf(Value* ptr) {
+    if (not isDefinedIn(mLoop, ptr)) return std::nullopt;
+    if (ptr->valueId() == vBITCAST) return strideOf(ptr->as<UnaryInst>()->value());
+    const auto gep = ptr->dynCast<GetElementPtrInst>();
+    if (gep == nullptr) return std::nullopt;
+
+    const auto idx = gep->index();
+    bool affine = idx == mPhi;
+    if (auto binary = idx->dynCast<BinaryInst>(); binary and binary->valueId() == vADD) {
+      const auto lhs = binary->lValue(), rhs = binary->rValue();
+      affine = (lhs == mPhi and isInvariant(rhs)) or (rhs == mPhi and isInvariant(lhs));
+    }
+    if (affine and isInvariant(gep->value())) return typeBytes(gep->baseType());
+    if (isInvariant(idx)) return strideOf(gep->value());
+    return std::nullopt;
+  }
+
+  /* val with i replaced by ahead, built before pos */
+  Value* materialize(Value* val, Value* ahead, Instruction* pos) {
+    if (val == mPhi) return ahead;
+    if (isInvariant(val)) return val;
+    const auto copy =
+      val->as<Instruction>()->copy([&](Value* op) { return materialize(op, ahead, pos); });
+    insertBefore(pos, copy);
+    return copy;
+  }
+};
+}  // namespace
+
+/* i from beg to end by a constant step > 0, exits only through i < end in the header */
+static bool isCountedLoop(Loop* loop, IndVar* indVar) {
+  if (loop->exits().size() != 1 or loop->getLoopLatch() == nullptr) return false;
+  if (loop->getLoopPreheader() == nullptr) return false;
+  if (not indVar->getStep() or indVar->getStep()->i32() <= 0) return false;
+  if (isDefinedIn(loop, indVar->beginValue()) or isDefinedIn(loop, indVar->endValue()))
+    return false;
+
+  const auto phi = indVar->phiinst();
+  const auto cmp = indVar->cmpInst()->dynCast<ICmpInst>();
+  if (cmp == nullptr or cmp->block() != loop->header()) return false;
+  const bool isLess = (cmp->valueId() == vISLT and cmp->lhs() == phi) or
+                      (cmp->valueId() == vISGT and cmp->rhs() == phi);
+  if (not isLess) return false;
+  const auto br = loop->header()->insts().back()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond() or br->cond() != cmp) return false;
+  if (not loop->contains(br->iftrue()) or loop->contains(br->iffalse())) return false;
+
+  for (auto block : loop->blocks()) {
+    if (block == loop->header()) continue;
+    for (auto next : block->next_blocks()) {
+      if (not loop->contains(next)) return false;
+    }
+  }
+  return true;
+}
+
+/* streams in program order, from the subaddresses of the dependence analysis */
+static std::vector<Stream> collectStreams(Loop* loop,
+                                          IndVar* indVar,
+                                          LoopDependenceInfo* depInfo,
+                                          StreamMatcher& matcher,
+                                          DomTree* domctx) {
+  std::unordered_map<Instruction*, size_t> order;
+  for (auto block : loop->header()->function()->blocks()) {
+    if (not loop->contains(block)) continue;
+    for (auto inst : block->insts())
+      order.emplace(inst, order.size());
+  }
+  std::vector<std::pair<Value*, GetElementPtrInst*>> subAddrs;
+  for (auto base : depInfo->getBaseAddrs()) {
+    for (auto gep : depInfo->baseAddrToSubAddrSet(base))
+      subAddrs.emplace_back(base, gep);
+  }
+  std::sort(subAddrs.begin(), subAddrs.end(), [&](const auto& lhs, const auto& rhs) {
+    return order[lhs.second] < order[rhs.second];
+  });
+
+  const auto step = static_cast<size_t>(indVar->getStep()->i32());
+  std::vector<Stream> streams;
+  std::map<std::pair<Value*, size_t>, size_t> index;
+  for (auto [base, gep] : subAddrs) {
+    const auto stride = matcher.strideOf(gep);
+    if (not stride or *stride == 0) continue;
+    LoadInst* load = nullptr;
+    if (depInfo->getIsSubAddrRead(gep)) {
+      for (auto inst : depInfo->getSubAddrInsts(gep)) {
+        const auto block = inst->block();
+        if (not inst->isa<LoadInst>() or block == loop->header()) continue;
+        if (not domctx->dominate(block, loop->getLoopLatch())) continue;
+        if (load == nullptr or order[inst] < order[load]) load = inst->as<LoadInst>();
+      }
+    }
+    const auto [iter, inserted] = index.emplace(std::pair{base, *stride}, streams.size());
+    if (inserted) {
+      streams.push_back({gep, *stride * step, load});
+    } else if (streams[iter->second].load == nullptr and load) {
+      streams[iter->second].gep = gep;
+      streams[iter->second].load = load;
+    }
+  }
+  return streams;
+}
+
+/* iterations ahead that cover the miss latency */
+static uint32_t prefetchDistance(const LoopBodyStats& stats, const mir::MicroArchInfo& info) {
+  const auto issueWidth = std::max(info.issueWidth, 1u);
+  const auto cycles = std::max({(stats.insts + issueWidth - 1) / issueWidth, stats.recurrence, 1u});
+  const uint32_t maxDistance = PrefetchMaxDistance;
+  return std::clamp((PrefetchLatency + cycles - 1) / cycles, 1u, std::max(maxDistance, 1u));
+}
+
+void LoopPrefetch::run(Function* func, TopAnalysisInfoManager* tp) {
+  if (func->isOnlyDeclare() or not sysy::Config::getInstance().prefetchLoops) return;
+  const auto& info = mir::RISCV::getRISCVScheduleModel().getMicroArchInfo();
+  const auto dpctx = tp->getDepInfo(func);
+  const auto lpctx = tp->getLoopInfo(func);
+  const auto ivctx = tp->getIndVarInfo(func);
+  const auto domctx = tp->getDomTree(func);
+  const auto i32 = Type::TypeInt32();
+
+  for (auto loop : lpctx->loops()) {
+    if (not loop->subLoops().empty()) continue;
+    const auto indVar = ivctx->getIndvar(loop);
+    const auto depInfo = dpctx->getLoopDependenceInfo(loop);
+    if (indVar == nullptr or depInfo == nullptr or not isCountedLoop(loop, indVar)) continue;
+    const auto stats = UnrollCostModel::analyze(loop);
+    if (stats.hasCall) continue;
+    StreamMatcher matcher{loop, indVar->phiinst()};
+    auto streams = collectStreams(loop, indVar, depInfo, matcher, domctx);
+
+    /* the hardware trains on the smallest strides first */
+    std::stable_sort(streams.begin(), streams.end(),
+                     [](const Stream& lhs, const Stream& rhs) { return lhs.stride < rhs.stride; });
+    std::vector<Stream*> missed;
+    uint32_t tracked = 0;
+    for (auto& stream : streams) {
+      if (info.hardwarePrefetch and stream.stride <= info.maxStrideByBytes and
+          tracked < info.maxDataStreams) {
+        tracked++;
+        continue;
+      }
+      /* a smaller stride reuses the line fetched by the previous iterations */
+      if (stream.load and stream.stride >= CacheLineBytes and missed.size() < PrefetchMaxStreams)
+        missed.push_back(&stream);
+    }
+    if (missed.empty()) continue;
+
+    const auto phi = indVar->phiinst();
+    const auto step = indVar->getStep()->i32();
+    const auto distance = static_cast<int32_t>(prefetchDistance(stats, info));
+    /* end - step <= the last i: ahead stays in the range of i the loop runs */
+    Value* last = nullptr;
+    if (auto endConst = indVar->endValue()->dynCast<ConstantInteger>()) {
+      last = ConstantInteger::gen_i32(endConst->i32() - step);
+    } else {
+      const auto sub = utils::make<BinaryInst>(vSUB, i32, indVar->endValue(), indVar->getStep());
+      loop->getLoopPreheader()->emplace_lastbutone_inst(sub);
+      last = sub;
+    }
+    for (auto stream : missed) {
+      const auto pos = stream->load;
+      const auto next =
+        utils::make<BinaryInst>(vADD, i32, phi, ConstantInteger::gen_i32(distance * step));
+      const auto clamped = utils::make<BinaryInst>(vSMIN, i32, next, last);
+      insertBefore(pos, next);
+      insertBefore(pos, clamped);
+      Value* ahead = clamped;
+      if (step != 1) {
+        /* end - step < i in the last iteration */
+        const auto atLeast = utils::make<BinaryInst>(vSMAX, i32, clamped, phi);
+        insertBefore(pos, atLeast);
+        ahead = atLeast;
+      }
+      const auto addr = matcher.materialize(stream->gep, ahead, pos);
+      insertBefore(pos, utils::make<PrefetchInst>(addr));
+    }
+  }
+}
+
+}  // namespace pass
@@ -0,0 +1,591 @@
+#include "pass/optimize/Loop/LoopRecurrence.hpp"
+#include "pass/analysis/ControlFlowGraph.hpp"
+#include "pass/optimize/Utils/BlockUtils.hpp"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <unordered_map>
+
+using namespace ir;
+namespace pass {
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+/* i32 wrapping arithmetic on coefficients */
+static int64_t wrap32(int64_t val) {
+  return static_cast<int32_t>(static_cast<uint32_t>(val));
+}
+
+namespace {
+/* sum of coef[d] * i^d plus sum of k * v over loop invariant v */
+struct Poly final {
+  std::array<int64_t, 4> coef{};
+  std::vector<std::pair<Value*, int64_t>> invariants;
+
+  bool isZero() const {
+    return invariants.empty() and std::all_of(coef.begin(), coef.end(), [](auto c) {
+             return c == 0;
+           });
+  }
+  std::optional<int64_t> constant() const {
+    if (not invariants.empty() or coef[1] or coef[2] or coef[3]) return std::nullopt;
+    return coef[0];
+  }
+};
+
+static Poly add(const Poly& lhs, const Poly& rhs) {
+  Poly res = lhs;
+  for (size_t d = 0; d < res.coef.size(); d++)
+    res.coef[d] = wrap32(res.coef[d] + rhs.coef[d]);
+  res.invariants.insert(res.invariants.end(), rhs.invariants.begin(), rhs.invariants.end());
+  return res;
+}
+
+static Poly scale(const Poly& poly, int64_t k) {
+  Poly res = poly;
+  for (auto& c : res.coef)
+    c = wrap32(c * k);
+  for (auto& [val, c] : res.invariants)
+    c = wrap32(c * k);
+  return res;
+}
+
+static std::optional<Poly> mul(const Poly& lhs, const Poly& rhs) {
+  if (auto k = rhs.constant()) return scale(lhs, *k);
+  if (auto k = lhs.constant()) return scale(rhs, *k);
+  if (not lhs.invariants.empty() or not rhs.invariants.empty()) return std::nullopt;
+  Poly res;
+  for (size_t i = 0; i < lhs.coef.size(); i++) {
+    for (size_t j = 0; j < rhs.coef.size(); j++) {
+      if (lhs.coef[i] == 0 or rhs.coef[j] == 0) continue;
+      if (i + j >= res.coef.size()) return std::nullopt;
+      res.coef[i + j] = wrap32(res.coef[i + j] + wrap32(lhs.coef[i] * rhs.coef[j]));
+    }
+  }
+  return res;
+}
+
+/* x' = a * x + p, or x' = x * scale for an invariant scale */
+struct Rec final {
+  int64_t a = 1;
+  Value* scale = nullptr;
+  Poly p;
+};
+
+struct Recurrence final {
+  PhiInst* phi;
+  Value* init;
+  Rec rec;
+  int64_t mod = 0;  // x' = (a * x + p) % mod if positive
+  bool isGeometric() const { return rec.scale or rec.a != 1; }
+};
+
+class RecurrenceMatcher final {
+  Loop* mLoop;
+  PhiInst* mIndVar;
+  PhiInst* mPhi;
+
+public:
+  RecurrenceMatcher(Loop* loop, PhiInst* indVar, PhiInst* phi)
+    : mLoop(loop), mIndVar(indVar), mPhi(phi) {}
+
+  /* val as a polynomial of the induction variable */
+  std::optional<Poly> parsePoly(Value* val) {
+    Poly res;
+    if (val == mIndVar) {
+      res.coef[1] = 1;
+      return res;
+    }
+    if (not val->type()->isInt32()) return std::nullopt;
+    if (auto constant = val->dynCast<ConstantInteger>()) {
+      res.coef[0] = constant->i32();
+      return res;
+    }
+    if (not isDefinedIn(mLoop, val)) {
+      res.invariants.emplace_back(val, 1);
+      return res;
+    }
+    const auto binary = val->dynCast<BinaryInst>();
+    if (binary == nullptr) return std::nullopt;
+    const auto lhs = parsePoly(binary->lValue());
+    if (not lhs) return std::nullopt;
+    const auto rhs = parsePoly(binary->rValue());
+    if (not rhs) return std::nullopt;
+    switch (binary->valueId()) {
+      case vADD:
+        return add(*lhs, *rhs);
+      case vSUB:
+        return add(*lhs, scale(*rhs, -1));
+      case vMUL:
+        return mul(*lhs, *rhs);
+      default:
+        return std::nullopt;
+    }
+  }
+
+  /* val as a function of the recurrence phi of the same iteration */
+  std::optional<Rec> parseRec(Value* val) {
+    if (val == mPhi) return Rec{};
+    const auto binary = val->dynCast<BinaryInst>();
+    if (binary == nullptr or not binary->type()->isInt32()) return std::nullopt;
+    if (not isDefinedIn(mLoop, binary)) return std::nullopt;
+    const auto lhsPoly = parsePoly(binary->lValue()), rhsPoly = parsePoly(binary->rValue());
+    if (lhsPoly and rhsPoly) return std::nullopt;
+    auto lhs = lhsPoly ? std::nullopt : parseRec(binary->lValue());
+    auto rhs = rhsPoly ? std::nullopt : parseRec(binary->rValue());
+    if ((not lhsPoly and not lhs) or (not rhsPoly and not rhs)) return std::nullopt;
+
+    switch (binary->valueId()) {
+      case vADD:
+      case vSUB: {
+        const int64_t sign = binary->valueId() == vADD ? 1 : -1;
+        if (lhs and rhsPoly) {
+          lhs->p = add(lhs->p, scale(*rhsPoly, sign));
+          return lhs;
+        }
+        if (rhs and lhsPoly and sign == 1) {
+          rhs->p = add(rhs->p, *lhsPoly);
+          return rhs;
+        }
+        if (lhs and rhs and not lhs->scale and not rhs->scale) {
+          lhs->a = wrap32(lhs->a + sign * rhs->a);
+          lhs->p = add(lhs->p, scale(rhs->p, sign));
+          return lhs;
+        }
+        return std::nullopt;
+      }
+      case vMUL: {
+        auto rec = lhs ? lhs : rhs;
+        const auto& poly = lhsPoly ? *lhsPoly : *rhsPoly;
+        if (not rec or rec->scale) return std::nullopt;
+        if (auto k = poly.constant()) {
+          rec->a = wrap32(rec->a * *k);
+          rec->p = scale(rec->p, *k);
+          return rec;
+        }
+        const bool single = poly.invariants.size() == 1 and poly.invariants.front().second == 1 and
+                            poly.coef == decltype(poly.coef){};
+        if (not single or rec->a != 1 or not rec->p.isZero()) return std::nullopt;
+        rec->scale = poly.invariants.front().first;
+        return rec;
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+};
+}  // namespace
+
+/* i from beg to end by 1, exits only through i < end in the header into a dedicated exit */
+static bool isCountedLoop(Loop* loop, IndVar* indVar) {
+  if (not loop->subLoops().empty() or loop->exits().size() != 1) return false;
+  if (loop->getLoopPreheader() == nullptr or loop->getLoopLatch() == nullptr) return false;
+  if (not indVar->getStep() or indVar->getStep()->i32() != 1) return false;
+  if (isDefinedIn(loop, indVar->beginValue()) or isDefinedIn(loop, indVar->endValue()))
+    return false;
+  if (not indVar->beginValue()->type()->isInt32()) return false;
+
+  const auto phi = indVar->phiinst();
+  const auto cmp = indVar->cmpInst()->dynCast<ICmpInst>();
+  if (cmp == nullptr or cmp->block() != loop->header()) return false;
+  const bool isLess = (cmp->valueId() == vISLT and cmp->lhs() == phi) or
+                      (cmp->valueId() == vISGT and cmp->rhs() == phi);
+  if (not isLess) return false;
+  const auto br = loop->header()->insts().back()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond() or br->cond() != cmp) return false;
+  if (not loop->contains(br->iftrue()) or loop->contains(br->iffalse())) return false;
+  if (br->iffalse()->pre_blocks().size() != 1) return false;
+
+  for (auto block : loop->blocks()) {
+    if (block == loop->header()) continue;
+    for (auto next : block->next_blocks()) {
+      if (not loop->contains(next)) return false;
+    }
+  }
+  return true;
+}
+
+/* largest i >= 0 with mod - 1 + p(i) <= INT32_MAX, p with non-negative coefficients */
+static int64_t maxIndexOf(const Poly& poly, int64_t mod) {
+  const auto fits = [&](int64_t i) {
+    int64_t val = 0;
+    for (size_t d = poly.coef.size(); d-- > 0;) {
+      val = val * i + poly.coef[d];
+      if (val > INT32_MAX) return false;
+    }
+    return mod - 1 + val <= INT32_MAX;
+  };
+  int64_t lo = -1, hi = INT32_MAX;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo + 1) / 2;
+    if (fits(mid)) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return lo;
+}
+
+static std::optional<Recurrence> matchRecurrence(Loop* loop, IndVar* indVar, PhiInst* phi) {
+  if (not phi->type()->isInt32() or phi->getsize() != 2) return std::nullopt;
+  const auto init = phi->getvalfromBB(loop->getLoopPreheader());
+  const auto next = phi->getvalfromBB(loop->getLoopLatch());
+  if (init == nullptr or next == nullptr) return std::nullopt;
+
+  Recurrence recurrence{phi, init};
+  Value* body = next;
+  if (auto binary = next->dynCast<BinaryInst>(); binary and binary->valueId() == vSREM) {
+    const auto mod = binary->rValue()->dynCast<ConstantInteger>();
+    if (mod and mod->i32() > 0 and isDefinedIn(loop, binary)) {
+      recurrence.mod = mod->i32();
+      body = binary->lValue();
+    }
+  }
+  RecurrenceMatcher matcher{loop, indVar->phiinst(), phi};
+  const auto rec = matcher.parseRec(body);
+  if (not rec) return std::nullopt;
+  recurrence.rec = *rec;
+  if (recurrence.isGeometric() and (not rec->p.isZero() or rec->a == 0)) return std::nullopt;
+  if (recurrence.mod == 0) return recurrence;
+
+  /* x stays in [0, mod) and x + p(i) never wraps, so srem is the mathematical mod */
+  const auto x0 = init->dynCast<ConstantInteger>();
+  if (x0 == nullptr or x0->i32() < 0 or x0->i32() >= recurrence.mod) return std::nullopt;
+  if (recurrence.isGeometric()) {
+    if (rec->scale or rec->a < 0 or (recurrence.mod - 1) * rec->a > INT32_MAX)
+      return std::nullopt;
+    return recurrence;
+  }
+  if (not rec->p.invariants.empty()) return std::nullopt;
+  for (auto c : rec->p.coef) {
+    if (c < 0) return std::nullopt;
+  }
+  return recurrence;
+}
+
+namespace {
+/* closed forms in i64, S(d, m) = sum of k^d over [0, m) */
+class ClosedFormBuilder final {
+  IRBuilder& mBuilder;
+  std::unordered_map<Value*, Value*> mWidened;
+  std::map<std::pair<Value*, int64_t>, Value*> mSum1;
+
+  Value* bin(BinaryOp op, Value* lhs, Value* rhs) { return mBuilder.makeBinary(op, lhs, rhs); }
+  Value* c64(int64_t val) { return ConstantInteger::gen_i64(val); }
+
+public:
+  explicit ClosedFormBuilder(IRBuilder& builder) : mBuilder(builder) {}
+
+  Value* widen(Value* val) {
+    if (auto constant = val->dynCast<ConstantInteger>()) return c64(constant->i32());
+    auto& res = mWidened[val];
+    if (res == nullptr) res = mBuilder.makeUnary(vSEXT, val, Type::TypeInt64());
+    return res;
+  }
+  /* m(m-1)/2, optionally mod, exact in i64 for any i32 m */
+  Value* sum1(Value* m, int64_t mod) {
+    auto& res = mSum1[{m, mod}];
+    if (res) return res;
+    if (mod) return res = bin(BinaryOp::REM, sum1(m, 0), c64(mod));
+    const auto product = bin(BinaryOp::MUL, m, bin(BinaryOp::SUB, m, c64(1)));
+    return res = bin(BinaryOp::DIV, product, c64(2));
+  }
+  /* S(d, m), reduced mod `mod` if positive (m >= 0 then), i64 wrapping otherwise */
+  Value* sum(size_t degree, Value* m, int64_t mod) {
+    const auto reduce = [&](Value* val) { return mod ? bin(BinaryOp::REM, val, c64(mod)) : val; };
+    switch (degree) {
+      case 0:
+        return reduce(m);
+      case 1:
+        return sum1(m, mod);
+      case 2: {
+        /* S1 * (2m - 1) / 3 = q * (2m - 1) + r * (2m - 1) / 3 for S1 = 3q + r */
+        const auto s1 = sum1(m, 0);
+        const auto t = bin(BinaryOp::SUB, bin(BinaryOp::MUL, m, c64(2)), c64(1));
+        const auto q = bin(BinaryOp::DIV, s1, c64(3));
+        const auto r = bin(BinaryOp::REM, s1, c64(3));
+        const auto tail = reduce(bin(BinaryOp::DIV, bin(BinaryOp::MUL, r, t), c64(3)));
+        const auto head = reduce(bin(BinaryOp::MUL, reduce(q), reduce(t)));
+        return reduce(bin(BinaryOp::ADD, head, tail));
+      }
+      case 3: {
+        const auto s1 = sum1(m, mod);
+        return reduce(bin(BinaryOp::MUL, s1, s1));
+      }
+      default:
+        assert(false && "degree > 3");
+        return nullptr;
+    }
+  }
+
+  /* x0 + sum of p(i) over [beg, end), beg < end */
+  Value* addRec(const Recurrence& recurrence, Value* beg, Value* end, Value* count) {
+    const auto mod = recurrence.mod;
+    const auto begConst = beg->dynCast<ConstantInteger>();
+    const bool fromZero = begConst and begConst->i32() == 0;
+    Value* total = mod ? widen(recurrence.init) : nullptr;
+    for (size_t d = 0; d < recurrence.rec.p.coef.size(); d++) {
+      const auto c = recurrence.rec.p.coef[d];
+      if (c == 0) continue;
+      Value* diff = sum(d, widen(end), mod);
+      if (not fromZero) {
+        diff = bin(BinaryOp::SUB, diff, sum(d, widen(beg), mod));
+        if (mod) diff = bin(BinaryOp::REM, bin(BinaryOp::ADD, diff, c64(mod)), c64(mod));
+      }
+      Value* term = bin(BinaryOp::MUL, c64(mod ? c % mod : c), diff);
+      if (mod) term = bin(BinaryOp::REM, term, c64(mod));
+      total = total ? bin(BinaryOp::ADD, total, term) : term;
+    }
+    if (mod) {
+      total = bin(BinaryOp::REM, total, c64(mod));
+      return mBuilder.makeUnary(vTRUNC, total, Type::TypeInt32());
+    }
+
+    Value* res = recurrence.init;
+    if (total) res = bin(BinaryOp::ADD, res, mBuilder.makeUnary(vTRUNC, total, Type::TypeInt32()));
+    for (auto [val, k] : recurrence.rec.p.invariants) {
+      Value* term = bin(BinaryOp::MUL, val, count);
+      if (k != 1) term = bin(BinaryOp::MUL, term, ConstantInteger::gen_i32(k));
+      res = bin(BinaryOp::ADD, res, term);
+    }
+    return res;
+  }
+};
+}  // namespace
+
+static void rewriteLoop(Function* func,
+                        Loop* loop,
+                        IndVar* indVar,
+                        const std::vector<Recurrence>& recurrences,
+                        int64_t maxIndex) {
+  const auto header = loop->header();
+  const auto preHeader = loop->getLoopPreheader();
+  const auto exit = *loop->exits().begin();
+  const auto beg = indVar->beginValue();
+  const auto end = indVar->endValue();
+  /* a modular recurrence needs 0 <= beg and end - 1 <= maxIndex */
+  const bool needsBegCheck = maxIndex < INT32_MAX and not beg->isa<ConstantInteger>();
+  const bool needsEndCheck = maxIndex < INT32_MAX - 1 and not end->isa<ConstantInteger>();
+  const bool keepLoop = needsBegCheck or needsEndCheck;
+
+  std::vector<BasicBlock*> newBlocks;
+  const auto newBlock = [&](const std::string& comment) {
+    const auto block = func->newBlock();
+    block->setComment(comment);
+    newBlocks.push_back(block);
+    return block;
+  };
+
+  IRBuilder builder;
+  const auto empty = newBlock("closed form empty loop");
+  builder.set_pos(empty, empty->insts().end());
+  builder.makeInst<BranchInst>(exit);
+  BasicBlock* fallback = nullptr;
+  if (keepLoop) {
+    fallback = newBlock("closed form fallback");
+    builder.set_pos(fallback, fallback->insts().end());
+    builder.makeInst<BranchInst>(header);
+    fixPhiIncomingBlock(header, preHeader, fallback);
+  }
+
+  auto cur = newBlock("closed form checks");
+  preHeader->insts().back()->dynCast<BranchInst>()->replaceDest(header, cur);
+  const auto check = [&](Value* lhs, ValueId cmp, Value* rhs, BasicBlock* otherwise) {
+    const auto next = newBlock("closed form checks");
+    builder.set_pos(cur, cur->insts().end());
+    builder.makeInst<BranchInst>(builder.makeInst<ICmpInst>(cmp, lhs, rhs), next, otherwise);
+    cur = next;
+  };
+  check(beg, vISLT, end, empty);
+  if (needsBegCheck) check(beg, vISGE, ConstantInteger::gen_i32(0), fallback);
+  if (needsEndCheck) check(end, vISLE, ConstantInteger::gen_i32(maxIndex + 1), fallback);
+
+  builder.set_pos(cur, cur->insts().end());
+  /* count is exact only in i64; the i32 difference is count mod 2^32, enough for i32 sums */
+  const auto count = builder.makeBinary(BinaryOp::SUB, end, beg);
+  ClosedFormBuilder closedForm{builder};
+  Value* count64 = nullptr;
+  std::unordered_map<Value*, Value*> finalValue{{indVar->phiinst(), end}};
+  for (auto& recurrence : recurrences) {
+    if (not recurrence.isGeometric()) {
+      finalValue[recurrence.phi] = closedForm.addRec(recurrence, beg, end, count);
+      continue;
+    }
+    /* x0 * c^n: acc *= bit * (base - 1) + 1, base *= base, n /= 2 until n == 0 */
+    const auto mod = recurrence.mod;
+    const auto type = mod ? Type::TypeInt64() : Type::TypeInt32();
+    const auto one = mod ? ConstantInteger::gen_i64(1) : ConstantInteger::gen_i32(1);
+    const auto reduce = [&](Value* val) {
+      return mod ? builder.makeBinary(BinaryOp::REM, val, ConstantInteger::gen_i64(mod)) : val;
+    };
+    Value* base0 = recurrence.rec.scale;
+    if (base0 == nullptr) {
+      base0 = mod ? ConstantInteger::gen_i64(recurrence.rec.a % mod)
+                  : ConstantInteger::gen_i32(recurrence.rec.a);
+    }
+    const auto acc0 = mod ? ConstantInteger::gen_i64(1 % mod) : one;
+    /* c^n depends on n itself, not on n mod 2^32, for even c */
+    if (count64 == nullptr)
+      count64 = builder.makeBinary(BinaryOp::SUB, closedForm.widen(end), closedForm.widen(beg));
+
+    const auto power = newBlock("closed form power");
+    const auto next = newBlock("closed form");
+    builder.makeInst<BranchInst>(power);
+    const auto acc = utils::make<PhiInst>(nullptr, type);
+    const auto base = utils::make<PhiInst>(nullptr, type);
+    const auto exp = utils::make<PhiInst>(nullptr, Type::TypeInt64());
+    for (auto phi : {exp, base, acc})
+      power->emplace_first_inst(phi);
+
+    builder.set_pos(power, power->insts().end());
+    Value* bit = builder.makeBinary(BinaryOp::REM, exp, ConstantInteger::gen_i64(2));
+    if (not mod) bit = builder.makeUnary(vTRUNC, bit, type);
+    const auto baseMinus1 = builder.makeBinary(BinaryOp::SUB, base, one);
+    const auto factor =
+      builder.makeBinary(BinaryOp::ADD, builder.makeBinary(BinaryOp::MUL, bit, baseMinus1), one);
+    const auto acc1 = reduce(builder.makeBinary(BinaryOp::MUL, acc, factor));
+    const auto base1 = reduce(builder.makeBinary(BinaryOp::MUL, base, base));
+    const auto exp1 = builder.makeBinary(BinaryOp::DIV, exp, ConstantInteger::gen_i64(2));
+    builder.makeInst<BranchInst>(
+      builder.makeInst<ICmpInst>(vISGT, exp1, ConstantInteger::gen_i64(0)), power, next);
+    acc->addIncoming(acc0, cur);
+    acc->addIncoming(acc1, power);
+    base->addIncoming(base0, cur);
+    base->addIncoming(base1, power);
+    exp->addIncoming(count64, cur);
+    exp->addIncoming(exp1, power);
+
+    cur = next;
+    builder.set_pos(cur, cur->insts().end());
+    if (mod) {
+      const auto x0 = closedForm.widen(recurrence.init);
+      const auto res = reduce(builder.makeBinary(BinaryOp::MUL, x0, acc1));
+      finalValue[recurrence.phi] = builder.makeUnary(vTRUNC, res, Type::TypeInt32());
+    } else {
+      finalValue[recurrence.phi] = builder.makeBinary(BinaryOp::MUL, recurrence.init, acc1);
+    }
+  }
+  builder.makeInst<BranchInst>(exit);
+
+  /* the loop results reach exit from the header, the empty loop and the closed form */
+  std::unordered_map<Value*, Value*> initValue{{indVar->phiinst(), beg}};
+  for (auto& recurrence : recurrences)
+    initValue[recurrence.phi] = recurrence.init;
+  for (auto [val, res] : finalValue) {
+    std::vector<Use*> outside;
+    for (auto use : val->uses()) {
+      const auto user = use->user()->as<Instruction>();
+      if (loop->contains(user->block())) continue;
+      if (user->block() != exit or not user->isa<PhiInst>()) outside.push_back(use);
+    }
+    if (outside.empty()) continue;
+    const auto merge = utils::make<PhiInst>(nullptr, val->type());
+    exit->emplace_first_inst(merge);
+    merge->addIncoming(val, header);
+    for (auto use : outside)
+      use->user()->setOperand(use->index(), merge);
+  }
+  for (auto inst : exit->phi_insts()) {
+    const auto phi = inst->as<PhiInst>();
+    const auto val = phi->getvalfromBB(header);
+    const bool isResult = finalValue.count(val);
+    phi->addIncoming(isResult ? initValue.at(val) : val, empty);
+    phi->addIncoming(isResult ? finalValue.at(val) : val, cur);
+  }
+
+  if (not keepLoop) {
+    for (auto inst : exit->phi_insts())
+      inst->as<PhiInst>()->delBlock(header);
+    for (auto block : loop->blocks())
+      func->forceDelBlock(block);
+  }
+  for (auto parent = loop->parentloop(); parent != nullptr; parent = parent->parentloop()) {
+    parent->blocks().insert(newBlocks.begin(), newBlocks.end());
+    if (not keepLoop) {
+      for (auto block : loop->blocks())
+        parent->blocks().erase(block);
+    }
+  }
+#ifdef DEBUG
+  std::cerr << "closed form of loop " << header->name() << ": " << recurrences.size()
+            << " recurrences" << (keepLoop ? ", guarded" : "") << std::endl;
+#endif
+}
+
+void LoopRecurrence::run(Function* func, TopAnalysisInfoManager* tp) {
+  if (func->isOnlyDeclare()) return;
+  const auto lpctx = tp->getLoopInfo(func);
+  const auto ivctx = tp->getIndVarInfo(func);
+
+  struct Candidate final {
+    Loop* loop;
+    IndVar* indVar;
+    std::vector<Recurrence> recurrences;
+    int64_t maxIndex;
+  };
+  /* only innermost loops qualify, rewriting one leaves the others' analyses valid */
+  std::vector<Candidate> candidates;
+  for (auto loop : lpctx->sortedLoops(true)) {
+    const auto indVar = ivctx->getIndvar(loop);
+    if (indVar == nullptr or not isCountedLoop(loop, indVar)) continue;
+
+    bool pure = true;
+    std::vector<PhiInst*> results;
+    for (auto block : loop->blocks()) {
+      for (auto inst : block->insts()) {
+        pure &= inst->isa<BinaryInst>() or inst->isa<UnaryInst>() or inst->isa<ICmpInst>() or
+                inst->isa<FCmpInst>() or inst->isa<PhiInst>() or inst->isa<BranchInst>();
+        for (auto use : inst->uses()) {
+          if (loop->contains(use->user()->as<Instruction>()->block())) continue;
+          const auto phi = inst->dynCast<PhiInst>();
+          if (phi and phi->block() == loop->header()) {
+            if (std::find(results.begin(), results.end(), phi) == results.end())
+              results.push_back(phi);
+          } else {
+            pure = false;
+          }
+        }
+      }
+    }
+    if (not pure) continue;
+
+    Candidate candidate{loop, indVar, {}, INT32_MAX};
+    for (auto phi : results) {
+      if (phi == indVar->phiinst()) continue;
+      auto recurrence = matchRecurrence(loop, indVar, phi);
+      if (not recurrence) {
+        pure = false;
+        break;
+      }
+      if (recurrence->mod and not recurrence->isGeometric())
+        candidate.maxIndex =
+          std::min(candidate.maxIndex, maxIndexOf(recurrence->rec.p, recurrence->mod));
+      candidate.recurrences.push_back(*recurrence);
+    }
+    if (not pure or candidate.recurrences.empty()) continue;
+
+    /* constant bounds are checked here, the others at runtime */
+    const auto begConst = indVar->beginValue()->dynCast<ConstantInteger>();
+    const auto endConst = indVar->endValue()->dynCast<ConstantInteger>();
+    if (begConst and endConst and begConst->i32() >= endConst->i32()) continue;
+    if (candidate.maxIndex < INT32_MAX) {
+      if (candidate.maxIndex < 0 or (begConst and begConst->i32() < 0)) continue;
+      if (endConst and endConst->i32() - 1 > candidate.maxIndex) continue;
+    }
+    candidates.push_back(std::move(candidate));
+  }
+  if (candidates.empty()) return;
+
+  for (auto& [loop, indVar, recurrences, maxIndex] : candidates)
+    rewriteLoop(func, loop, indVar, recurrences, maxIndex);
+  CFGAnalysisHHW().run(func, tp);
+  blockSortDFS(*func, tp);
+  tp->CFGChange(func);
+  tp->IndVarChange(func);
+}
+
+}  // namespace pass
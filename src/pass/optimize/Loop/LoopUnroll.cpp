@@ -1,5 +1,7 @@
 #include "pass/optimize/optimize.hpp"
 #include "pass/optimize/loopunroll.hpp"
+#include "pass/optimize/Loop/UnrollCostModel.hpp"
+#include "pass/analysis/MarkParallel.hpp"
 #include <set>
 #include <cassert>
 #include <map>
@@ -12,19 +14,6 @@ using namespace ir;
 namespace pass {
 std::unordered_map<Value*, Value*> LoopUnrollContext::copymap;
 
-int LoopUnrollContext::calunrolltime(Loop* loop, int times) {
-  int codecnt = 0;
-  for (auto bb : loop->blocks()) {
-    codecnt += bb->insts().size();
-  }
-  int unrolltimes = 2;
-  for (int i = 2; i <= (int)sqrt(times); i++) {
-    if (i * codecnt > 1000) break;
-    if (times % i == 0) unrolltimes = i;
-  }
-  return unrolltimes;
-}
-
 void LoopUnrollContext::loopdivest(Loop* loop, IndVar* iv, Function* func) {
   headuseouts.clear();
   BasicBlock* head = loop->header();
@@ -318,14 +307,14 @@ void LoopUnrollContext::dynamicunroll(Loop* loop, IndVar* iv) {
     return;  // 不考虑其他运算
   }
 
-  dodynamicunroll(loop, iv);
+  int unrolltimes = costmodel->unrollFactor(loop, -1);
+  if (unrolltimes < 2) return;
+  dodynamicunroll(loop, iv, unrolltimes);
 }
 
-void LoopUnrollContext::dodynamicunroll(Loop* loop, IndVar* iv) {
+void LoopUnrollContext::dodynamicunroll(Loop* loop, IndVar* iv, int unrolltimes) {
   headuseouts.clear();
   Function* func = loop->header()->function();
-  int unrolltimes = 4;  // 可以修改的超参数
-  // std::cerr << "dynamic unrolltimes: " << unrolltimes << std::endl;
 
   BasicBlock* head = loop->header();
   BasicBlock* latch = loop->getLoopLatch();
@@ -642,10 +631,8 @@ void LoopUnrollContext::dodynamicunroll(Loop* loop, IndVar* iv) {
     }
   }
 }
-void LoopUnrollContext::constunroll(Loop* loop, IndVar* iv) {
-  if (loop->exits().size() != 1)  // 只对单exit的loop做unroll
-    return;
-
+int LoopUnrollContext::consttimes(IndVar* iv) {  // 常数迭代次数, -1: 未知
+  if (!iv->isBeginVarConst() || !iv->isStepVarConst() || !isconstant(iv)) return -1;
   int ivbegin = iv->getBeginI32();
   int ivend = iv->endValue()->dynCast<ConstantValue>()->i32();
   int ivstep = iv->getStepI32();
@@ -653,7 +640,7 @@ void LoopUnrollContext::constunroll(Loop* loop, IndVar* iv) {
   Instruction* ivcmp = iv->cmpInst();
 
   if (!ivbinary->isInt32() || (ivstep == 0))  // 只考虑int循环,step为0退出
-    return;
+    return -1;
 
   int times = 0;
   if (ivbinary->valueId() == vADD) {
@@ -693,14 +680,19 @@ void LoopUnrollContext::constunroll(Loop* loop, IndVar* iv) {
   } else {
     times = -1;  // 不考虑其他运算
   }
+  return times;
+}
+
+void LoopUnrollContext::constunroll(Loop* loop, IndVar* iv) {
+  if (loop->exits().size() != 1)  // 只对单exit的loop做unroll
+    return;
+  int times = consttimes(iv);
   if (times <= 0) {
     return;
   }
-  // if (times <= 100) {
-  //     dofullunroll(loop, iv, times);
-  // } else {
-  doconstunroll(loop, iv, times);
-  // }
+  int unrolltimes = costmodel->unrollFactor(loop, times);
+  if (unrolltimes < 2) return;
+  doconstunroll(loop, iv, times, unrolltimes);
 }
 
 void LoopUnrollContext::insertremainderloop(Loop* loop, Function* func) {
@@ -886,11 +878,9 @@ void LoopUnrollContext::dofullunroll(Loop* loop, IndVar* iv, int times) {
   }
 }
 
-void LoopUnrollContext::doconstunroll(Loop* loop, IndVar* iv, int times) {
+void LoopUnrollContext::doconstunroll(Loop* loop, IndVar* iv, int times, int unrolltimes) {
   headuseouts.clear();
   Function* func = loop->header()->function();
-  int unrolltimes = calunrolltime(loop, times);
-  // unrolltimes = 2;//debug
   int remainder = times % unrolltimes;
   // std::cerr << "times: " << times << std::endl;
   // std::cerr << "unrolltimes: " << unrolltimes << std::endl;
@@ -1240,9 +1230,202 @@ bool LoopUnrollContext::isconstant(IndVar* iv) {  // 判断迭代的end是否为
   if (auto constiv = iv->endValue()->dynCast<ConstantValue>()) return true;
   return false;
 }
+// begin 出发沿唯一后继走到 end, 途中有分支或离开 loop 则返回空
+static std::vector<BasicBlock*> straightpath(BasicBlock* begin, BasicBlock* end, Loop* loop) {
+  std::vector<BasicBlock*> path;
+  for (auto bb = begin; path.size() < loop->blocks().size(); bb = bb->next_blocks().front()) {
+    if (!loop->contains(bb) || bb->next_blocks().size() != 1) return {};
+    path.push_back(bb);
+    if (bb == end) return path;
+  }
+  return {};
+}
+
+// val 是否依赖于 phi (只看 loop 内的指令)
+static bool dependson(Value* val, PhiInst* phi, Loop* loop, std::unordered_map<Value*, bool>& memo) {
+  if (val == phi) return true;
+  auto inst = val->dynCast<Instruction>();
+  if (!inst || !loop->contains(inst->block())) return false;
+  if (memo.count(inst)) return memo[inst];
+  memo[inst] = false;  // 断开 phi 环
+  bool res = false;
+  for (auto op : inst->operands()) {
+    if (dependson(op->value(), phi, loop, memo)) {
+      res = true;
+      break;
+    }
+  }
+  return memo[inst] = res;
+}
+
+/*
+ * unroll-and-jam: for i { A(i); for j { B(i, j) }; C(i) } 变为
+ * for i += u { A(i)..A(i+u-1); for j { B(i, j)..B(i+u-1, j) }; C(i)..C(i+u-1) }
+ * 要求: 外层可并行 (MarkParallel), 常数迭代次数被 u 整除, A/B/C 均为无分支的直线块,
+ * 内层边界与 i 无关, 且内层有与 i 无关的 load (拷贝间可复用)
+ */
+bool LoopUnrollContext::unrollandjam(Loop* loop, ParallelInfo* parallelctx) {
+  if (loop->subLoops().size() != 1) return false;
+  Loop* inner = *loop->subLoops().begin();
+  if (!inner->subLoops().empty()) return false;
+  IndVar* iv = ivctx->getIndvar(loop);
+  IndVar* inneriv = ivctx->getIndvar(inner);
+  if (!iv || !inneriv || !inneriv->isStepVarConst()) return false;
+  if (loop->exits().size() != 1 || inner->exits().size() != 1) return false;
+  if (!loop->isLoopSimplifyForm() || !inner->isLoopSimplifyForm()) return false;
+  if (!parallelctx->getIsParallel(loop->header())) return false;
+  int times = consttimes(iv);
+  if (times < 2) return false;
+
+  BasicBlock* head = loop->header();
+  BasicBlock* latch = loop->getLoopLatch();
+  BasicBlock* innerhead = inner->header();
+  BasicBlock* innerlatch = inner->getLoopLatch();
+  BasicBlock* innerpreheader = inner->getLoopPreheader();
+  BasicBlock* innerexit = *inner->exits().begin();
+  PhiInst* ivphi = iv->phiinst();
+  // i 是外层唯一的跨迭代值
+  if (head->phi_insts().size() != 1 || ivphi->getvalfromBB(latch) != iv->iterInst()) return false;
+  BasicBlock* body = nullptr;
+  BasicBlock* innerbody = nullptr;
+  for (auto bb : head->next_blocks()) {
+    if (loop->contains(bb)) body = bb;
+  }
+  for (auto bb : innerhead->next_blocks()) {
+    if (inner->contains(bb)) innerbody = bb;
+  }
+  if (!body || !innerbody) return false;
+  auto pre = straightpath(body, innerpreheader, loop);
+  auto post = straightpath(innerexit, latch, loop);
+  auto innerpath = straightpath(innerbody, innerlatch, inner);
+  if (pre.empty() || post.empty() || innerpath.empty()) return false;
+  if (pre.size() + post.size() + inner->blocks().size() + 1 != loop->blocks().size()) return false;
+  if (innerpath.size() + 1 != inner->blocks().size()) return false;
+
+  std::unordered_map<Value*, bool> memo;
+  for (auto val : {inneriv->beginValue(), inneriv->endValue()}) {
+    if (auto inst = val->dynCast<Instruction>(); inst && loop->contains(inst->block())) return false;
+  }
+  for (auto bb : loop->blocks()) {
+    if (bb != head && bb != innerhead && bb != innerexit && !bb->phi_insts().empty()) return false;
+    for (auto inst : bb->insts()) {
+      if (inst->isa<CallInst>()) return false;
+      if (inst != ivphi && inst != iv->iterInst() && definuseout(inst, loop)) return false;
+    }
+  }
+  bool reuse = false;
+  for (auto bb : inner->blocks()) {
+    for (auto inst : bb->insts()) {
+      if (auto load = inst->dynCast<LoadInst>()) reuse |= !dependson(load->ptr(), ivphi, loop, memo);
+    }
+  }
+  if (!reuse) return false;
+
+  // 外层 header 中除判断外的计算移入 A, 只允许无副作用的指令
+  std::vector<Instruction*> prework, innerheadwork, innerwork, postwork;
+  std::vector<PhiInst*> innerphis, exitphis;
+  for (auto inst : head->insts()) {
+    if (inst->isa<PhiInst>() || inst->isTerminator() || inst == iv->cmpInst()) continue;
+    if (inst->hasSideEffect()) return false;
+    prework.push_back(inst);
+  }
+  auto collect = [](const std::vector<BasicBlock*>& bbs, std::vector<Instruction*>& work) {
+    for (auto bb : bbs) {
+      for (auto inst : bb->insts()) {
+        if (!inst->isa<PhiInst>() && !inst->isTerminator()) work.push_back(inst);
+      }
+    }
+  };
+  collect(pre, prework);
+  collect({innerhead}, innerheadwork);
+  collect(innerpath, innerwork);
+  collect(post, postwork);
+  for (auto inst : innerhead->phi_insts()) {
+    if (inst != inneriv->phiinst()) innerphis.push_back(inst->dynCast<PhiInst>());
+  }
+  for (auto inst : innerexit->phi_insts())
+    exitphis.push_back(inst->dynCast<PhiInst>());
+
+  int unrolltimes = costmodel->jamFactor(loop, inner, times);
+  if (unrolltimes < 2) return false;
+
+  int ivstep = iv->getStepI32();
+  auto clone = [](const std::vector<Instruction*>& work, BasicBlock* dest) {
+    for (auto inst : work) {
+      auto copyinst = inst->copy(getValue);
+      copymap[inst] = copyinst;
+      dest->emplace_lastbutone_inst(copyinst);
+    }
+  };
+  for (int k = 1; k < unrolltimes; k++) {  // 第 k 份拷贝, i + k * step
+    copymap.clear();
+    auto ivk = utils::make<BinaryInst>(iv->iterInst()->valueId(), Type::TypeInt32(), ivphi,
+                                       ConstantInteger::gen_i32(k * ivstep));
+    innerpreheader->emplace_lastbutone_inst(ivk);
+    copymap[ivphi] = ivk;
+    clone(prework, innerpreheader);
+
+    for (auto phi : innerphis) {
+      auto copyphi = utils::make<PhiInst>(nullptr, phi->type());
+      innerhead->emplace_first_inst(copyphi);
+      copymap[phi] = copyphi;
+    }
+    clone(innerheadwork, innerhead);
+    clone(innerwork, innerlatch);
+    for (auto phi : innerphis) {
+      auto copyphi = copymap[phi]->dynCast<PhiInst>();
+      copyphi->addIncoming(getValue(phi->getvalfromBB(innerpreheader)), innerpreheader);
+      copyphi->addIncoming(getValue(phi->getvalfromBB(innerlatch)), innerlatch);
+    }
+
+    for (auto phi : exitphis) {
+      auto copyphi = utils::make<PhiInst>(nullptr, phi->type());
+      innerexit->emplace_first_inst(copyphi);
+      for (size_t i = 0; i < phi->getsize(); i++)
+        copyphi->addIncoming(getValue(phi->getValue(i)), phi->getBlock(i));
+      copymap[phi] = copyphi;
+    }
+    clone(postwork, latch);
+  }
+
+  // 修改迭代变量为 iv = iv + unrolltimes * step
+  auto iviter = iv->iterInst();
+  for (auto op : iviter->operands()) {
+    if (op->value() != ivphi) {
+      iviter->setOperand(op->index(), ConstantInteger::gen_i32(unrolltimes * ivstep));
+      break;
+    }
+  }
+  return true;
+}
+
 void LoopUnrollContext::run(Function* func, TopAnalysisInfoManager* tp) {
+  UnrollCostModel model(func);
+  costmodel = &model;
   lpctx = tp->getLoopInfo(func);
   ivctx = tp->getIndVarInfo(func);
+  // 先做 unroll-and-jam, jam 之后的内层循环再按下面的规则展开
+  bool hasnest = false;
+  for (auto loop : lpctx->loops()) {
+    if (loop->subLoops().size() == 1) hasnest = true;
+  }
+  if (hasnest) {
+    MarkParallel().run(func, tp);
+    auto parallelctx = tp->getParallelInfo(func);
+    lpctx = tp->getLoopInfo(func);
+    ivctx = tp->getIndVarInfo(func);
+    bool jammed = false;
+    const auto nests = lpctx->loops();
+    for (auto loop : nests) {
+      jammed |= unrollandjam(loop, parallelctx);
+    }
+    // jam 改写了循环与归纳变量, 内层展开需要新的分析结果
+    if (jammed) {
+      tp->CFGChange(func);
+      lpctx = tp->getLoopInfo(func);
+      ivctx = tp->getIndVarInfo(func);
+    }
+  }
   for (auto& loop : lpctx->loops()) {
     IndVar* iv = ivctx->getIndvar(loop);
     if (loop->subLoops().empty() && iv && iv->isBeginVarConst()) {
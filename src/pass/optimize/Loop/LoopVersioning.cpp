@@ -0,0 +1,372 @@
+#include "pass/optimize/Loop/LoopVersioning.hpp"
+#include "pass/analysis/ControlFlowGraph.hpp"
+#include "pass/analysis/dependenceAnalysis/DependenceAnalysis.hpp"
+#include "pass/optimize/Utils/BlockUtils.hpp"
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+
+using namespace ir;
+namespace pass {
+
+/*
+ * accessed range of a base address in the loop, in elements of the outermost gep:
+ * Object: the whole global/alloca; Affine: [beg+cmin, end+cmax) for p[i+c];
+ * Invariant: [idx, idx+1); Indirect: [b[beg], b[end-1]+1) for p[b[i]], b strictly increasing
+ */
+struct AccessRange final {
+  enum Kind { Object, Affine, Invariant, Indirect } kind;
+  Value* idx = nullptr;  // Invariant: the index, Indirect: the address b[i]
+  intmax_t cmin = 0, cmax = 0;
+  size_t elemSize = 0;
+};
+
+static size_t typeBytes(Type* type) {
+  if (auto arrayType = type->dynCast<ArrayType>()) {
+    size_t count = 1;
+    for (auto dim : arrayType->dims())
+      count *= dim;
+    return count * typeBytes(arrayType->baseType());
+  }
+  return type->size();
+}
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+/* the loop reads/writes memory only through geps and leaves values only to exit phis */
+static bool isVersionable(Loop* loop, IndVar* indVar) {
+  if (loop->exits().size() != 1 or loop->latchs().size() != 1) return false;
+  if (loop->getLoopPreheader() == nullptr) return false;
+  if (not indVar->getStep() or indVar->getStep()->i32() != 1) return false;
+  if (isDefinedIn(loop, indVar->beginValue()) or isDefinedIn(loop, indVar->endValue()))
+    return false;
+
+  /* i < end in the header, true stays in the loop */
+  const auto phi = indVar->phiinst();
+  const auto cmp = indVar->cmpInst()->dynCast<ICmpInst>();
+  if (cmp == nullptr or cmp->block() != loop->header()) return false;
+  const bool isLess = (cmp->valueId() == vISLT and cmp->lhs() == phi) or
+                      (cmp->valueId() == vISGT and cmp->rhs() == phi);
+  if (not isLess) return false;
+  const auto br = loop->header()->insts().back()->dynCast<BranchInst>();
+  if (br == nullptr or not br->is_cond() or br->cond() != cmp) return false;
+  if (not loop->contains(br->iftrue()) or loop->contains(br->iffalse())) return false;
+
+  const auto exit = *loop->exits().begin();
+  for (auto block : loop->blocks()) {
+    for (auto inst : block->insts()) {
+      if (auto load = inst->dynCast<LoadInst>()) {
+        if (not load->ptr()->isa<GetElementPtrInst>()) return false;
+      } else if (auto store = inst->dynCast<StoreInst>()) {
+        if (not store->ptr()->isa<GetElementPtrInst>()) return false;
+      } else if (auto call = inst->dynCast<CallInst>()) {
+        for (auto use : call->rargs()) {
+          if (use->value()->type()->isPointer()) return false;
+        }
+      }
+      for (auto use : inst->uses()) {
+        const auto user = use->user()->dynCast<Instruction>();
+        if (user == nullptr) return false;
+        if (loop->contains(user->block())) continue;
+        if (not user->isa<PhiInst>() or user->block() != exit) return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* ranges of all subaddrs of baseAddr, false if one of them can not be bounded */
+static bool collectRanges(Value* baseAddr,
+                          Loop* loop,
+                          IndVar* indVar,
+                          LoopDependenceInfo* depInfo,
+                          std::vector<AccessRange>& ranges) {
+  if (baseAddr->isa<GlobalVariable>() or baseAddr->isa<AllocaInst>()) {
+    const auto base = baseAddr->type()->dynCast<PointerType>()->baseType();
+    ranges.push_back({AccessRange::Object, nullptr, 0, 0, typeBytes(base)});
+    return true;
+  }
+  if (not baseAddr->isa<Argument>()) return false;
+
+  const auto phi = indVar->phiinst();
+  const auto indirectAddr = [&](Value* idx) -> GetElementPtrInst* {
+    const auto load = idx->dynCast<LoadInst>();
+    if (load == nullptr) return nullptr;
+    const auto gep = load->ptr()->dynCast<GetElementPtrInst>();
+    if (gep == nullptr or gep->index() != phi) return nullptr;
+    for (auto checked : depInfo->getMonotonicChecks()) {
+      if (checked->value() == gep->value()) return checked;
+    }
+    return nullptr;
+  };
+
+  std::optional<AccessRange> affine;
+  for (auto subAddr : depInfo->baseAddrToSubAddrSet(baseAddr)) {
+    auto outer = subAddr;
+    while (outer->value() != baseAddr) {
+      outer = outer->value()->dynCast<GetElementPtrInst>();
+      if (outer == nullptr) return false;
+    }
+    const auto elemSize = typeBytes(outer->baseType());
+    const auto idx = outer->index();
+
+    std::optional<intmax_t> offset;
+    if (idx == phi) {
+      offset = 0;
+    } else if (auto binary = idx->dynCast<BinaryInst>()) {
+      const auto lhs = binary->lValue(), rhs = binary->rValue();
+      if (binary->valueId() == vADD and lhs == phi and rhs->isa<ConstantInteger>())
+        offset = rhs->dynCast<ConstantInteger>()->i32();
+      else if (binary->valueId() == vADD and rhs == phi and lhs->isa<ConstantInteger>())
+        offset = lhs->dynCast<ConstantInteger>()->i32();
+      else if (binary->valueId() == vSUB and lhs == phi and rhs->isa<ConstantInteger>())
+        offset = -rhs->dynCast<ConstantInteger>()->i32();
+    }
+
+    AccessRange range;
+    if (offset) {
+      if (not affine) {
+        affine = AccessRange{AccessRange::Affine, nullptr, *offset, *offset + 1, elemSize};
+      } else {
+        if (affine->elemSize != elemSize) return false;
+        affine->cmin = std::min(affine->cmin, *offset);
+        affine->cmax = std::max(affine->cmax, *offset + 1);
+      }
+      continue;
+    } else if (not isDefinedIn(loop, idx)) {
+      range = {AccessRange::Invariant, idx, 0, 0, elemSize};
+    } else if (auto addr = indirectAddr(idx)) {
+      range = {AccessRange::Indirect, addr, 0, 0, elemSize};
+    } else {
+      return false;
+    }
+    const auto same = [&](const AccessRange& other) {
+      return other.kind == range.kind and other.idx == range.idx and
+             other.elemSize == range.elemSize;
+    };
+    if (std::none_of(ranges.begin(), ranges.end(), same)) ranges.push_back(range);
+  }
+  if (affine) ranges.push_back(*affine);
+  return not ranges.empty();
+}
+
+bool versionLoop(Function* func, Loop* loop, IndVar* indVar, TopAnalysisInfoManager* tp) {
+  /* alias pairs x ranges, each costs two compares */
+  constexpr size_t maxRangeChecks = 16;
+
+  const auto depInfo = tp->getDepInfoWithoutRefresh(func)->getLoopDependenceInfo(loop);
+  if (depInfo == nullptr or not depInfo->getIsParallelWithChecks()) return false;
+  if (not isVersionable(loop, indVar)) return false;
+
+  /* everything is bounded before the function is touched */
+  std::unordered_map<Value*, std::vector<AccessRange>> baseRanges;
+  size_t rangeChecks = 0;
+  for (auto [baseAddr1, baseAddr2] : depInfo->getAliasChecks()) {
+    for (auto baseAddr : {baseAddr1, baseAddr2}) {
+      if (baseRanges.count(baseAddr)) continue;
+      if (not collectRanges(baseAddr, loop, indVar, depInfo, baseRanges[baseAddr])) return false;
+    }
+    rangeChecks += baseRanges[baseAddr1].size() * baseRanges[baseAddr2].size();
+  }
+  if (rangeChecks > maxRangeChecks) return false;
+
+  const auto header = loop->header();
+  const auto preHeader = loop->getLoopPreheader();
+  const auto exit = *loop->exits().begin();
+  const auto phi = indVar->phiinst();
+  const auto beg = indVar->beginValue();
+  const auto end = indVar->endValue();
+  const auto i64 = Type::TypeInt64();
+
+  std::vector<BasicBlock*> newBlocks;
+  const auto newBlock = [&](const std::string& comment) {
+    const auto block = func->newBlock();
+    block->setComment(comment);
+    newBlocks.push_back(block);
+    return block;
+  };
+  const auto fallback = newBlock("versioning fallback");
+
+  IRBuilder builder;
+  auto cur = newBlock("versioning checks");
+  preHeader->insts().back()->dynCast<BranchInst>()->replaceDest(header, cur);
+
+  /* b[k] < b[k+1] for beg <= k < end-1 */
+  for (auto idxAddr : depInfo->getMonotonicChecks()) {
+    const auto checkHeader = newBlock("monotonic check");
+    const auto checkBody = newBlock("monotonic check body");
+    const auto next = newBlock("versioning checks");
+    builder.set_pos(cur, cur->insts().end());
+    builder.makeInst<BranchInst>(checkHeader);
+
+    const auto k = utils::make<PhiInst>(nullptr, phi->type());
+    checkHeader->emplace_first_inst(k);
+    builder.set_pos(checkHeader, checkHeader->insts().end());
+    const auto k1 = builder.makeBinary(BinaryOp::ADD, k, ConstantInteger::gen_i32(1));
+    const auto inRange = builder.makeInst<ICmpInst>(vISLT, k1, end);
+    builder.makeInst<BranchInst>(inRange, checkBody, next);
+
+    const auto loadAt = [&](Value* idx) {
+      const auto gep = idxAddr->copy([&](Value* val) { return val == phi ? idx : val; });
+      checkBody->emplace_back_inst(gep);
+      return builder.makeLoad(gep);
+    };
+    builder.set_pos(checkBody, checkBody->insts().end());
+    const auto lhs = loadAt(k);
+    const auto rhs = loadAt(k1);
+    const auto increasing = builder.makeInst<ICmpInst>(vISLT, lhs, rhs);
+    builder.makeInst<BranchInst>(increasing, checkHeader, fallback);
+
+    k->addIncoming(beg, cur);
+    k->addIncoming(k1, checkBody);
+    cur = next;
+  }
+
+  if (not depInfo->getAliasChecks().empty()) {
+    /* an empty loop may run either version, b[beg] is only read if it runs */
+    const auto rangeBlock = newBlock("alias checks");
+    builder.set_pos(cur, cur->insts().end());
+    builder.makeInst<BranchInst>(builder.makeInst<ICmpInst>(vISLT, beg, end), rangeBlock, fallback);
+    cur = rangeBlock;
+
+    builder.set_pos(cur, cur->insts().end());
+    const auto toI64 = [&](Value* val) -> Value* {
+      if (auto constant = val->dynCast<ConstantInteger>())
+        return ConstantInteger::gen_i64(constant->i32());
+      return builder.makeUnary(vSEXT, val, i64);
+    };
+    const auto loadAt = [&](Value* idxAddr, Value* idx) {
+      const auto gep = idxAddr->as<GetElementPtrInst>()->copy(
+        [&](Value* val) { return val == phi ? idx : val; });
+      cur->emplace_back_inst(gep);
+      return builder.makeLoad(gep);
+    };
+    const auto last = builder.makeBinary(BinaryOp::SUB, end, ConstantInteger::gen_i32(1));
+    /* [lo, hi) in bytes */
+    std::unordered_map<Value*, std::vector<std::pair<Value*, Value*>>> byteRanges;
+    for (auto& [baseAddr, ranges] : baseRanges) {
+      const auto base = builder.makeUnary(vPTRTOINT, baseAddr, i64);
+      const auto addrOf = [&](Value* elem, size_t elemSize) {
+        const auto offset =
+          builder.makeBinary(BinaryOp::MUL, elem, ConstantInteger::gen_i64(elemSize));
+        return builder.makeBinary(BinaryOp::ADD, base, offset);
+      };
+      const auto plus = [&](Value* val, intmax_t c) {
+        return builder.makeBinary(BinaryOp::ADD, val, ConstantInteger::gen_i64(c));
+      };
+      for (auto& range : ranges) {
+        switch (range.kind) {
+          case AccessRange::Object:
+            byteRanges[baseAddr].emplace_back(base, plus(base, range.elemSize));
+            break;
+          case AccessRange::Affine:
+            byteRanges[baseAddr].emplace_back(addrOf(plus(toI64(beg), range.cmin), range.elemSize),
+                                              addrOf(plus(toI64(end), range.cmax), range.elemSize));
+            break;
+          case AccessRange::Invariant: {
+            const auto lo = addrOf(toI64(range.idx), range.elemSize);
+            byteRanges[baseAddr].emplace_back(lo, plus(lo, range.elemSize));
+            break;
+          }
+          case AccessRange::Indirect: {
+            const auto first = toI64(loadAt(range.idx, beg));
+            const auto lastIdx = toI64(loadAt(range.idx, last));
+            byteRanges[baseAddr].emplace_back(addrOf(first, range.elemSize),
+                                              addrOf(plus(lastIdx, 1), range.elemSize));
+            break;
+          }
+        }
+      }
+    }
+
+    /* p.hi <= q.lo or q.hi <= p.lo */
+    for (auto [baseAddr1, baseAddr2] : depInfo->getAliasChecks()) {
+      for (auto [lo1, hi1] : byteRanges[baseAddr1]) {
+        for (auto [lo2, hi2] : byteRanges[baseAddr2]) {
+          const auto below = newBlock("alias check");
+          const auto next = newBlock("alias checks");
+          builder.set_pos(cur, cur->insts().end());
+          builder.makeInst<BranchInst>(builder.makeInst<ICmpInst>(vISLE, hi1, lo2), next, below);
+          builder.set_pos(below, below->insts().end());
+          builder.makeInst<BranchInst>(builder.makeInst<ICmpInst>(vISLE, hi2, lo1), next, fallback);
+          cur = next;
+        }
+      }
+    }
+  }
+  builder.set_pos(cur, cur->insts().end());
+  builder.makeInst<BranchInst>(header);
+  for (auto inst : header->phi_insts()) {
+    inst->as<PhiInst>()->replaceoldtonew(preHeader, cur);
+  }
+
+  /* the serial clone, entered from fallback */
+  std::unordered_map<Value*, Value*> valueMap;
+  valueMap.emplace(preHeader, fallback);
+  for (auto block : loop->blocks()) {
+    valueMap.emplace(block, newBlock("versioning clone"));
+  }
+  const auto getValue = [&](Value* val) -> Value* {
+    if (auto iter = valueMap.find(val); iter != valueMap.end()) return iter->second;
+    return val;
+  };
+  std::vector<Instruction*> copies;
+  std::vector<PhiInst*> phis;
+  for (auto block : loop->blocks()) {
+    const auto blockCpy = valueMap.at(block)->as<BasicBlock>();
+    for (auto inst : block->insts()) {
+      const auto copy = inst->copy(getValue);
+      blockCpy->emplace_back_inst(copy);
+      valueMap.emplace(inst, copy);
+      if (auto phiInst = inst->dynCast<PhiInst>())
+        phis.push_back(phiInst);
+      else
+        copies.push_back(copy);
+    }
+  }
+  /* operands defined in blocks copied later */
+  for (auto copy : copies) {
+    for (auto op : copy->operands()) {
+      if (getValue(op->value()) != op->value()) copy->setOperand(op->index(), getValue(op->value()));
+    }
+  }
+  for (auto phiInst : phis) {
+    const auto phiCpy = valueMap.at(phiInst)->as<PhiInst>();
+    for (size_t idx = 0; idx < phiInst->getsize(); idx++) {
+      phiCpy->addIncoming(getValue(phiInst->getValue(idx)),
+                          getValue(phiInst->getBlock(idx))->as<BasicBlock>());
+    }
+  }
+  for (auto inst : exit->phi_insts()) {
+    const auto phiInst = inst->as<PhiInst>();
+    std::vector<std::pair<Value*, BasicBlock*>> incomings;
+    for (size_t idx = 0; idx < phiInst->getsize(); idx++) {
+      if (loop->contains(phiInst->getBlock(idx)))
+        incomings.emplace_back(phiInst->getValue(idx), phiInst->getBlock(idx));
+    }
+    for (auto [val, block] : incomings) {
+      phiInst->addIncoming(getValue(val), getValue(block)->as<BasicBlock>());
+    }
+  }
+  builder.set_pos(fallback, fallback->insts().end());
+  builder.makeInst<BranchInst>(valueMap.at(header)->as<BasicBlock>());
+
+  for (auto parent = loop->parentloop(); parent != nullptr; parent = parent->parentloop()) {
+    parent->blocks().insert(newBlocks.begin(), newBlocks.end());
+  }
+#ifdef DEBUG
+  std::cerr << "versioned loop " << header->name() << ": "
+            << depInfo->getMonotonicChecks().size() << " monotonic checks, " << rangeChecks
+            << " range checks" << std::endl;
+#endif
+  CFGAnalysisHHW().run(func, tp);
+  blockSortDFS(*func, tp);
+  tp->CFGChange(func);
+  tp->IndVarChange(func);
+  return true;
+}
+
+}  // namespace pass
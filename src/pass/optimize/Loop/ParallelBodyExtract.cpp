@@ -12,6 +12,8 @@
 #include "support/arena.hpp"
 #include "support/utils.hpp"
 
+#include <numeric>
+
 using namespace ir;
 
 namespace pass {
@@ -22,11 +24,32 @@ static auto getUniqueID() {
   return base + std::to_string(id++);
 }
 
-static auto getStorageUniqueID() {
-  static size_t id = 0;
-  const auto base = "parallel_body_payload";
-  return base + std::to_string(id++);
+/*
+ * chunk alignment hint: the runtime splits [beg, end) at multiples of this many
+ * iterations, so two workers never store to the same cache line of an array
+ * indexed by the indvar. For each such store, one line holds 64 / gcd(stride, 64)
+ * consecutive iterations; take the largest, capped at one line of i32.
+ */
+static constexpr uint32_t cacheLineSize = 64;
+static uint32_t computeChunkAlignment(Function* loopBody) {
+  const auto indVarArg = loopBody->arg_i(0);
+  uint32_t alignment = 1;
+  for (auto block : loopBody->blocks()) {
+    for (auto inst : block->insts()) {
+      const auto store = inst->dynCast<StoreInst>();
+      if (not store) continue;
+      for (auto ptr = store->ptr(); auto gep = ptr->dynCast<GetElementPtrInst>();
+           ptr = gep->value()) {
+        if (gep->index() != indVarArg) continue;
+        const auto stride = static_cast<uint32_t>(gep->baseType()->size());
+        if (stride == 0) continue;
+        alignment = std::max(alignment, cacheLineSize / std::gcd(stride, cacheLineSize));
+      }
+    }
+  }
+  return std::min<uint32_t>(alignment, cacheLineSize / 4);
 }
+
 /*
 after extract loop body:
   preheader -> header -> call_block -> latch -> exit
@@ -35,13 +58,17 @@ after extract loop body:
 
 after extract parallel body:
   preheader -> call_block -> exit
-  call parallel_body(beg, end)
+  payload = alloca [n x i32]; store otherargs to payload
+  call parallel_body(beg, end, payload)
 
-  parallel_body(beg, end)
+  parallel_body(beg, end, payload)
     for (i = beg; i < end; i++) {
-      loop_body(i, otherargs...)
+      loop_body(i, load otherargs from payload...)
     }
 
+the payload lives in the caller's frame: the body is reentrant (nested or
+recursive calls each have their own captures)
+
 */
 // build parallelBody function
 /*
@@ -55,31 +82,10 @@ auto buildParallelBodyBeta(Module& module,
                            LoopBodyInfo& loopBodyInfo,
                            ParallelBodyInfo& parallelBodyInfo /* ret */) {
   const auto i32 = Type::TypeInt32();
-  auto funcType = FunctionType::gen(Type::void_type(), {i32, i32});
-  auto parallelBody = module.addFunction(funcType, getUniqueID());
-  parallelBody->attribute().addAttr(FunctionAttribute::ParallelBody);
-  auto argBeg = parallelBody->new_arg(i32, "beg");
-  auto argEnd = parallelBody->new_arg(i32, "end");
-
-  auto newEntry = parallelBody->newEntry("new_entry");
-  auto newExit = parallelBody->newExit("new_exit");
-  std::unordered_set<BasicBlock*> bodyBlocks = {loopBodyInfo.header, loopBodyInfo.body,
-                                                loopBodyInfo.latch};
-  // add loop blocks to parallel_body
-  for (auto block : bodyBlocks) {
-    block->set_parent(parallelBody);
-    parallelBody->blocks().push_back(block);
-  }
-  // build parallel_body
-  IRBuilder builder;
-  builder.set_pos(newEntry, newEntry->insts().end());
-  // non constant, gloabal value used in loop_body, must pass by global payload
-  // fix loop_body(i, otherargs...)
-  // args must pass through global var, Value* -> offset
+  // captures are laid out once all loop_body args are known, the body takes a
+  // pointer to the caller's payload
   std::vector<std::pair<Value*, size_t>> payload;
-  size_t totalSize = 0;  // bytes
-  const auto f32 = Type::TypeFloat32();
-
+  size_t totalSize = 4;  // bytes, word 0: chunk alignment hint
   std::unordered_set<Value*> inserted;
   // align by 32 bits, 4 bytes
   const size_t align = 4;
@@ -93,6 +99,7 @@ auto buildParallelBodyBeta(Module& module,
       return;
     }
     if (inserted.count(arg)) return;  // already in
+    inserted.insert(arg);
     // pass by payload
     const auto size = arg->type()->size();
     totalSize = utils::alignTo(totalSize, align);
@@ -116,9 +123,30 @@ auto buildParallelBodyBeta(Module& module,
   }
   const auto totalWords = totalSize / 4;
   const auto payloadType = ArrayType::gen(Type::TypeInt32(), {totalWords}, totalWords);  // by word?
-  const auto payloadStorage = utils::make<GlobalVariable>(payloadType, getStorageUniqueID());
-  module.addGlobalVar(payloadStorage->name(), payloadStorage);
-  const auto payloadBase = builder.makeUnary(ValueId::vPTRTOINT, payloadStorage, Type::TypeInt64());
+
+  auto funcType =
+    FunctionType::gen(Type::void_type(), {i32, i32, Type::TypePointer(payloadType)});
+  auto parallelBody = module.addFunction(funcType, getUniqueID());
+  parallelBody->attribute().addAttr(FunctionAttribute::ParallelBody);
+  auto argBeg = parallelBody->new_arg(i32, "beg");
+  auto argEnd = parallelBody->new_arg(i32, "end");
+  auto argPayload = parallelBody->new_arg(Type::TypePointer(payloadType), "payload");
+
+  auto newEntry = parallelBody->newEntry("new_entry");
+  auto newExit = parallelBody->newExit("new_exit");
+  std::unordered_set<BasicBlock*> bodyBlocks = {loopBodyInfo.header, loopBodyInfo.body,
+                                                loopBodyInfo.latch};
+  // add loop blocks to parallel_body
+  for (auto block : bodyBlocks) {
+    block->set_parent(parallelBody);
+    parallelBody->blocks().push_back(block);
+  }
+  // build parallel_body
+  IRBuilder builder;
+  builder.set_pos(newEntry, newEntry->insts().end());
+  // non constant value used in loop_body, must pass by payload
+  // fix loop_body(i, otherargs...): Value* -> offset in payload
+  const auto payloadBase = builder.makeUnary(ValueId::vPTRTOINT, argPayload, Type::TypeInt64());
 
   // const auto giv = (loopBodyInfo.giv ? )
   // fix call loop_body(i, others)
@@ -245,8 +273,9 @@ auto buildParallelBodyBeta(Module& module,
 
   parallelBodyInfo.parallelBody = parallelBody;
   parallelBodyInfo.payload = payload;
-  parallelBodyInfo.payloadStorage = payloadStorage;
+  parallelBodyInfo.payloadType = payloadType;
   parallelBodyInfo.givOffset = givOffset;
+  parallelBodyInfo.chunkAlignment = computeChunkAlignment(loopBodyInfo.callInst->callee());
   return parallelBody;
 }
 
@@ -268,10 +297,20 @@ auto rebuildFunc(Function* func,
 
   // callBlock
   builder.set_pos(callBlock, callBlock->insts().end());
+  // payload in the frame of func
+  parallelBodyInfo.payloadStorage = builder.makeAlloca(parallelBodyInfo.payloadType);
   // store payload
   const auto base =
     builder.makeUnary(ValueId::vPTRTOINT, parallelBodyInfo.payloadStorage, Type::TypeInt64());
   parallelBodyInfo.payloadStoreInsts.emplace_back(base);
+  {
+    auto ptr = builder.makeBinary(BinaryOp::ADD, base, ConstantInteger::gen_i64(0));
+    auto typeptr = builder.makeUnary(ValueId::vINTTOPTR, ptr, Type::TypePointer(Type::TypeInt32()));
+    auto store = builder.makeInst<StoreInst>(
+      ConstantInteger::gen_i32(static_cast<int32_t>(parallelBodyInfo.chunkAlignment)), typeptr);
+    parallelBodyInfo.payloadStoreInsts.insert(parallelBodyInfo.payloadStoreInsts.end(),
+                                              {ptr, typeptr, store});
+  }
 
   for (auto [value, offset] : parallelBodyInfo.payload) {
     auto ptr = builder.makeBinary(BinaryOp::ADD, base, ConstantInteger::gen_i64(offset));
@@ -280,18 +319,23 @@ auto rebuildFunc(Function* func,
     parallelBodyInfo.payloadStoreInsts.insert(parallelBodyInfo.payloadStoreInsts.end(),
                                               {ptr, typeptr, store});
   }
+  // giv: workers atomically add their partial sums to a zeroed slot
+  if (loopBodyInfo.giv) {
+    auto ptr = builder.makeBinary(BinaryOp::ADD, base, parallelBodyInfo.givOffset);
+    ptr = builder.makeUnary(ValueId::vINTTOPTR, ptr, Type::TypePointer(loopBodyInfo.giv->type()));
+    builder.makeInst<StoreInst>(ConstantInteger::gen_i32(0), ptr);
+  }
 
-  // call parallel_body(beg, end)
-  auto callArgs = std::vector<Value*>{indVar->beginValue(), indVar->endValue()};
+  // call parallel_body(beg, end, payload)
+  auto callArgs = std::vector<Value*>{indVar->beginValue(), indVar->endValue(),
+                                      parallelBodyInfo.payloadStorage};
   auto callInst = builder.makeInst<CallInst>(parallelBodyInfo.parallelBody, callArgs);
 
   // builder.set_pos(loopBodyInfo.exit, loopBodyInfo.exit->insts().begin());
   // giv
   Value* newGiv = nullptr;
   if (loopBodyInfo.giv) {
-    const auto payloadBase =
-      builder.makeUnary(ValueId::vPTRTOINT, parallelBodyInfo.payloadStorage, Type::TypeInt64());
-    auto ptr = builder.makeBinary(BinaryOp::ADD, payloadBase, parallelBodyInfo.givOffset);
+    auto ptr = builder.makeBinary(BinaryOp::ADD, base, parallelBodyInfo.givOffset);
     ptr = builder.makeUnary(ValueId::vINTTOPTR, ptr, Type::TypePointer(loopBodyInfo.giv->type()));
     newGiv = builder.makeLoad(ptr);
   }
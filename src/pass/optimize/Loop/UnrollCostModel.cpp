@@ -0,0 +1,287 @@
+#include "pass/optimize/Loop/UnrollCostModel.hpp"
+#include "support/Hyperparameters.hpp"
+#include "support/LoopProfileData.hpp"
+#include "target/riscv/RISCVLatency.hpp"
+
+#include <algorithm>
+#include <functional>
+
+using namespace ir;
+
+namespace pass {
+namespace u74 = mir::RISCV::latency;
+
+static utils::Parameter<uint32_t> UnrollMaxBodyInsts{
+  "unroll.max-body-insts", 1000, "max instructions of an unrolled loop body"};
+static utils::Parameter<uint32_t> UnrollMaxFactor{"unroll.max-factor", 8,
+                                                  "max unroll factor, 0: unlimited"};
+static utils::Parameter<uint32_t> UnrollTargetBodyInsts{
+  "unroll.target-body-insts", 32, "unroll small bodies up to this many instructions"};
+static utils::Parameter<uint32_t> UnrollFunctionBudget{
+  "unroll.function-budget", 3000, "max instructions of a function after unrolling"};
+static utils::Parameter<uint32_t> UnrollIntRegs{
+  "unroll.int-regs", 24, "integer registers an unrolled body may keep live"};
+static utils::Parameter<uint32_t> UnrollFPRegs{"unroll.fp-regs", 28,
+                                               "fp registers an unrolled body may keep live"};
+static utils::Parameter<double> UnrollMinFrequency{
+  "unroll.min-frequency", 8, "estimated header executions below which a loop is cold"};
+static utils::Parameter<double> UnrollMinHotness{
+  "unroll.min-hotness", 0.001, "profiled share of the run below which a loop is cold"};
+static utils::Parameter<uint32_t> UnrollJamMaxFactor{"unroll.jam-max-factor", 4,
+                                                     "max unroll-and-jam factor, 0: off"};
+
+/* trips assumed for a loop without a constant trip count */
+static constexpr double UnknownTrips = 10;
+
+UnrollCostModel::UnrollCostModel(Function* func) {
+  uint32_t size = 0;
+  for (auto block : func->blocks())
+    size += block->insts().size();
+  mBudget = size < UnrollFunctionBudget ? UnrollFunctionBudget - size : 0;
+}
+
+uint32_t UnrollCostModel::latency(Instruction* inst) {
+  switch (inst->valueId()) {
+    case vLOAD:
+      return inst->isFloatPoint() ? u74::FPLoad : u74::Load;
+    case vMUL:
+      return u74::IntMul;
+    case vSDIV:
+    case vUDIV:
+    case vSREM:
+    case vUREM:
+      return u74::IntDivW;
+    case vFADD:
+    case vFSUB:
+    case vFMUL:
+      return u74::FPArith;
+    case vFDIV:
+    case vFREM:
+      return u74::FPDiv;
+    case vFNEG:
+    case vSITOFP:
+      return u74::FPMove;
+    case vFPTOSI:
+      return u74::FPCompare;
+    default:
+      break;
+  }
+  if (inst->isa<FCmpInst>()) return u74::FPCompare;
+  if (inst->isVoid() or inst->isa<PhiInst>()) return 0;
+  return u74::IntAluEarly;
+}
+
+LoopBodyStats UnrollCostModel::analyze(Loop* loop) {
+  LoopBodyStats stats;
+  const auto loopInst = [&](Value* val) -> Instruction* {
+    const auto inst = val->dynCast<Instruction>();
+    return inst and loop->contains(inst->block()) ? inst : nullptr;
+  };
+  const auto isCarried = [&](Instruction* inst) {
+    return inst->isa<PhiInst>() and inst->block() == loop->header();
+  };
+  const auto count = [](Value* val, uint32_t& intCount, uint32_t& fpCount) {
+    (val->isFloatPoint() ? fpCount : intCount)++;
+  };
+
+  std::unordered_set<Value*> invariants;
+  for (auto block : loop->blocks()) {
+    stats.insts += block->insts().size();
+    for (auto inst : block->insts()) {
+      stats.hasCall |= inst->isa<CallInst>();
+      for (auto op : inst->operands()) {
+        const auto val = op->value();
+        const bool outside = val->isa<Argument>() or (val->isa<Instruction>() and not loopInst(val));
+        if (outside and invariants.insert(val).second)
+          count(val, stats.intInvariants, stats.fpInvariants);
+      }
+    }
+  }
+  for (auto phi : loop->header()->phi_insts())
+    count(phi, stats.intCarried, stats.fpCarried);
+
+  /* peak of simultaneously live body-local values, per block: [def, last use] */
+  for (auto block : loop->blocks()) {
+    std::unordered_map<Instruction*, std::pair<size_t, size_t>> ranges;
+    const auto end = block->insts().size() + 1;
+    size_t pos = 0;
+    for (auto inst : block->insts()) {
+      pos++;
+      if (not inst->isa<PhiInst>()) {
+        for (auto op : inst->operands()) {
+          const auto def = loopInst(op->value());
+          if (def == nullptr or isCarried(def)) continue;
+          auto [iter, fresh] = ranges.try_emplace(def, 0, pos);
+          if (not fresh) iter->second.second = std::max(iter->second.second, pos);
+        }
+      }
+      if (inst->isVoid() or isCarried(inst)) continue;
+      size_t last = pos;
+      for (auto use : inst->uses()) {
+        const auto user = use->user()->dynCast<Instruction>();
+        if (user and (user->block() != block or user->isa<PhiInst>())) last = end;
+      }
+      ranges[inst] = {pos, last};
+    }
+    std::vector<int32_t> intDelta(end + 2), fpDelta(end + 2);
+    for (auto& [val, range] : ranges) {
+      auto& delta = val->isFloatPoint() ? fpDelta : intDelta;
+      delta[range.first]++;
+      delta[range.second + 1]--;
+    }
+    int32_t intLive = 0, fpLive = 0;
+    for (size_t idx = 0; idx < intDelta.size(); idx++) {
+      intLive += intDelta[idx];
+      fpLive += fpDelta[idx];
+      stats.intPeak = std::max(stats.intPeak, static_cast<uint32_t>(std::max(intLive, 0)));
+      stats.fpPeak = std::max(stats.fpPeak, static_cast<uint32_t>(std::max(fpLive, 0)));
+    }
+  }
+
+  /* longest dependence chain of one iteration; phis start it */
+  std::unordered_map<Instruction*, uint32_t> depth;
+  std::function<uint32_t(Instruction*)> chain = [&](Instruction* inst) -> uint32_t {
+    if (inst->isa<PhiInst>()) return 0;
+    if (const auto iter = depth.find(inst); iter != depth.end()) return iter->second;
+    uint32_t longest = 0;
+    for (auto op : inst->operands()) {
+      if (const auto def = loopInst(op->value())) longest = std::max(longest, chain(def));
+    }
+    return depth[inst] = longest + latency(inst);
+  };
+  for (auto block : loop->blocks()) {
+    for (auto inst : block->insts())
+      stats.criticalPath = std::max(stats.criticalPath, chain(inst));
+  }
+
+  /* recurrences: longest chain from a header phi to its value on the back edge */
+  const auto latch = loop->getLoopLatch();
+  if (latch == nullptr) return stats;
+  for (auto phiInst : loop->header()->phi_insts()) {
+    const auto phi = phiInst->dynCast<PhiInst>();
+    std::unordered_map<Instruction*, int32_t> fromPhi;
+    std::function<int32_t(Instruction*)> carried = [&](Instruction* inst) -> int32_t {
+      if (inst == phi) return 0;
+      if (inst->isa<PhiInst>()) return -1;
+      if (const auto iter = fromPhi.find(inst); iter != fromPhi.end()) return iter->second;
+      int32_t longest = -1;
+      for (auto op : inst->operands()) {
+        if (const auto def = loopInst(op->value())) longest = std::max(longest, carried(def));
+      }
+      return fromPhi[inst] =
+               longest < 0 ? -1 : longest + static_cast<int32_t>(latency(inst));
+    };
+    if (const auto next = loopInst(phi->getvalfromBB(latch))) {
+      stats.recurrence = std::max(stats.recurrence, static_cast<uint32_t>(std::max(carried(next), 0)));
+    }
+  }
+  return stats;
+}
+
+double UnrollCostModel::frequency(Loop* loop, int tripCount) {
+  if (const auto record = utils::LoopProfileData::get().find(loop->header())) {
+    return static_cast<double>(record->trips);
+  }
+  double freq = tripCount > 0 ? tripCount : UnknownTrips;
+  for (auto outer = loop->parentloop(); outer; outer = outer->parentloop())
+    freq *= UnknownTrips;
+  return freq;
+}
+
+bool UnrollCostModel::isCold(Loop* loop, int tripCount) {
+  const auto& profile = utils::LoopProfileData::get();
+  if (not profile.empty()) {
+    const auto record = profile.find(loop->header());
+    if (record and profile.totalCycles()) return profile.hotness(*record) < UnrollMinHotness;
+    const auto funcRecord = profile.function(loop->header()->function()->name());
+    if (funcRecord and funcRecord->calls == 0) return true;
+  }
+  return frequency(loop, tripCount) < UnrollMinFrequency;
+}
+
+uint32_t UnrollCostModel::unrollFactor(Loop* loop, int tripCount) {
+  if (isCold(loop, tripCount)) return 1;
+  const auto stats = analyze(loop);
+  if (stats.insts == 0) return 1;
+
+  /* latency: copies in flight to cover the critical path at the issue or recurrence bound */
+  const auto issue = (stats.insts + u74::IssueWidth - 1) / u74::IssueWidth;
+  const auto bound = std::max(issue, stats.recurrence);
+  uint32_t factor = (stats.criticalPath + bound - 1) / bound;
+  /* small bodies: amortize the increment, compare and branch */
+  factor = std::max(factor, (UnrollTargetBodyInsts + stats.insts - 1) / stats.insts);
+  /* recurrence bound: more copies only lengthen the chain */
+  if (stats.recurrence >= stats.criticalPath and stats.recurrence > issue) factor = 2;
+  /* calls clobber the caller-saved registers, little to overlap */
+  if (stats.hasCall) factor = std::min(factor, 2u);
+  if (UnrollMaxFactor) factor = std::min<uint32_t>(factor, UnrollMaxFactor);
+  if (tripCount > 0) factor = std::min(factor, static_cast<uint32_t>(tripCount));
+
+  const auto fits = [&](uint32_t candidate) {
+    return stats.intInvariants + stats.intCarried + candidate * stats.intPeak <= UnrollIntRegs and
+           stats.fpInvariants + stats.fpCarried + candidate * stats.fpPeak <= UnrollFPRegs and
+           candidate * stats.insts <= UnrollMaxBodyInsts;
+  };
+  while (factor > 1 and not fits(factor))
+    factor--;
+  /* a divisor of the trip count saves the remainder loop */
+  if (tripCount > 0) {
+    for (auto candidate = factor; candidate > 1 and 2 * candidate >= factor; candidate--) {
+      if (tripCount % candidate == 0) {
+        factor = candidate;
+        break;
+      }
+    }
+  }
+  const auto growth = [&](uint32_t candidate) {
+    const bool remainder = tripCount <= 0 or tripCount % candidate != 0;
+    return (candidate - 1) * stats.insts + (remainder ? stats.insts : 0);
+  };
+  while (factor > 1 and growth(factor) > mBudget)
+    factor--;
+  if (factor < 2) return 1;
+  mBudget -= growth(factor);
+  return factor;
+}
+
+uint32_t UnrollCostModel::jamFactor(Loop* outer, Loop* inner, int tripCount) {
+  if (UnrollJamMaxFactor < 2 or tripCount < 2 or isCold(inner, -1)) return 1;
+  const auto outerStats = analyze(outer);
+  const auto innerStats = analyze(inner);
+
+  /* inner invariants defined in the outer body are per copy, the others are shared */
+  uint32_t intShared = 0, fpShared = 0;
+  std::unordered_set<Value*> seen;
+  for (auto block : inner->blocks()) {
+    for (auto inst : block->insts()) {
+      for (auto op : inst->operands()) {
+        const auto val = op->value();
+        const auto def = val->dynCast<Instruction>();
+        const bool shared = val->isa<Argument>() or (def and not outer->contains(def->block()));
+        if (shared and seen.insert(val).second) (val->isFloatPoint() ? fpShared : intShared)++;
+      }
+    }
+  }
+  const auto live = [&](uint32_t invariants, uint32_t shared, uint32_t carried, uint32_t peak,
+                        uint32_t candidate) {
+    return shared + candidate * (invariants - shared + carried + peak);
+  };
+  /* the inner induction variable stays shared */
+  const auto intCarried = innerStats.intCarried ? innerStats.intCarried - 1 : 0;
+  for (uint32_t factor = std::min<uint32_t>(UnrollJamMaxFactor, tripCount); factor > 1; factor--) {
+    if (tripCount % factor) continue;
+    if (1 + live(innerStats.intInvariants, intShared, intCarried, innerStats.intPeak, factor) >
+        UnrollIntRegs)
+      continue;
+    if (live(innerStats.fpInvariants, fpShared, innerStats.fpCarried, innerStats.fpPeak, factor) >
+        UnrollFPRegs)
+      continue;
+    if (factor * innerStats.insts > UnrollMaxBodyInsts) continue;
+    const auto growth = (factor - 1) * outerStats.insts;
+    if (growth > mBudget) continue;
+    mBudget -= growth;
+    return factor;
+  }
+  return 1;
+}
+}  // namespace pass
@@ -0,0 +1,368 @@
+#include "pass/optimize/Misc/GlobalArrayLayout.hpp"
+#include "support/Hyperparameters.hpp"
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+using namespace ir;
+namespace pass {
+static utils::Parameter<bool> LayoutTranspose{
+  "layout.transpose", true, "transpose global 2-d arrays walked by column"};
+static utils::Parameter<uint32_t> LayoutPadStride{
+  "layout.pad-stride", 512, "pad rows of global arrays that are a multiple of this, 0: off"};
+static utils::Parameter<bool> LayoutInterleave{
+  "layout.interleave", true, "interleave global 1-d arrays accessed together"};
+
+/* sifive-u74 L1D and L2 line */
+static constexpr size_t CacheLineBytes = 64;
+/* elements appended to a padded row: one line of words */
+static constexpr size_t PadElements = CacheLineBytes / 4;
+
+static size_t product(const std::vector<size_t>& dims) {
+  size_t count = 1;
+  for (auto dim : dims)
+    count *= dim;
+  return count;
+}
+
+static void insertBefore(Instruction* pos, Instruction* inst) {
+  auto& insts = pos->block()->insts();
+  pos->block()->emplace_inst(std::find(insts.begin(), insts.end(), pos), inst);
+}
+
+namespace {
+/* a load or store address: the gep chain from the global, one index per dimension */
+struct Access final {
+  GetElementPtrInst* leaf;
+  std::vector<Value*> indices;
+  Loop* loop;  // innermost loop around the leaf, nullptr: none
+  PhiInst* phi;  // induction variable of loop, nullptr: none
+};
+
+/* the new shape of one array: new index k is old index perm[k], last dim padded */
+struct Layout final {
+  std::vector<size_t> perm;
+  size_t pad = 0;
+};
+
+class AccessCollector final {
+  TopAnalysisInfoManager* mTp;
+  std::unordered_map<Function*, std::pair<LoopInfo*, IndVarInfo*>> mCtx;
+
+  std::pair<LoopInfo*, IndVarInfo*> ctxOf(Function* func) {
+    auto iter = mCtx.find(func);
+    if (iter == mCtx.end())
+      iter = mCtx.emplace(func, std::pair{mTp->getLoopInfo(func), mTp->getIndVarInfo(func)}).first;
+    return iter->second;
+  }
+
+  /* constants, induction variables, values fixed in loop; +, -, * constant of those */
+  bool isAffine(Value* val, Loop* loop, LoopInfo* lpctx, IndVarInfo* ivctx) {
+    if (val->isa<ConstantValue>() or val->isa<Argument>()) return true;
+    const auto inst = val->dynCast<Instruction>();
+    if (inst == nullptr) return false;
+    if (loop == nullptr or not loop->contains(inst->block())) return true;
+    if (auto phi = inst->dynCast<PhiInst>()) {
+      const auto header = lpctx->head2loop(phi->block());
+      const auto indVar = header ? ivctx->getIndvar(header) : nullptr;
+      return indVar and indVar->phiinst() == phi;
+    }
+    if (inst->valueId() == vADD or inst->valueId() == vSUB) {
+      const auto binary = inst->as<BinaryInst>();
+      return isAffine(binary->lValue(), loop, lpctx, ivctx) and
+             isAffine(binary->rValue(), loop, lpctx, ivctx);
+    }
+    if (inst->valueId() == vMUL) {
+      const auto lhs = inst->as<BinaryInst>()->lValue(), rhs = inst->as<BinaryInst>()->rValue();
+      if (lhs->isa<ConstantInteger>()) return isAffine(rhs, loop, lpctx, ivctx);
+      if (rhs->isa<ConstantInteger>()) return isAffine(lhs, loop, lpctx, ivctx);
+    }
+    return false;
+  }
+
+  bool collect(Value* ptr, size_t depth, size_t dimsCnt, std::vector<Value*>& indices,
+               std::vector<Access>& accesses) {
+    if (depth == dimsCnt) {
+      for (auto use : ptr->uses()) {
+        const auto user = use->user();
+        if (user->isa<LoadInst>()) continue;
+        if (auto store = user->dynCast<StoreInst>(); store and store->ptr() == ptr) continue;
+        return false;
+      }
+      const auto leaf = ptr->as<GetElementPtrInst>();
+      const auto [lpctx, ivctx] = ctxOf(leaf->block()->function());
+      const auto loop = lpctx->getinnermostLoop(leaf->block());
+      const auto indVar = loop ? ivctx->getIndvar(loop) : nullptr;
+      for (auto idx : indices) {
+        if (not isAffine(idx, loop, lpctx, ivctx)) return false;
+      }
+      accesses.push_back({leaf, indices, loop, indVar ? indVar->phiinst() : nullptr});
+      return true;
+    }
+    for (auto use : ptr->uses()) {
+      const auto gep = use->user()->dynCast<GetElementPtrInst>();
+      if (gep == nullptr or not gep->is_arrayInst() or gep->value() != ptr) return false;
+      indices.push_back(gep->index());
+      const bool visible = collect(gep, depth + 1, dimsCnt, indices, accesses);
+      indices.pop_back();
+      if (not visible) return false;
+    }
+    return true;
+  }
+
+public:
+  explicit AccessCollector(TopAnalysisInfoManager* tp) : mTp(tp) {}
+
+  /* false if some use of gv is not a visible access */
+  bool collect(GlobalVariable* gv, std::vector<Access>& accesses) {
+    std::vector<Value*> indices;
+    return collect(gv, 0, gv->dims_cnt(), indices, accesses);
+  }
+};
+}  // namespace
+
+/* val changes with phi inside loop */
+static bool walks(Value* val, Loop* loop, PhiInst* phi) {
+  if (val == phi) return true;
+  const auto inst = val->dynCast<Instruction>();
+  if (inst == nullptr or inst->isa<PhiInst>() or not loop->contains(inst->block())) return false;
+  for (auto op : inst->operands()) {
+    if (walks(op->value(), loop, phi)) return true;
+  }
+  return false;
+}
+
+static uint64_t loopWeight(Loop* loop) {
+  uint64_t weight = 1;
+  for (; loop != nullptr; loop = loop->parentloop())
+    weight *= 8;
+  return weight;
+}
+
+/* weights of the accesses whose inner loop walks a leading index only (column) or the last
+ * index (row), indices ordered by perm */
+static std::pair<uint64_t, uint64_t> walkWeights(const std::vector<Access>& accesses,
+                                                 const std::vector<size_t>& perm) {
+  uint64_t column = 0, row = 0;
+  for (auto& access : accesses) {
+    if (access.phi == nullptr) continue;
+    const auto last = access.indices[perm.back()];
+    if (walks(last, access.loop, access.phi)) {
+      row += loopWeight(access.loop);
+      continue;
+    }
+    for (size_t k = 0; k + 1 < perm.size(); k++) {
+      if (walks(access.indices[perm[k]], access.loop, access.phi)) {
+        column += loopWeight(access.loop);
+        break;
+      }
+    }
+  }
+  return {column, row};
+}
+
+/* the last index is a constant at every access: it selects a field of a record, as in an
+ * interleaved array, and the record stays contiguous */
+static bool isRecordArray(const std::vector<Access>& accesses) {
+  return std::all_of(accesses.begin(), accesses.end(), [](const Access& access) {
+    return access.indices.back()->isa<ConstantInteger>();
+  });
+}
+
+static std::string rawName(GlobalVariable* gv) { return gv->name().substr(1); }
+
+static Value* zeroOf(Type* type) {
+  if (type->isFloat32()) return ConstantFloating::gen_f32(0.0);
+  return ConstantInteger::gen_i32(0);
+}
+
+static GlobalVariable* addArray(Module* module,
+                                GlobalVariable* like,
+                                const std::string& name,
+                                const std::vector<size_t>& dims,
+                                const std::vector<Value*>& init,
+                                bool isConst) {
+  const auto elemType = like->baseType()->as<ArrayType>()->baseType();
+  const auto gv = GlobalVariable::gen(elemType, init, module, name, isConst, dims,
+                                      not init.empty(), product(dims));
+  module->addGlobalVar(name, gv);
+  return gv;
+}
+
+/* the gep chain of the visitor for gv[indices...] before pos */
+static Value* makeAddress(GlobalVariable* gv,
+                          const std::vector<Value*>& indices,
+                          Instruction* pos) {
+  const auto arrayType = gv->baseType()->as<ArrayType>();
+  std::vector<size_t> dims = arrayType->dims(), curDims = arrayType->dims();
+  Value* ptr = gv;
+  for (auto idx : indices) {
+    dims.erase(dims.begin());
+    GetElementPtrInst* gep = nullptr;
+    if (dims.empty()) {
+      gep = utils::make<GetElementPtrInst>(arrayType->baseType(), ptr, idx, curDims);
+    } else {
+      gep = utils::make<GetElementPtrInst>(arrayType->baseType(), ptr, idx, dims, curDims);
+    }
+    curDims.erase(curDims.begin());
+    insertBefore(pos, gep);
+    ptr = gep;
+  }
+  return ptr;
+}
+
+static void rewrite(const std::vector<Access>& accesses,
+                    GlobalVariable* gv,
+                    const std::function<std::vector<Value*>(const Access&)>& mapIndices) {
+  for (auto& access : accesses) {
+    const auto leaf = access.leaf;
+    leaf->replaceAllUseWith(makeAddress(gv, mapIndices(access), leaf));
+    Value* ptr = leaf;
+    while (auto gep = ptr->dynCast<GetElementPtrInst>()) {
+      if (not gep->uses().empty()) break;
+      ptr = gep->value();
+      gep->block()->delete_inst(gep);
+    }
+  }
+}
+
+static void relayout(Module* module,
+                     GlobalVariable* gv,
+                     const std::vector<Access>& accesses,
+                     const Layout& layout) {
+  const auto& dims = gv->baseType()->as<ArrayType>()->dims();
+  std::vector<size_t> newDims;
+  for (auto k : layout.perm)
+    newDims.push_back(dims[k]);
+  newDims.back() += layout.pad;
+
+  std::vector<Value*> init;
+  if (gv->isInit()) {
+    const auto elemType = gv->baseType()->as<ArrayType>()->baseType();
+    init.assign(product(newDims), zeroOf(elemType));
+    std::vector<size_t> index(dims.size());
+    for (size_t flat = 0; flat < gv->init_cnt(); flat++) {
+      for (size_t k = dims.size(), rest = flat; k-- > 0; rest /= dims[k])
+        index[k] = rest % dims[k];
+      size_t newFlat = 0;
+      for (size_t k = 0; k < newDims.size(); k++)
+        newFlat = newFlat * newDims[k] + index[layout.perm[k]];
+      init[newFlat] = gv->init(flat);
+    }
+  }
+  const auto newGv = addArray(module, gv, rawName(gv) + ".l", newDims, init, gv->isConst());
+  rewrite(accesses, newGv, [&](const Access& access) {
+    std::vector<Value*> indices;
+    for (auto k : layout.perm)
+      indices.push_back(access.indices[k]);
+    return indices;
+  });
+  module->delGlobalVariable(gv);
+}
+
+static bool sameIndex(Value* lhs, Value* rhs) {
+  if (lhs == rhs) return true;
+  const auto lhsConst = lhs->dynCast<ConstantInteger>();
+  const auto rhsConst = rhs->dynCast<ConstantInteger>();
+  return lhsConst and rhsConst and lhsConst->i32() == rhsConst->i32();
+}
+
+/* every access of lhs has one of rhs with the same index in the same block, one in a loop */
+static bool accessedTogether(const std::vector<Access>& lhs, const std::vector<Access>& rhs) {
+  bool inLoop = false;
+  for (auto& access : lhs) {
+    inLoop |= access.loop != nullptr;
+    const bool paired = std::any_of(rhs.begin(), rhs.end(), [&](const Access& other) {
+      return other.leaf->block() == access.leaf->block() and
+             sameIndex(other.indices[0], access.indices[0]);
+    });
+    if (not paired) return false;
+  }
+  return inLoop;
+}
+
+static void interleave(Module* module,
+                       GlobalVariable* lhs,
+                       const std::vector<Access>& lhsAccesses,
+                       GlobalVariable* rhs,
+                       const std::vector<Access>& rhsAccesses) {
+  const auto elemType = lhs->baseType()->as<ArrayType>()->baseType();
+  const auto count = lhs->baseType()->as<ArrayType>()->dim(0);
+  std::vector<Value*> init;
+  if (lhs->isInit() or rhs->isInit()) {
+    init.assign(2 * count, zeroOf(elemType));
+    for (size_t i = 0; i < count; i++) {
+      if (lhs->isInit()) init[2 * i] = lhs->init(i);
+      if (rhs->isInit()) init[2 * i + 1] = rhs->init(i);
+    }
+  }
+  const auto name = rawName(lhs) + "." + rawName(rhs);
+  const auto newGv =
+    addArray(module, lhs, name, {count, 2}, init, lhs->isConst() and rhs->isConst());
+  for (auto [accesses, field] : {std::pair{&lhsAccesses, 0}, std::pair{&rhsAccesses, 1}}) {
+    rewrite(*accesses, newGv, [field = field](const Access& access) {
+      return std::vector<Value*>{access.indices[0], ConstantInteger::gen_i32(field)};
+    });
+  }
+  module->delGlobalVariable(lhs);
+  module->delGlobalVariable(rhs);
+}
+
+void GlobalArrayLayout::run(Module* module, TopAnalysisInfoManager* tp) {
+  AccessCollector collector{tp};
+  std::vector<std::pair<GlobalVariable*, std::vector<Access>>> arrays;
+  for (auto gv : module->globalVars()) {
+    if (not gv->isArray()) continue;
+    const auto dims = gv->baseType()->as<ArrayType>()->dims();
+    if (gv->isInit() and gv->init_cnt() != product(dims)) continue;
+    std::vector<Access> accesses;
+    if (not collector.collect(gv, accesses) or accesses.empty()) continue;
+    arrays.emplace_back(gv, std::move(accesses));
+  }
+
+  std::vector<std::pair<GlobalVariable*, std::vector<Access>>*> flat;
+  for (auto& array : arrays) {
+    auto& [gv, accesses] = array;
+    const auto& dims = gv->baseType()->as<ArrayType>()->dims();
+    if (dims.size() == 1) {
+      flat.push_back(&array);
+      continue;
+    }
+    Layout layout;
+    for (size_t k = 0; k < dims.size(); k++)
+      layout.perm.push_back(k);
+    if (LayoutTranspose and dims.size() == 2 and not isRecordArray(accesses)) {
+      const auto [column, row] = walkWeights(accesses, layout.perm);
+      if (column > row) std::reverse(layout.perm.begin(), layout.perm.end());
+    }
+    const auto lastBytes = dims[layout.perm.back()] * 4;
+    /* a stride dividing the pad maps padded rows to the same sets again (and pads again) */
+    if (LayoutPadStride > PadElements * 4 and lastBytes % LayoutPadStride == 0 and
+        walkWeights(accesses, layout.perm).first > 0)
+      layout.pad = PadElements;
+    if (layout.pad or layout.perm.front() != 0) relayout(module, gv, accesses, layout);
+  }
+
+  if (LayoutInterleave) {
+    std::vector<bool> paired(flat.size(), false);
+    for (size_t i = 0; i < flat.size(); i++) {
+      for (size_t j = i + 1; j < flat.size() and not paired[i]; j++) {
+        if (paired[j]) continue;
+        auto& [lhs, lhsAccesses] = *flat[i];
+        auto& [rhs, rhsAccesses] = *flat[j];
+        if (not lhs->baseType()->isSame(rhs->baseType())) continue;
+        if (not accessedTogether(lhsAccesses, rhsAccesses) or
+            not accessedTogether(rhsAccesses, lhsAccesses))
+          continue;
+        interleave(module, lhs, lhsAccesses, rhs, rhsAccesses);
+        paired[i] = paired[j] = true;
+      }
+    }
+  }
+
+  for (auto gv : module->globalVars()) {
+    if (gv->isArray() and gv->baseType()->size() >= CacheLineBytes) gv->setAlign(CacheLineBytes);
+  }
+}
+
+}  // namespace pass
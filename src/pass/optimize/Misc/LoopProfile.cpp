@@ -0,0 +1,162 @@
+#include "pass/optimize/Misc/LoopProfile.hpp"
+#include "support/config.hpp"
+#include "support/LoopProfileData.hpp"
+
+#include <numeric>
+
+using namespace ir;
+
+namespace pass {
+/* loops of func in profile order: header position in the block list */
+std::vector<Loop*> LoopProfile::profileOrder(Function* func, LoopInfo* lpctx) {
+  std::vector<Loop*> loops;
+  for (auto block : func->blocks()) {
+    if (auto loop = lpctx->head2loop(block)) loops.push_back(loop);
+  }
+  return loops;
+}
+
+uint32_t LoopProfile::loopDepth(Loop* loop) {
+  uint32_t depth = 0;
+  for (; loop; loop = loop->parentloop())
+    depth++;
+  return depth;
+}
+
+void LoopProfile::annotate(Module* module, TopAnalysisInfoManager* tp) {
+  auto& data = utils::LoopProfileData::get();
+  if (data.empty() and not data.load(sysy::Config::getInstance().profileUse)) return;
+  for (auto func : module->funcs()) {
+    if (func->isOnlyDeclare()) continue;
+    const auto loops = profileOrder(func, tp->getLoopInfo(func));
+    for (uint32_t index = 0; index < loops.size(); index++) {
+      if (auto record = data.loop(func->name(), index)) data.attach(loops[index]->header(), record);
+    }
+  }
+}
+
+static Function* getHook(Module* module, const std::string& name, const type_ptr_vector& args) {
+  if (auto func = module->findFunction(name)) {
+    return func;
+  }
+  const auto func = module->addFunction(FunctionType::gen(Type::void_type(), args), name);
+  func->attribute().addAttr(FunctionAttribute::Builtin);
+  return func;
+}
+
+static inst_iterator firstNonPhi(BasicBlock* block) {
+  return std::next(block->insts().begin(), block->phi_insts().size());
+}
+
+void LoopProfile::instrument(Module* module, TopAnalysisInfoManager* tp) {
+  const auto i32 = Type::TypeInt32();
+
+  std::vector<Function*> funcs;
+  std::vector<std::vector<Loop*>> funcLoops;
+  size_t loopCount = 0;
+  for (auto func : module->funcs()) {
+    if (func->isOnlyDeclare()) continue;
+    funcs.push_back(func);
+    funcLoops.push_back(profileOrder(func, tp->getLoopInfo(func)));
+    loopCount += funcLoops.back().size();
+  }
+  if (funcs.empty()) return;
+
+  /* meta, see runtime/LoopProfile.cpp */
+  std::vector<int32_t> meta{static_cast<int32_t>(funcs.size()), static_cast<int32_t>(loopCount)};
+  meta.resize(2 + funcs.size());
+  for (size_t fid = 0; fid < funcs.size(); fid++) {
+    for (uint32_t index = 0; index < funcLoops[fid].size(); index++) {
+      const auto depth = loopDepth(funcLoops[fid][index]);
+      meta.insert(meta.end(), {static_cast<int32_t>(fid), static_cast<int32_t>(index),
+                               static_cast<int32_t>(depth)});
+    }
+  }
+  for (size_t fid = 0; fid < funcs.size(); fid++) {
+    meta[2 + fid] = static_cast<int32_t>(meta.size());
+    for (auto ch : funcs[fid]->name())
+      meta.push_back(ch);
+    meta.push_back(0);
+  }
+
+  std::vector<Value*> metaInit;
+  for (auto word : meta)
+    metaInit.push_back(ConstantInteger::gen_i32(word));
+  const auto metaVar = GlobalVariable::gen(i32, metaInit, module, "__sysyc_prof_meta", true,
+                                           {meta.size()}, true, meta.size());
+  module->addGlobalVar("__sysyc_prof_meta", metaVar);
+  const auto tripSize = std::max<size_t>(loopCount, 1);
+  const auto tripVar = GlobalVariable::gen(i32, {}, module, "__sysyc_prof_trips", false,
+                                           {tripSize}, false, tripSize);
+  module->addGlobalVar("__sysyc_prof_trips", tripVar);
+
+  const auto initHook = getHook(module, "sysycProfInit", {metaVar->type(), tripVar->type()});
+  const auto funcEnter = getHook(module, "sysycProfFuncEnter", {i32});
+  const auto funcExit = getHook(module, "sysycProfFuncExit", {i32});
+  const auto loopEnter = getHook(module, "sysycProfLoopEnter", {i32});
+  const auto loopExit = getHook(module, "sysycProfLoopExit", {i32});
+
+  IRBuilder builder;
+  uint32_t lid = 0;
+  for (size_t fid = 0; fid < funcs.size(); fid++) {
+    const auto func = funcs[fid];
+    const auto fidValue = ConstantInteger::gen_i32(fid);
+
+    /* loops: enter in the preheader, count in the header, leave in every exit */
+    auto loops = funcLoops[fid];
+    std::vector<uint32_t> ids(loops.size());
+    for (uint32_t index = 0; index < loops.size(); index++)
+      ids[index] = lid++;
+    /* outer first: an exit shared with an inner loop then leaves the inner one first */
+    std::vector<uint32_t> order(loops.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+      return loopDepth(loops[lhs]) < loopDepth(loops[rhs]);
+    });
+    for (auto index : order) {
+      const auto loop = loops[index];
+      const auto preheader = loop->getLoopPreheader();
+      if (preheader == nullptr or not loop->hasDedicatedExits()) continue;
+      const auto lidValue = ConstantInteger::gen_i32(ids[index]);
+
+      builder.set_pos(preheader, std::prev(preheader->insts().end()));
+      builder.makeInst<CallInst>(loopEnter, std::vector<Value*>{lidValue});
+
+      const auto header = loop->header();
+      builder.set_pos(header, firstNonPhi(header));
+      const auto tripPtr = builder.makeGetElementPtr(i32, tripVar, lidValue, {}, {tripSize});
+      const auto trips = builder.makeLoad(tripPtr);
+      const auto next = builder.makeBinary(BinaryOp::ADD, trips, ConstantInteger::gen_i32(1));
+      builder.makeInst<StoreInst>(next, tripPtr);
+
+      for (auto exit : loop->exits()) {
+        builder.set_pos(exit, firstNonPhi(exit));
+        builder.makeInst<CallInst>(loopExit, std::vector<Value*>{lidValue});
+      }
+    }
+
+    /* function boundaries */
+    for (auto block : func->blocks()) {
+      if (block->empty() or not block->terminator()->isa<ReturnInst>()) continue;
+      builder.set_pos(block, std::prev(block->insts().end()));
+      builder.makeInst<CallInst>(funcExit, std::vector<Value*>{fidValue});
+    }
+    const auto entry = func->entry();
+    auto pos = entry->insts().begin();
+    while (pos != entry->insts().end() and (*pos)->isa<AllocaInst>())
+      pos++;
+    builder.set_pos(entry, pos);
+    if (func == module->mainFunction()) {
+      builder.makeInst<CallInst>(initHook, std::vector<Value*>{metaVar, tripVar});
+    }
+    builder.makeInst<CallInst>(funcEnter, std::vector<Value*>{fidValue});
+  }
+  tp->CallChange();
+}
+
+void LoopProfile::run(Module* module, TopAnalysisInfoManager* tp) {
+  const auto& config = sysy::Config::getInstance();
+  if (not config.profileUse.empty()) annotate(module, tp);
+  if (config.instrumentLoops) instrument(module, tp);
+}
+}  // namespace pass
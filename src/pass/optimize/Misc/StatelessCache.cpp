@@ -6,19 +6,77 @@
 using namespace ir;
 
 namespace pass {
+/*
+ * lookup(table, key1[, key2]) -> entry, defined in IR so that `inline` expands it at the
+ * call site (fixed table address, no call). Direct-mapped, like the precompiled runtime it
+ * replaces (its probe loop never advanced): a missing or different key claims the entry
+ * with hasVal = 0.
+ *   entry: [key2 (key1 if one key), key1, val, hasVal]
+ *   slot = (key1 * 108 + key2) % 1021 + 1020, 108 = 2^32 % 1021 keeps the distribution of
+ *   the 64-bit key; the offset covers negative remainders (table of 2 * 1021 - 1 entries)
+ */
 Function* StatelessCache::getLookupFunction(Module* module,
                                             ArrayType* entryType,
-                                            ArrayType* lutType) {
-  const auto funcName = "sysycCacheLookup";
+                                            ArrayType* lutType,
+                                            size_t keys) {
+  const auto funcName = keys == 1 ? "sysycCacheLookup1" : "sysycCacheLookup2";
   if (auto func = module->findFunction(funcName)) {
     return func;
   }
   const auto i32 = Type::TypeInt32();
 
-  const auto funcType =
-    FunctionType::gen(PointerType::gen(entryType), {PointerType::gen(lutType), i32, i32});
+  std::vector<Type*> argTypes{PointerType::gen(lutType)};
+  argTypes.insert(argTypes.end(), keys, i32);
+  const auto funcType = FunctionType::gen(PointerType::gen(entryType), argTypes);
   const auto func = module->addFunction(funcType, funcName);
-  func->attribute().addAttr(FunctionAttribute::Builtin);
+  const auto table = func->new_arg(PointerType::gen(lutType), "table");
+  const auto key1 = func->new_arg(i32, "key1");
+  const auto key2 = keys == 1 ? nullptr : func->new_arg(i32, "key2");
+
+  const auto entry = func->newEntry("lookup_entry");
+  const auto exit = func->newExit("lookup_exit");
+  const auto miss = func->newBlock();
+  miss->setComment("lookup miss: claim the entry");
+
+  IRBuilder builder;
+  builder.set_pos(entry, entry->insts().end());
+  Value* hash = key1;
+  if (key2) {
+    const auto high = builder.makeBinary(BinaryOp::MUL, key1, ConstantInteger::gen_i32(108));
+    hash = builder.makeBinary(BinaryOp::ADD, high, key2);
+  }
+  const auto rem = builder.makeBinary(BinaryOp::REM, hash, ConstantInteger::gen_i32(lutSlots));
+  const auto slot = builder.makeBinary(BinaryOp::ADD, rem, ConstantInteger::gen_i32(lutSlots - 1));
+  const auto ref = builder.makeGetElementPtr(i32, table, slot, {4}, lutType->dims());
+  const auto word = [&](int32_t idx) {
+    return builder.makeGetElementPtr(i32, ref, ConstantInteger::gen_i32(idx), {}, {4});
+  };
+  const auto keyPtr = word(0), highKeyPtr = word(1), hasValPtr = word(3);
+  const auto lowKey = key2 ? key2 : key1;
+
+  /* hasVal && key matches -> exit, else miss */
+  const auto hasVal = builder.makeLoad(hasValPtr);
+  auto check = func->newBlock();
+  builder.makeInst<BranchInst>(builder.makeCmp(CmpOp::NE, hasVal, ConstantInteger::gen_i32(0)),
+                               check, miss);
+  builder.set_pos(check, check->insts().end());
+  auto hit = builder.makeCmp(CmpOp::EQ, builder.makeLoad(keyPtr), lowKey);
+  if (key2) {
+    const auto checkHigh = func->newBlock();
+    builder.makeInst<BranchInst>(hit, checkHigh, miss);
+    builder.set_pos(checkHigh, checkHigh->insts().end());
+    hit = builder.makeCmp(CmpOp::EQ, builder.makeLoad(highKeyPtr), key1);
+  }
+  builder.makeInst<BranchInst>(hit, exit, miss);
+
+  builder.set_pos(miss, miss->insts().end());
+  builder.makeInst<StoreInst>(lowKey, keyPtr);
+  if (key2) builder.makeInst<StoreInst>(key1, highKeyPtr);
+  builder.makeInst<StoreInst>(ConstantInteger::gen_i32(0), hasValPtr);
+  builder.makeInst<BranchInst>(exit);
+
+  builder.set_pos(exit, exit->insts().end());
+  builder.makeInst<ReturnInst>(ref);
   return func;
 }
 bool StatelessCache::has2MoreRecursiveCalls(Function* func) {
@@ -108,9 +166,9 @@ bool StatelessCache::runImpl(ir::Function* func, TopAnalysisInfoManager* tp) {
 
   builder.set_pos(next);
   // prepare lookup function, lookup table (lut)
-  const size_t tableSize = 1021, tableWords = tableSize * 4;
+  const size_t tableSize = 2 * lutSlots - 1, tableWords = tableSize * 4;
   // totally tableSize lut entries, each entry is 4 words (i32)
-  const auto lutType = ArrayType::gen(i32, {tableWords}, tableWords);
+  const auto lutType = ArrayType::gen(i32, {tableSize, 4}, tableWords);
   const auto entryType = ArrayType::gen(i32, {4}, 4);
   const auto lut = utils::make<GlobalVariable>(lutType, "lut_" + func->name());
   func->module()->addGlobalVar(lut->name(), lut);
@@ -126,20 +184,12 @@ bool StatelessCache::runImpl(ir::Function* func, TopAnalysisInfoManager* tp) {
       lookupFuncArgs.push_back(builder.makeUnary(ir::ValueId::vFPTOSI, arg, i32));
     // lookupFuncArgs.push_back(builder.makeInst<UnaryInst>(ir::ValueId::vBITCAST, i32, arg));
   }
-  while (lookupFuncArgs.size() < 3) {
-    lookupFuncArgs.push_back(ConstantInteger::gen_i32(0));
-  }
-  const auto lookupFunc = getLookupFunction(func->module(), entryType, lutType);
+  const auto lookupFunc =
+    getLookupFunction(func->module(), entryType, lutType, lookupFuncArgs.size() - 1);
 
   // ptr = call lookup(table, key1, key2), return ptr is the pointer to the lookuped entry
   const auto entryPtr = builder.makeInst<CallInst>(lookupFunc, lookupFuncArgs);
-  /*
-  struct LUTEntry final {
-      uint64_t key;
-      int val;
-      int hasVal;
-  };
-  */
+  // entry: [key2, key1, val, hasVal], see getLookupFunction
   // load the value from the lookuped entry: *(ptr + 2) by words (i32), LUTEntry.val ptr
   auto valPtr = builder.makeGetElementPtr(i32, entryPtr, ConstantInteger::gen_i32(2), {}, {4});
   if (not(valPtr->type()->as<PointerType>()->baseType()->isSame(retType))) {
@@ -172,6 +222,7 @@ bool StatelessCache::runImpl(ir::Function* func, TopAnalysisInfoManager* tp) {
     return false;
   }
   originalExit->insts().remove(retInst);
+  originalExit->markChanged();
 
   builder.set_pos(originalExit, originalExit->insts().end());
   // store hasVal to the lookuped entry
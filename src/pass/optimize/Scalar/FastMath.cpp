@@ -0,0 +1,114 @@
+#include "pass/optimize/FastMath.hpp"
+#include "support/config.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_set>
+
+using namespace ir;
+namespace pass {
+
+static bool isDefinedIn(Loop* loop, Value* val) {
+  if (auto inst = val->dynCast<Instruction>()) return loop->contains(inst->block());
+  return false;
+}
+
+static BinaryInst* mulOf(Value* val) {
+  const auto mul = val->dynCast<BinaryInst>();
+  return mul and mul->valueId() == vFMUL ? mul : nullptr;
+}
+
+static void insertBefore(Instruction* pos, Instruction* inst) {
+  auto& insts = pos->block()->insts();
+  pos->block()->emplace_inst(std::find(insts.begin(), insts.end(), pos), inst);
+}
+
+using ReciprocalCache = std::map<std::pair<Loop*, Value*>, Value*>;
+
+/* 1 / d for x / d, nullptr if the multiply does not save a division */
+static Value* reciprocalOf(BinaryInst* div, LoopInfo* lpctx, ReciprocalCache& cache) {
+  const auto divisor = div->rValue();
+  if (auto constant = divisor->dynCast<ConstantFloating>()) {
+    const auto reciprocal = 1.0f / constant->getVal();
+    if (not std::isfinite(reciprocal)) return nullptr;
+    return ConstantFloating::gen_f32(reciprocal);
+  }
+  /* the outermost loop around div that d is invariant in */
+  Loop* target = nullptr;
+  for (auto loop = lpctx->getinnermostLoop(div->block()); loop != nullptr;
+       loop = loop->parentloop()) {
+    if (isDefinedIn(loop, divisor) or loop->getLoopPreheader() == nullptr) break;
+    target = loop;
+  }
+  if (target == nullptr) return nullptr;
+  auto& reciprocal = cache[{target, divisor}];
+  if (reciprocal == nullptr) {
+    const auto inst = utils::make<BinaryInst>(vFDIV, Type::TypeFloat32(),
+                                              ConstantFloating::gen_f32(1.0f), divisor);
+    target->getLoopPreheader()->emplace_lastbutone_inst(inst);
+    reciprocal = inst;
+  }
+  return reciprocal;
+}
+
+/* mul as isel fuses it: in the block of user and used only there */
+static BinaryInst* localMul(BinaryInst* mul, Instruction* user) {
+  if (mul->block() == user->block() and mul->uses().size() == 1) return mul;
+  const auto copy = utils::make<BinaryInst>(vFMUL, mul->type(), mul->lValue(), mul->rValue());
+  insertBefore(user, copy);
+  return copy;
+}
+
+void FastMath::run(Function* func, TopAnalysisInfoManager* tp) {
+  if (func->isOnlyDeclare() or not sysy::Config::getInstance().fastMath) return;
+  const auto lpctx = tp->getLoopInfo(func);
+
+  std::vector<BinaryInst*> divs, adds;
+  for (auto block : func->blocks()) {
+    for (auto inst : block->insts()) {
+      if (inst->valueId() == vFDIV) divs.push_back(inst->as<BinaryInst>());
+      if (inst->valueId() == vFADD or inst->valueId() == vFSUB)
+        adds.push_back(inst->as<BinaryInst>());
+    }
+  }
+
+  ReciprocalCache cache;
+  for (auto div : divs) {
+    const auto reciprocal = reciprocalOf(div, lpctx, cache);
+    if (reciprocal == nullptr) continue;
+    const auto mul = utils::make<BinaryInst>(vFMUL, div->type(), div->lValue(), reciprocal);
+    insertBefore(div, mul);
+    div->replaceAllUseWith(mul);
+    div->block()->delete_inst(div);
+  }
+
+  std::unordered_set<BinaryInst*> contracted;
+  for (auto add : adds) {
+    auto lhs = add->lValue(), rhs = add->rValue();
+    if (add->valueId() == vFADD and not mulOf(lhs) and mulOf(rhs)) {
+      std::swap(lhs, rhs);
+      add->setOperand(0, lhs);
+      add->setOperand(1, rhs);
+    }
+    if (const auto mul = mulOf(lhs)) {
+      /* a * b + z, a * b - z */
+      add->setOperand(0, localMul(mul, add));
+      contracted.insert(mul);
+    } else if (const auto mul = mulOf(rhs)) {
+      /* z - a * b = -(a * b) + z */
+      const auto neg = utils::make<UnaryInst>(vFNEG, add->type(), localMul(mul, add));
+      const auto fused = utils::make<BinaryInst>(vFADD, add->type(), neg, lhs);
+      insertBefore(add, neg);
+      insertBefore(add, fused);
+      add->replaceAllUseWith(fused);
+      add->block()->delete_inst(add);
+      contracted.insert(mul);
+    }
+  }
+  /* a mul duplicated into all its users */
+  for (auto mul : contracted) {
+    if (mul->uses().empty()) mul->block()->delete_inst(mul);
+  }
+}
+
+}  // namespace pass
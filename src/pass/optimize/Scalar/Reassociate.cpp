@@ -1,32 +1,118 @@
 #include "pass/optimize/reassociate.hpp"
+#include "support/config.hpp"
+#include <algorithm>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
 using namespace pass;
 
-static std::vector<ir::BasicBlock*> RPOVector;
-static std::unordered_map<ir::BasicBlock*, bool> vis;
-static std::unordered_map<ir::Value*, int> rankMap;
+namespace {
+/* height of the dependency chain inside one block, phi leaves paired last */
+class TreeBuilder final {
+  ir::BasicBlock* mBlock;
+  ir::ValueId mOpcode;
+  std::unordered_map<ir::Value*, uint32_t> mHeight;
+
+  static constexpr uint32_t phiHeight = 1u << 20;
+
+public:
+  TreeBuilder(ir::BasicBlock* block, ir::ValueId opcode) : mBlock(block), mOpcode(opcode) {}
+
+  /* interior node: only feeds another node of the same tree */
+  bool isInterior(ir::Value* val) {
+    const auto inst = val->dynCast<ir::BinaryInst>();
+    if (inst == nullptr or inst->valueId() != mOpcode or inst->block() != mBlock) return false;
+    if (inst->uses().size() != 1) return false;
+    const auto user = inst->uses().front()->user()->as<ir::Instruction>();
+    return user->valueId() == mOpcode and user->block() == mBlock;
+  }
+
+  uint32_t height(ir::Value* val) {
+    const auto inst = val->dynCast<ir::Instruction>();
+    if (inst == nullptr or inst->block() != mBlock or inst->isa<ir::PhiInst>()) return 0;
+    if (auto iter = mHeight.find(val); iter != mHeight.end()) return iter->second;
+    uint32_t res = 0;
+    for (auto op : inst->operands())
+      res = std::max(res, height(op->value()));
+    return mHeight[val] = res + 1;
+  }
+  uint32_t leafHeight(ir::Value* val) { return val->isa<ir::PhiInst>() ? phiHeight : height(val); }
+
+  /* leaves and interior nodes (root first) of the tree, returns its current height */
+  uint32_t collect(ir::BinaryInst* node,
+                   std::vector<ir::Value*>& leaves,
+                   std::vector<ir::BinaryInst*>& nodes) {
+    nodes.push_back(node);
+    uint32_t res = 0;
+    for (auto op : {node->lValue(), node->rValue()}) {
+      if (isInterior(op)) {
+        res = std::max(res, collect(op->as<ir::BinaryInst>(), leaves, nodes));
+      } else {
+        leaves.push_back(op);
+        res = std::max(res, leafHeight(op));
+      }
+    }
+    return res + 1;
+  }
+
+  uint32_t balancedHeight(const std::vector<ir::Value*>& leaves) {
+    std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> ready;
+    for (auto leaf : leaves)
+      ready.push(leafHeight(leaf));
+    while (ready.size() > 1) {
+      const auto lhs = ready.top();
+      ready.pop();
+      const auto rhs = ready.top();
+      ready.pop();
+      ready.push(std::max(lhs, rhs) + 1);
+    }
+    return ready.top();
+  }
+
+  /* pairs the two lowest operands until one is left (Huffman), inserted before pos */
+  ir::Value* rebuild(const std::vector<ir::Value*>& leaves, ir::inst_iterator pos) {
+    using Item = std::tuple<uint32_t, size_t, ir::Value*>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> ready;
+    size_t order = 0;
+    for (auto leaf : leaves)
+      ready.emplace(leafHeight(leaf), order++, leaf);
+    while (ready.size() > 1) {
+      const auto [lhsHeight, lhsOrder, lhs] = ready.top();
+      ready.pop();
+      const auto [rhsHeight, rhsOrder, rhs] = ready.top();
+      ready.pop();
+      const auto inst = utils::make<ir::BinaryInst>(mOpcode, lhs->type(), lhs, rhs);
+      mBlock->emplace_inst(pos, inst);
+      ready.emplace(std::max(lhsHeight, rhsHeight) + 1, order++, inst);
+    }
+    return std::get<2>(ready.top());
+  }
+};
+}  // namespace
 
 void Reassociate::run(ir::Function* func, TopAnalysisInfoManager* tp) {
-  if (func->isOnlyDeclare()) return;
-  // initialize
-  RPOVector.clear();
-  vis.clear();
-  rankMap.clear();
-  // get RPO of BBs in func
-  for (auto bb : func->blocks())
-    vis[bb] = false;
-  DFSPostOrderBB(func->entry());
-  std::reverse(RPOVector.begin(), RPOVector.end());
-  // calculate Rank Map
-}
+  if (func->isOnlyDeclare() or not sysy::Config::getInstance().fastMath) return;
+
+  for (auto block : func->blocks()) {
+    for (auto opcode : {ir::vFADD, ir::vFMUL}) {
+      TreeBuilder builder{block, opcode};
+      std::vector<ir::BinaryInst*> roots;
+      for (auto inst : block->insts()) {
+        if (inst->valueId() == opcode and not builder.isInterior(inst))
+          roots.push_back(inst->as<ir::BinaryInst>());
+      }
+      for (auto root : roots) {
+        std::vector<ir::Value*> leaves;
+        std::vector<ir::BinaryInst*> nodes;
+        const auto height = builder.collect(root, leaves, nodes);
+        if (leaves.size() < 3 or builder.balancedHeight(leaves) >= height) continue;
 
-// dfs whole cfg in post order and get post order rank of bbs
-void Reassociate::DFSPostOrderBB(ir::BasicBlock* bb) {
-  vis[bb] = true;
-  for (auto bbNext : bb->next_blocks()) {
-    if (not vis[bb]) DFSPostOrderBB(bbNext);
+        const auto pos = std::find(block->insts().begin(), block->insts().end(), root);
+        const auto res = builder.rebuild(leaves, pos);
+        root->replaceAllUseWith(res);
+        for (auto node : nodes)
+          block->delete_inst(node);
+      }
+    }
   }
-  RPOVector.push_back(bb);
 }
-
-// to build rank map
-void Reassociate::buildRankMap() {}
\ No newline at end of file
@@ -108,6 +108,7 @@ bool fixAllocaInEntry(Function& func) {
   // remove
   for (auto block : func.blocks()) {
     block->insts().remove_if([&](Instruction* inst) { return allocas.count(inst); });
+    block->markChanged();
   }
   const auto oldEntry = func.entry();
   // new entry block"
@@ -189,6 +190,7 @@ BasicBlock* splitBlock(BasicBlockList& blocks,
     preBlock->insts().erase(iter);
     iter = next;
   }
+  preBlock->markChanged();
   // insert postBlock after preBlock
   blocks.insert(std::next(blockIter), postBlock);
   return postBlock;
@@ -20,6 +20,8 @@
 #include "pass/optimize/simplifyCFG.hpp"
 #include "pass/optimize/GCM.hpp"
 #include "pass/optimize/GVN.hpp"
+#include "pass/optimize/reassociate.hpp"
+#include "pass/optimize/FastMath.hpp"
 #include "pass/optimize/inline.hpp"
 #include "pass/optimize/reg2mem.hpp"
 #include "pass/optimize/ADCE.hpp"
@@ -27,6 +29,7 @@
 
 #include "pass/optimize/GlobalToLocal.hpp"
 #include "pass/optimize/TCO.hpp"
+#include "pass/optimize/TaskParallel.hpp"
 #include "pass/optimize/InstCombine/ArithmeticReduce.hpp"
 #include "pass/optimize/DSE.hpp"
 #include "pass/optimize/DLE.hpp"
@@ -45,10 +48,16 @@
 #include "pass/optimize/SROA.hpp"
 
 #include "pass/optimize/Misc/StatelessCache.hpp"
+#include "pass/optimize/Misc/LoopProfile.hpp"
+#include "pass/optimize/Misc/GlobalArrayLayout.hpp"
 
 #include "pass/optimize/Loop/LoopBodyExtract.hpp"
 #include "pass/optimize/Loop/ParallelBodyExtract.hpp"
 #include "pass/optimize/Loop/LoopInterChange.hpp"
+#include "pass/optimize/Loop/LoopIdiom.hpp"
+#include "pass/optimize/Loop/LoopRecurrence.hpp"
+#include "pass/optimize/Loop/BitIdiom.hpp"
+#include "pass/optimize/Loop/LoopPrefetch.hpp"
 #include "pass/optimize/Loop/LoopParallel.hpp"
 #include "pass/optimize/Misc/BlockSort.hpp"
 
@@ -132,13 +141,15 @@ static GVN gvnPass;
 static AggressiveG2L AG2LPass;
 static Global2Local G2LPass;
 static LICM licmPass;
-// static Reassociate reassociatePass;
+static Reassociate reassociatePass;
+static FastMath fastMathPass;
 static SCEV scevPass;
 static SROA sroaPass;
 
 // IPO
 static Inline inlinePass;
 static TailCallOpt tcoPass;
+static TaskParallel taskParallelPass;
 
 // InstCombine
 static ArithmeticReduce instCombinePass;
@@ -149,6 +160,10 @@ static LoopUnroll loopUnrollPass;
 static LoopSplit loopSplitPass;
 static LoopDivest loopDivestPass;
 static LoopInterChange loopInterChangePass;
+static LoopIdiom loopIdiomPass;
+static LoopRecurrence loopRecurrencePass;
+static BitIdiom bitIdiomPass;
+static LoopPrefetch loopPrefetchPass;
 static LoopBodyExtract loopBodyExtractPass;
 static ParallelBodyExtract parallelBodyExtractPass;
 static LoopParallel loopParallelPass;
@@ -158,6 +173,8 @@ static StatelessCache cachePass;
 static BlockSort blockSortPass;
 static GepSplit gepSplitPass;
 static IdvEdvRepl idvEdvReplPass;
+static LoopProfile loopProfilePass;
+static GlobalArrayLayout arrayLayoutPass;
 
 // Analysis
 static CFGAnalysisHHW cfgAnalysisPass;
@@ -198,11 +215,14 @@ static std::unordered_map<std::string, BasePass*> passMap = {
   {"ag2l", &AG2LPass},
   {"g2l", &G2LPass},
   {"licm", &licmPass},
+  {"reassociate", &reassociatePass},
+  {"fastmath", &fastMathPass},
   {"scev", &scevPass},
   {"sroa", &sroaPass},
   // IPO
   {"inline", &inlinePass},
   {"tco", &tcoPass},
+  {"taskparallel", &taskParallelPass},
   // InstCombine
   {"instcombine", &instCombinePass},
   // Loop
@@ -211,6 +231,10 @@ static std::unordered_map<std::string, BasePass*> passMap = {
   {"loopsplit", &loopSplitPass},
   {"loopdivest", &loopDivestPass},
   {"LoopInterChange", &loopInterChangePass},
+  {"loopidiom", &loopIdiomPass},
+  {"looprec", &loopRecurrencePass},
+  {"bitidiom", &bitIdiomPass},
+  {"prefetch", &loopPrefetchPass},
   {"LoopBodyExtract", &loopBodyExtractPass},
   {"ParallelBodyExtract", &parallelBodyExtractPass},
   {"parallel", &loopParallelPass},
@@ -220,6 +244,8 @@ static std::unordered_map<std::string, BasePass*> passMap = {
   {"blocksort", &blockSortPass},
   {"GepSplit", &gepSplitPass},
   {"idvrepl", &idvEdvReplPass},
+  {"loopprofile", &loopProfilePass},
+  {"arraylayout", &arrayLayoutPass},
 
   // analysis
   {"cfg", &cfgAnalysisPass},
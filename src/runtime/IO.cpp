@@ -0,0 +1,291 @@
+#include <cstdint>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#include <unistd.h>
+
+/*
+ * Buffered SysY I/O.
+ *
+ * With runtime.buffered-io the backend calls these instead of sylib's
+ * getint/putint/... (RISCVTarget.hpp, SysYIORuntimeSymbols). Input is read in
+ * 1 MiB blocks and parsed by hand, output is formatted into a 1 MiB buffer that
+ * is written when full and once at exit; no stdio locking or per-element call
+ * into libc.
+ *
+ * Formats follow sylib: getint/getarray "%d", getch "%c" (-1 at end of input),
+ * getfloat/getfarray "%a" (decimal or hex float), putfloat/putfarray "%a" of
+ * the value as double. putf stays in sylib (printf formats): sysycPutf writes
+ * our buffer out first and marks stdio dirty, the next flush flushes stdio
+ * before writing, so the order of the output is kept.
+ */
+constexpr uint32_t bufferSize = 1 << 20;
+static uint8_t inBuffer[bufferSize];   // NOLINT
+static uint32_t inPos, inEnd;          // NOLINT
+static uint8_t outBuffer[bufferSize];  // NOLINT
+static uint32_t outPos;                // NOLINT
+static bool stdioDirty;                // NOLINT
+
+static bool refill() {
+  const auto size = read(0, inBuffer, bufferSize);
+  inPos = 0;
+  inEnd = size > 0 ? static_cast<uint32_t>(size) : 0;
+  return size > 0;
+}
+static int32_t peekChar() {
+  if (inPos == inEnd && !refill()) return -1;
+  return inBuffer[inPos];
+}
+static int32_t skipSpaces() {
+  auto c = peekChar();
+  while (c == ' ' || (c >= '\t' && c <= '\r')) {
+    inPos++;
+    c = peekChar();
+  }
+  return c;
+}
+static bool isDigit(int32_t c) {
+  return static_cast<uint32_t>(c - '0') < 10;
+}
+static int32_t hexDigit(int32_t c) {
+  if (isDigit(c)) return c - '0';
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+/* optional sign, then decimal digits */
+static int32_t readInt() {
+  auto c = skipSpaces();
+  bool negative = false;
+  if (c == '-' || c == '+') {
+    negative = c == '-';
+    inPos++;
+    c = peekChar();
+  }
+  uint32_t value = 0;
+  while (isDigit(c)) {
+    value = value * 10 + static_cast<uint32_t>(c - '0');
+    inPos++;
+    c = peekChar();
+  }
+  return static_cast<int32_t>(negative ? 0 - value : value);
+}
+/* 2^exp as double, exp clamped to the normal range */
+static double exp2Double(int32_t exp) {
+  exp = exp < -1022 ? -1022 : (exp > 1023 ? 1023 : exp);
+  const auto bits = static_cast<uint64_t>(exp + 1023) << 52;
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+/* exponent digits after 'e'/'p' */
+static int32_t readExponent() {
+  inPos++;
+  return readInt();
+}
+/*
+ * decimal: up to 19 significant digits, scaled by powers of ten in double;
+ * hex: up to 15 significant digits, scaled by 2^exp exactly.
+ */
+static float readFloat() {
+  auto c = skipSpaces();
+  bool negative = false;
+  if (c == '-' || c == '+') {
+    negative = c == '-';
+    inPos++;
+    c = peekChar();
+  }
+  uint64_t mantissa = 0;
+  uint32_t digits = 0;
+  int32_t exp = 0;
+  bool fraction = false;
+  double value;
+  if (c == '0') {
+    inPos++;
+    c = peekChar();
+  }
+  if (c == 'x' || c == 'X') {
+    inPos++;
+    c = peekChar();
+    while (true) {
+      if (c == '.' && !fraction) {
+        fraction = true;
+      } else {
+        const auto digit = hexDigit(c);
+        if (digit < 0) break;
+        if (digits < 15) {
+          mantissa = mantissa << 4 | static_cast<uint64_t>(digit);
+          if (mantissa) digits++;
+          if (fraction) exp -= 4;
+        } else if (!fraction) {
+          exp += 4;
+        }
+      }
+      inPos++;
+      c = peekChar();
+    }
+    if (c == 'p' || c == 'P') exp += readExponent();
+    value = static_cast<double>(mantissa) * exp2Double(exp);
+  } else {
+    while (true) {
+      if (c == '.' && !fraction) {
+        fraction = true;
+      } else {
+        if (!isDigit(c)) break;
+        if (digits < 19) {
+          mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+          if (mantissa) digits++;
+          if (fraction) exp--;
+        } else if (!fraction) {
+          exp++;
+        }
+      }
+      inPos++;
+      c = peekChar();
+    }
+    if (c == 'e' || c == 'E') exp += readExponent();
+    value = static_cast<double>(mantissa);
+    double scale = 1.0;
+    for (auto i = exp < 0 ? -exp : exp; i > 0; i--)
+      scale *= 10.0;
+    value = exp < 0 ? value / scale : value * scale;
+  }
+  return static_cast<float>(negative ? -value : value);
+}
+
+static void flushOutput() {
+  if (stdioDirty) {
+    fflush(nullptr);
+    stdioDirty = false;
+  }
+  uint32_t pos = 0;
+  while (pos < outPos) {
+    const auto size = write(1, outBuffer + pos, outPos - pos);
+    if (size <= 0) break;
+    pos += static_cast<uint32_t>(size);
+  }
+  outPos = 0;
+}
+/* at most 32 bytes per call, flushed before they could overflow */
+static uint8_t* reserve() {
+  if (outPos > bufferSize - 32) flushOutput();
+  return outBuffer + outPos;
+}
+static void writeChar(int32_t c) {
+  reserve()[0] = static_cast<uint8_t>(c);
+  outPos++;
+}
+static void writeInt(int32_t x) {
+  auto out = reserve();
+  auto value = static_cast<uint32_t>(x);
+  if (x < 0) {
+    *out++ = '-';
+    value = 0 - value;
+  }
+  uint8_t digits[10];
+  uint32_t count = 0;
+  do {
+    digits[count++] = static_cast<uint8_t>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  while (count) *out++ = digits[--count];
+  outPos = static_cast<uint32_t>(out - outBuffer);
+}
+/* printf("%a", (double)x) */
+static void writeFloat(float x) {
+  const double value = x;
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  auto out = reserve();
+  if (bits >> 63) *out++ = '-';
+  const auto biased = static_cast<int32_t>(bits >> 52 & 0x7ff);
+  auto mantissa = bits & ((uint64_t{1} << 52) - 1);
+  if (biased == 0x7ff) {
+    memcpy(out, mantissa ? "nan" : "inf", 3);
+    outPos = static_cast<uint32_t>(out + 3 - outBuffer);
+    return;
+  }
+  *out++ = '0';
+  *out++ = 'x';
+  /* float values are normal doubles or zero */
+  *out++ = biased ? '1' : '0';
+  if (mantissa) {
+    *out++ = '.';
+    while (mantissa) {
+      const auto digit = static_cast<uint32_t>(mantissa >> 48);
+      *out++ = static_cast<uint8_t>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+      mantissa = mantissa << 4 & ((uint64_t{1} << 52) - 1);
+    }
+  }
+  *out++ = 'p';
+  auto exp = biased ? biased - 1023 : 0;
+  *out++ = exp < 0 ? '-' : '+';
+  outPos = static_cast<uint32_t>(out - outBuffer);
+  writeInt(exp < 0 ? -exp : exp);
+}
+
+extern "C" {
+int sysycGetint() {
+  return readInt();
+}
+int sysycGetch() {
+  const auto c = peekChar();
+  if (c >= 0) inPos++;
+  return c;
+}
+float sysycGetfloat() {
+  return readFloat();
+}
+int sysycGetarray(int a[]) {
+  const auto n = readInt();
+  for (int32_t i = 0; i < n; i++)
+    a[i] = readInt();
+  return n;
+}
+int sysycGetfarray(float a[]) {
+  const auto n = readInt();
+  for (int32_t i = 0; i < n; i++)
+    a[i] = readFloat();
+  return n;
+}
+void sysycPutint(int a) {
+  writeInt(a);
+}
+void sysycPutch(int a) {
+  writeChar(a);
+}
+void sysycPutfloat(float a) {
+  writeFloat(a);
+}
+void sysycPutarray(int n, int a[]) {
+  writeInt(n);
+  writeChar(':');
+  for (int32_t i = 0; i < n; i++) {
+    writeChar(' ');
+    writeInt(a[i]);
+  }
+  writeChar('\n');
+}
+void sysycPutfarray(int n, float a[]) {
+  writeInt(n);
+  writeChar(':');
+  for (int32_t i = 0; i < n; i++) {
+    writeChar(' ');
+    writeFloat(a[i]);
+  }
+  writeChar('\n');
+}
+/* printf formats go through stdio, after our buffer */
+void sysycPutf(char a[], ...) {
+  flushOutput();
+  stdioDirty = true;
+  va_list args;
+  va_start(args, a);
+  vfprintf(stdout, a, args);
+  va_end(args);
+}
+__attribute((destructor)) void sysycFlush() {
+  flushOutput();
+}
+}
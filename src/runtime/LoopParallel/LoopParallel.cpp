@@ -12,8 +12,12 @@
 
 /* make sure names inside 'extern "C"' are not changed by mangling */
 extern "C" {
-/* execute before main() */
-__attribute((constructor)) void cmmcInitRuntime() {
+/*
+ * the team is started by the first call that goes parallel, so programs whose
+ * parallel loops all stay serial never clone a thread
+ */
+static bool workersStarted;  // NOLINT
+static void cmmcInitRuntime() {
   for (uint32_t i = 0; i < maxThreads; ++i) {
     auto& worker = workers[i];
     worker.run = 1;
@@ -23,9 +27,11 @@ __attribute((constructor)) void cmmcInitRuntime() {
     worker.pid = clone(cmmcWorker, static_cast<uint8_t*>(worker.stack) + stackSize,
                        threadCreationFlags, &worker);
   }
+  workersStarted = true;
 }
 /* execute after main() */
 __attribute((destructor)) void cmmcUninitRuntime() {
+  if (!workersStarted) return;
   for (auto& worker : workers) {
     worker.run = 0;
     worker.ready.post();
@@ -36,47 +42,55 @@ __attribute((destructor)) void cmmcUninitRuntime() {
   //     munmap(worker.stack, stackSize);
 }
 using Time = int64_t;
+/*
+ * Team size per call site (loop body) and size class (log2 of the trip count),
+ * learned from timed runs instead of a fixed small-task cutoff:
+ * - explore: the first exploreCalls calls run serial, 2 and 4 threads in turn;
+ * - exploit: the configuration with the least time per iteration, timed every
+ *   measurePeriod calls; when that time drifts by more than half from the value
+ *   it was chosen with (a phase change of the input), or after revisitCalls
+ *   calls, the site explores again.
+ */
 struct ParallelForEntry final {
-  CmmcForLoop func;
-  uint32_t size;
-  bool valid;
+  CmmcForLoop func;  // nullptr: free
+  uint32_t sizeClass;
   uint32_t hitCount;
-  static constexpr uint32_t sampleThreshold = 100;
-  static constexpr uint32_t sampleCount = 20;
-  static constexpr uint32_t stopSampleThreshold = sampleThreshold + 3 * sampleCount;
-  Time times[3];  // 1T 2T 4T
-  uint32_t bestThreads;
+  uint32_t calls;   // since the last exploration started
+  uint32_t choice;  // 0: serial, 1: 2 threads, 2: 4 threads
+  Time cost[3];     // EWMA of 16 * ns per iteration, 0: not measured
+  Time reference;   // cost[choice] when chosen
+  static constexpr uint32_t exploreCalls = 3 * 2;
+  static constexpr uint32_t measurePeriod = 8;
+  static constexpr uint32_t revisitCalls = 1024;
 };
-constexpr uint32_t entryCount = 16;
+static_assert(sizeof(ParallelForEntry) == 56);
+constexpr uint32_t entryCount = 32;
 static ParallelForEntry parallelCache[entryCount];  // NOLINT
 static uint32_t lookupPtr;                          // NOLINT
-static ParallelForEntry& selectEntry(CmmcForLoop func, uint32_t size) {
+static ParallelForEntry& selectEntry(CmmcForLoop func, uint32_t sizeClass) {
   // fprintf(stderr, "lookup %p %d\n", func, size);
-  for (uint32_t i = 0; i < entryCount; ++i, ++lookupPtr) {
-    if (lookupPtr == entryCount) lookupPtr = 0;
-    auto& entry = parallelCache[lookupPtr];
-    if (entry.valid && entry.func == func && entry.size == size) {
-      entry.hitCount++;
-      return entry;
-    }
+  auto& last = parallelCache[lookupPtr];
+  if (last.func == func && last.sizeClass == sizeClass) {
+    last.hitCount++;
+    return last;
   }
-  // select an empty slot
   for (uint32_t i = 0; i < entryCount; ++i) {
     auto& entry = parallelCache[i];
-    if (!entry.valid) {
-      entry.valid = true;
-      entry.func = func;
-      entry.size = size;
-      entry.hitCount = 1;
+    if (entry.func == func && entry.sizeClass == sizeClass) {
+      entry.hitCount++;
       lookupPtr = i;
       return entry;
     }
   }
-  // evict
+  // select an empty slot, or evict the least used one
   uint32_t minHitCount = std::numeric_limits<uint32_t>::max();
   uint32_t best = 0;
   for (uint32_t i = 0; i < entryCount; ++i) {
     auto& entry = parallelCache[i];
+    if (!entry.func) {
+      best = i;
+      break;
+    }
     if (entry.hitCount < minHitCount) {
       best = i;
       minHitCount = entry.hitCount;
@@ -84,132 +98,410 @@ static ParallelForEntry& selectEntry(CmmcForLoop func, uint32_t size) {
   }
 
   auto& entry = parallelCache[best];
+  entry = ParallelForEntry{};
   entry.func = func;
-  entry.size = size;
+  entry.sizeClass = sizeClass;
   entry.hitCount = 1;
   lookupPtr = best;
   return entry;
 }
+static uint32_t sizeClassOf(uint32_t size) {
+  return 31 - static_cast<uint32_t>(__builtin_clz(size));
+}
 static Time getTimePoint() {
   timespec tp;
   clock_gettime(CLOCK_MONOTONIC, &tp);
   return tp.tv_sec * 1'000'000'000LL + tp.tv_nsec;
 }
-static ParallelForEntry& selectNumberOfThreads(CmmcForLoop func,
-                                               uint32_t size,
-                                               uint32_t& threads,
-                                               bool& sample) {
-  auto& entry = selectEntry(func, size);
-  // fprintf(stderr, "hitCount %d\n", entry.hitCount);
-  if (entry.hitCount < ParallelForEntry::sampleThreshold) {
-    threads = 2;
-    sample = false;
-    return entry;
+/* teamOnly: fork-join regions run on the whole team, 2 threads is not a choice */
+static uint32_t selectChoice(ParallelForEntry& entry, bool teamOnly) {
+  if (entry.calls >= ParallelForEntry::revisitCalls) {
+    entry.calls = 0;
+    entry.cost[0] = entry.cost[1] = entry.cost[2] = 0;
   }
-  // fprintf(stdout, "here\n");
-  if (entry.hitCount < ParallelForEntry::stopSampleThreshold) {
-    threads =
-      ((entry.hitCount - ParallelForEntry::sampleThreshold) / ParallelForEntry::sampleCount);
-    sample = true;
-    return entry;
+  const auto calls = entry.calls++;
+  if (calls < ParallelForEntry::exploreCalls) {
+    const auto choice = calls % 3;
+    return teamOnly && choice == 1 ? 2 : choice;
   }
-  // fprintf(stderr, "hitCount %d\n", entry.hitCount);
-  if (!entry.bestThreads) {
+  if (calls == ParallelForEntry::exploreCalls) {
     uint32_t best = 0;
-    Time minTime = std::numeric_limits<Time>::max();
+    Time minCost = std::numeric_limits<Time>::max();
     for (uint32_t i = 0; i < 3; ++i)
-      if (entry.times[i] < minTime) {
+      if (entry.cost[i] && entry.cost[i] < minCost) {
         best = i;
-        minTime = entry.times[i];
+        minCost = entry.cost[i];
       }
-    entry.bestThreads = best;
+    entry.choice = best;
+    entry.reference = minCost;
   }
-  threads = entry.bestThreads;
-  sample = false;
-  return entry;
+  return entry.choice;
+}
+/* after selectChoice: time this call? */
+static bool shouldMeasure(const ParallelForEntry& entry) {
+  return entry.calls <= ParallelForEntry::exploreCalls ||
+         entry.calls % ParallelForEntry::measurePeriod == 0;
+}
+static void recordCost(ParallelForEntry& entry, uint32_t choice, Time elapsed, uint32_t size) {
+  const auto sample = std::max<Time>(elapsed * 16 / size, 1);
+  auto& cost = entry.cost[choice];
+  cost = cost ? (cost * 3 + sample) / 4 : sample;
+  if (entry.calls > ParallelForEntry::exploreCalls && choice == entry.choice &&
+      (cost * 2 > entry.reference * 3 || cost * 3 < entry.reference * 2))
+    entry.calls = ParallelForEntry::revisitCalls;
+}
+
+/* nested parallel calls (from a body running on the team) get false */
+static bool acquireTeam() {
+  uint32_t idle = 0;
+  return teamBusy.compare_exchange_strong(idle, 1);
+}
+static void releaseTeam() {
+  teamBusy.store(0);
+}
+
+/* iterations per cache line of the body's stores, a power of two; 1: no hint */
+static uint32_t chunkAlignment(const void* payload) {
+  const auto hint = *static_cast<const uint32_t*>(payload);
+  return hint - 1 < cacheLineSize / sizeof(int32_t) ? hint : 1;
+}
+/*
+ * chunk idx of threads of [beg, end): the boundaries between two chunks are multiples
+ * of alignment, so workers writing a line-aligned array never share a cache line;
+ * false: empty chunk
+ */
+static bool chunkOf(int32_t beg, int32_t end, uint32_t alignment, uint32_t idx, uint32_t threads,
+                    int32_t& subBeg, int32_t& subEnd) {
+  const bool isForward = end > beg;
+  const auto size = static_cast<uint32_t>(isForward ? end - beg : beg - end);
+  const auto mask = alignment - 1;
+  const auto inc = static_cast<int32_t>(std::max((size / threads + mask) & ~mask, alignment));
+  const auto i = static_cast<int32_t>(idx);
+  if (isForward) {
+    const auto origin = beg & ~static_cast<int32_t>(mask);
+    subBeg = idx ? origin + i * inc : beg;
+    subEnd = std::min(origin + (i + 1) * inc, end);
+  } else {
+    const auto origin = beg | static_cast<int32_t>(mask);
+    subBeg = idx ? origin - i * inc : beg;
+    subEnd = std::max(origin - (i + 1) * inc, end);
+  }
+  if (idx == threads - 1) subEnd = end;
+  return isForward ? subBeg < subEnd : subBeg > subEnd;
+}
+
+/* split [beg, end) into threads chunks, run them on the workers and join */
+static void spawnAndJoin(int32_t beg, int32_t end, CmmcForLoop func, uint32_t threads,
+                         uint32_t alignment) {
+  // fprintf(stderr, "parallel for %d %d\n", beg, end);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  std::array<bool, maxThreads> assigned{};
+
+  for (uint32_t i = 0; i < threads; ++i) {
+    int32_t subBeg, subEnd;
+    if (not chunkOf(beg, end, alignment, i, threads, subBeg, subEnd)) continue;
+
+    // fprintf(stderr, "launch %d %d\n", subBeg, subEnd);
+    auto& worker = workers[static_cast<size_t>(i)];
+    worker.func = func;
+    worker.beg = subBeg;
+    worker.end = subEnd;
+
+    // Signal worker
+    worker.ready.post(); /* run sub threads */
+    assigned[static_cast<size_t>(i)] = true;
+  }
+
+  for (uint32_t i = 0; i < threads; ++i) {
+    if (assigned[i]) workers[i].done.wait();
+  }
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
 }
 
-void parallelFor(int32_t beg, int32_t end, CmmcForLoop func) {
+void parallelFor(int32_t beg, int32_t end, CmmcForLoop func, void* payload) {
   // Handle the case where end <= beg
   if (end == beg) {
     return;
   }
 
-  // Determine if we are iterating forwards or backwards
-  const bool isForward = end > beg;
-
   // Calculate the size of the range
-  const auto size = static_cast<uint32_t>(isForward ? end - beg : beg - end);
-  constexpr uint32_t smallTask = 16;
+  const auto size = static_cast<uint32_t>(end > beg ? end - beg : beg - end);
 
-  // If the range is too small, execute it directly in the main thread
-  if (size < smallTask) {
-    func(beg, end);
+  // If the team is busy (nested call), execute it inline
+  if (not acquireTeam()) {
+    func(beg, end, payload);
     return;
   }
 
-  auto spawnAndJoin = [&](uint32_t threads) {
-    if (threads == 1) {
-      func(beg, end);
-      return;
-    }
-
-    // fprintf(stderr, "parallel for %d %d\n", beg, end);
-    std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto& entry = selectEntry(func, sizeClassOf(size));
+  const auto choice = selectChoice(entry, false);
+  const bool measure = shouldMeasure(entry);
+  // fprintf(stderr, "choice %d\n", choice);
+  const Time start = measure ? getTimePoint() : 0;
 
-    constexpr uint32_t alignment = 4;
-    const auto inc =
-      static_cast<int32_t>(((size / threads) + alignment - 1) / alignment * alignment);
-    std::array<bool, maxThreads> assigned{};
+  if (choice == 0) {
+    func(beg, end, payload);
+  } else {
+    if (!workersStarted) cmmcInitRuntime();
+    teamPayload = payload;
+    spawnAndJoin(beg, end, func, 1U << choice, chunkAlignment(payload));
+  }
 
-    for (int32_t i = 0; i < static_cast<int32_t>(threads); ++i) {
-      int32_t subBeg, subEnd;
+  if (measure) recordCost(entry, choice, getTimePoint() - start, size);
+  releaseTeam();
+}
 
-      if (isForward) {
-        subBeg = beg + i * inc;
-        subEnd = std::min(subBeg + inc, end);
-      } else {
-        subBeg = beg - i * inc;
-        subEnd = std::max(subBeg - inc, end);
-      }
+/*
+ * fork-join region: the loops of one region are run by a single wake/join of
+ * the team, workers pass an in-team spin barrier between two loops.
+ */
+struct RegionLoop final {
+  int32_t beg, end;
+  CmmcForLoop func;
+  void* payload;
+};
+/* in the frame of the parallelForRegionN caller, valid until the join */
+static const RegionLoop* regionLoops;         // NOLINT
+static uint32_t regionCount;                  // NOLINT
+/* the barrier words, spun on by the team, on a line of their own */
+alignas(cacheLineSize) static std::atomic_uint32_t regionArrived;  // NOLINT
+static std::atomic_uint32_t regionGeneration;                       // NOLINT
 
-      if (static_cast<uint32_t>(i) == threads - 1) subEnd = end;
+static void regionBarrier(uint32_t threads) {
+  const auto generation = regionGeneration.load();
+  if (regionArrived.fetch_add(1) + 1 == threads) {
+    regionArrived.store(0);
+    regionGeneration.fetch_add(1);
+  } else {
+    /* the team stays hot: spin instead of futex wait */
+    while (regionGeneration.load() == generation)
+      ;
+  }
+}
 
-      if (isForward ? subBeg >= subEnd : subBeg <= subEnd) continue;
+/* task of worker tid: its chunk of every loop, chunks as in parallelFor */
+static void regionWorker(int32_t tid, int32_t threads, void*) {
+  for (uint32_t idx = 0; idx < regionCount; ++idx) {
+    const auto& loop = regionLoops[idx];
+    int32_t subBeg, subEnd;
+    if (chunkOf(loop.beg, loop.end, chunkAlignment(loop.payload), static_cast<uint32_t>(tid),
+                static_cast<uint32_t>(threads), subBeg, subEnd))
+      loop.func(subBeg, subEnd, loop.payload);
 
-      // fprintf(stderr, "launch %d %d\n", subBeg, subEnd);
-      auto& worker = workers[static_cast<size_t>(i)];
-      worker.func = func;
-      worker.beg = subBeg;
-      worker.end = subEnd;
+    if (idx + 1 < regionCount) regionBarrier(static_cast<uint32_t>(threads));
+  }
+}
 
-      // Signal worker
-      worker.ready.post(); /* run sub threads */
-      assigned[static_cast<size_t>(i)] = true;
+static void parallelForRegion(const RegionLoop* loops, uint32_t count) {
+  uint32_t size = 0;
+  for (uint32_t idx = 0; idx < count; ++idx) {
+    const auto& loop = loops[idx];
+    size += static_cast<uint32_t>(loop.end > loop.beg ? loop.end - loop.beg : loop.beg - loop.end);
+  }
+  if (size == 0) return;
+  /* nested: run the loops one after another inline */
+  if (not acquireTeam()) {
+    for (uint32_t idx = 0; idx < count; ++idx) {
+      const auto& loop = loops[idx];
+      if (loop.beg != loop.end) loop.func(loop.beg, loop.end, loop.payload);
     }
+    return;
+  }
+  /* the region is learned as one site, keyed by its first body */
+  auto& entry = selectEntry(loops[0].func, sizeClassOf(size));
+  const auto choice = selectChoice(entry, true);
+  const bool measure = shouldMeasure(entry);
+  const Time start = measure ? getTimePoint() : 0;
 
-    for (uint32_t i = 0; i < threads; ++i) {
-      if (assigned[i]) workers[i].done.wait();
+  if (choice == 0) {
+    for (uint32_t idx = 0; idx < count; ++idx) {
+      const auto& loop = loops[idx];
+      if (loop.beg != loop.end) loop.func(loop.beg, loop.end, loop.payload);
     }
+  } else {
+    if (!workersStarted) cmmcInitRuntime();
+    regionLoops = loops;
+    regionCount = count;
 
     std::atomic_thread_fence(std::memory_order_seq_cst);
-  };
+    /* every worker takes part, the barrier counts maxThreads arrivals */
+    for (uint32_t i = 0; i < maxThreads; ++i) {
+      auto& worker = workers[i];
+      worker.func = regionWorker;
+      worker.beg = static_cast<int32_t>(i);
+      worker.end = static_cast<int32_t>(maxThreads);
+      worker.ready.post();
+    }
+    for (auto& worker : workers)
+      worker.done.wait();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  if (measure) recordCost(entry, choice, getTimePoint() - start, size);
+  releaseTeam();
+}
+
+void parallelForRegion2(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1) {
+  const RegionLoop loops[] = {{beg0, end0, func0, payload0}, {beg1, end1, func1, payload1}};
+  parallelForRegion(loops, 2);
+}
 
-  bool sample;
-  uint32_t threads;
-  auto& entry = selectNumberOfThreads(func, size, threads, sample);
-  // fprintf(stderr, "threads %d\n", threads);
-  Time start;
+void parallelForRegion3(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1,
+                        int32_t beg2, int32_t end2, CmmcForLoop func2, void* payload2) {
+  const RegionLoop loops[] = {{beg0, end0, func0, payload0},
+                              {beg1, end1, func1, payload1},
+                              {beg2, end2, func2, payload2}};
+  parallelForRegion(loops, 3);
+}
 
-  if (sample) start = getTimePoint();
+void parallelForRegion4(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1,
+                        int32_t beg2, int32_t end2, CmmcForLoop func2, void* payload2,
+                        int32_t beg3, int32_t end3, CmmcForLoop func3, void* payload3) {
+  const RegionLoop loops[] = {{beg0, end0, func0, payload0},
+                              {beg1, end1, func1, payload1},
+                              {beg2, end2, func2, payload2},
+                              {beg3, end3, func3, payload3}};
+  parallelForRegion(loops, 4);
+}
 
-  spawnAndJoin(1 << threads);
+/*
+ * Task parallelism of recursive divide-and-conquer functions (TaskParallel): the
+ * outermost parallelInvoke2 takes the team, every thread of it owns a deque of
+ * spawned tasks. The owner pushes and pops at the bottom, idle threads steal from
+ * the top; a thread waiting for a stolen task steals others meanwhile. Tasks are
+ * coarse (the compiler stops spawning below a depth cutoff), so a spin lock per
+ * deque is cheap enough.
+ */
+struct Task final {
+  CmmcTask func;
+  void* payload;
+  std::atomic_uint32_t done;
+};
+constexpr uint32_t taskDequeSize = 64;
+struct alignas(cacheLineSize) TaskDeque final {
+  std::atomic_uint32_t lock;
+  std::atomic_uint32_t top, bottom;
+  Task* tasks[taskDequeSize];
+};
+/* workers[i] owns taskDeques[i], the thread that started the region the last one */
+static TaskDeque taskDeques[maxThreads + 1];  // NOLINT
+static std::atomic_uint32_t taskActive;       // NOLINT
 
-  if (sample) {
-    const auto stop = getTimePoint();
-    const auto diff = stop - start;
-    entry.times[threads] += diff;
+static void lockDeque(TaskDeque& deque) {
+  while (deque.lock.exchange(1))
+    while (deque.lock.load())
+      ;
+}
+static void unlockDeque(TaskDeque& deque) {
+  deque.lock.store(0);
+}
+/* deque of the calling thread: workers are told apart by their stacks */
+static uint32_t selfIndex() {
+  const auto sp = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+  for (uint32_t i = 0; i < maxThreads; ++i) {
+    if (sp - reinterpret_cast<uintptr_t>(workers[i].stack) < stackSize) return i;
+  }
+  return maxThreads;
+}
+static bool pushTask(TaskDeque& deque, Task* task) {
+  lockDeque(deque);
+  const auto bottom = deque.bottom.load();
+  const bool pushed = bottom < taskDequeSize;
+  if (pushed) {
+    deque.tasks[bottom] = task;
+    deque.bottom = bottom + 1;
+  }
+  unlockDeque(deque);
+  return pushed;
+}
+/* the tasks pushed after task are gone, so it is the last one unless it was stolen */
+static bool popTask(TaskDeque& deque, Task* task) {
+  lockDeque(deque);
+  const auto bottom = deque.bottom.load();
+  const bool popped = bottom > deque.top && deque.tasks[bottom - 1] == task;
+  if (popped) deque.bottom = bottom - 1;
+  if (deque.bottom == deque.top) deque.top = deque.bottom = 0;
+  unlockDeque(deque);
+  return popped;
+}
+static Task* stealTask(uint32_t self) {
+  for (uint32_t i = 1; i <= maxThreads; ++i) {
+    auto& deque = taskDeques[(self + i) % (maxThreads + 1)];
+    if (deque.top.load() == deque.bottom.load()) continue;
+    lockDeque(deque);
+    Task* task = nullptr;
+    const auto top = deque.top.load();
+    if (top < deque.bottom) {
+      task = deque.tasks[top];
+      deque.top = top + 1;
+    }
+    unlockDeque(deque);
+    if (task) return task;
+  }
+  return nullptr;
+}
+static void runTask(Task* task) {
+  task->func(task->payload);
+  task->done.store(1);
+}
+/* task of worker tid while the region lasts */
+static void taskWorker(int32_t tid, int32_t, void*) {
+  while (taskActive.load()) {
+    if (auto task = stealTask(static_cast<uint32_t>(tid))) runTask(task);
+  }
+}
+static void invokeTasks(CmmcTask func0, void* payload0, CmmcTask func1, void* payload1) {
+  const auto self = selfIndex();
+  auto& deque = taskDeques[self];
+  Task task{func1, payload1, {0}};
+  if (not pushTask(deque, &task)) {
+    func0(payload0);
+    func1(payload1);
+    return;
+  }
+  func0(payload0);
+  if (popTask(deque, &task)) {
+    func1(payload1);
+    return;
+  }
+  /* stolen: help the team until the thief is done */
+  while (not task.done.load()) {
+    if (auto other = stealTask(self)) runTask(other);
+  }
+}
+
+void parallelInvoke2(CmmcTask func0, void* payload0, CmmcTask func1, void* payload1) {
+  /* spawned from a task: only threads of the team run while the region lasts */
+  if (taskActive.load()) {
+    invokeTasks(func0, payload0, func1, payload1);
+    return;
+  }
+  /* nested in a parallel loop */
+  if (not acquireTeam()) {
+    func0(payload0);
+    func1(payload1);
+    return;
+  }
+  if (!workersStarted) cmmcInitRuntime();
+  taskActive.store(1);
+  for (uint32_t i = 0; i < maxThreads; ++i) {
+    auto& worker = workers[i];
+    worker.func = taskWorker;
+    worker.beg = static_cast<int32_t>(i);
+    worker.end = static_cast<int32_t>(maxThreads);
+    worker.ready.post();
   }
+  /* every task is joined by its parent: the region is over when the root returns */
+  invokeTasks(func0, payload0, func1, payload1);
+  taskActive.store(0);
+  for (auto& worker : workers)
+    worker.done.wait();
+  releaseTeam();
 }
 
 // constexpr uint32_t m1 = 1021, m2 = 1019;
@@ -16,6 +16,14 @@
 
 #include <stdio.h>
 constexpr uint32_t maxThreads = 4;
+constexpr uint32_t cacheLineSize = 64;
+/*
+ * stack of each worker. Loop bodies are leaf-like, but a task (parallelInvoke2) runs the
+ * whole recursion below the spawned call on it: TaskParallel only spawns in the top
+ * parallel.task-depth levels, so a task body may recurse as deep as the serial call
+ * minus those levels and needs stack for that; programs recursing deeper than ~1 MiB of
+ * frames must keep taskparallel off (it is not in the default pipeline).
+ */
 constexpr auto stackSize = 1024 * 1024;  // 1MB
 constexpr auto threadCreationFlags =
   CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD | CLONE_SYSVSEM;
@@ -27,7 +35,13 @@ CLONE_SIGHAND: share the same table of signal handlers
 CLONE_THREAD: create a new thread
 CLONE_SYSVSEM: share the same System V semaphore table
 */
-using CmmcForLoop = void (*)(int32_t beg, int32_t end);
+/*
+ * payload: captures of the loop body, in the frame of the caller; the first word is
+ * the chunk alignment hint of ParallelBodyExtract (iterations per cache line)
+ */
+using CmmcForLoop = void (*)(int32_t beg, int32_t end, void* payload);
+/* payload: arguments, recursion depth and result slot of the spawned call */
+using CmmcTask = void (*)(void* payload);
 
 namespace {
 class Futex final {
@@ -56,7 +70,8 @@ public:
   }
 };
 
-struct Worker final {
+/* one cache line per worker: the futexes of two workers never share a line */
+struct alignas(cacheLineSize) Worker final {
   pid_t pid;
   void* stack;
   std::atomic_uint32_t core;
@@ -68,7 +83,12 @@ struct Worker final {
   Futex ready, done;
 };
 
+static_assert(sizeof(Worker) == cacheLineSize);
+
 Worker workers[maxThreads];  // NOLINT
+/* one team: taken by the outermost parallel call, nested calls run inline */
+std::atomic_uint32_t teamBusy;   // NOLINT
+std::atomic<void*> teamPayload;  // NOLINT
 
 static_assert(std::atomic_uint32_t::is_always_lock_free);
 static_assert(std::atomic_int32_t::is_always_lock_free);
@@ -90,7 +110,7 @@ int cmmcWorker(void* ptr) {
     if (!worker.run) break;
     // exec task
     std::atomic_thread_fence(std::memory_order_seq_cst);
-    worker.func.load()(worker.beg.load(), worker.end.load());
+    worker.func.load()(worker.beg.load(), worker.end.load(), teamPayload.load());
     std::atomic_thread_fence(std::memory_order_seq_cst);
 
     // fprintf(stderr, "finish %d %d\n", worker.beg.load(), worker.end.load());
@@ -100,6 +120,20 @@ int cmmcWorker(void* ptr) {
   return 0;
 }
 }  // namespace
+/* loops per fork-join region (parallelForRegion2..4) */
+constexpr uint32_t maxRegionLoops = 4;
 extern "C" {
-void parallelFor(int32_t beg, int32_t end, CmmcForLoop func);
+void parallelFor(int32_t beg, int32_t end, CmmcForLoop func, void* payload);
+/* consecutive parallel loops sharing one wake/join of the team */
+void parallelForRegion2(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1);
+void parallelForRegion3(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1,
+                        int32_t beg2, int32_t end2, CmmcForLoop func2, void* payload2);
+void parallelForRegion4(int32_t beg0, int32_t end0, CmmcForLoop func0, void* payload0,
+                        int32_t beg1, int32_t end1, CmmcForLoop func1, void* payload1,
+                        int32_t beg2, int32_t end2, CmmcForLoop func2, void* payload2,
+                        int32_t beg3, int32_t end3, CmmcForLoop func3, void* payload3);
+/* two independent tasks of a recursive function (TaskParallel), joined before returning */
+void parallelInvoke2(CmmcTask func0, void* payload0, CmmcTask func1, void* payload1);
 }
\ No newline at end of file
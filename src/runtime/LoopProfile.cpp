@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <cstdio>
+
+/*
+ * Runtime of -finstrument-loops.
+ *
+ * The loopprofile pass calls the hooks below at function entry/return and at
+ * loop preheaders/exits, and bumps sysyc_prof_trips[loop] in every loop header.
+ * Cycles and retired instructions are read with rdcycle/rdinstret; a recursive
+ * function (or a loop inside one) is timed by its outermost activation only.
+ * Counters are not atomic: loops run by parallelFor workers are approximate.
+ *
+ * meta (i32 words, built by the pass):
+ *   [0] funcCount, [1] loopCount,
+ *   funcCount x name offset (in words, from meta),
+ *   loopCount x {fid, index in function, depth},
+ *   names, one char per word, 0-terminated.
+ *
+ * Report (sysyc.prof, stderr if it cannot be created), read by -fprofile-use:
+ *   # sysyc loop profile v1
+ *   func <name> <calls> <cycles> <instret>
+ *   loop <func> <index> <depth> <entries> <trips> <cycles> <instret>
+ */
+extern "C" {
+struct alignas(64) ProfCounter final {
+  uint64_t count;  // calls or loop entries
+  uint64_t trips;  // header executions, loops only
+  uint64_t cycles;
+  uint64_t instret;
+  uint64_t startCycles;
+  uint64_t startInstret;
+  uint32_t active;
+};
+static_assert(sizeof(ProfCounter) == 64);
+
+constexpr uint32_t maxCounters = 1024;
+constexpr uint32_t nameBufSize = 128;
+static const int* profMeta;                       // NOLINT
+static uint32_t* profTrips;                       // NOLINT
+static ProfCounter loopCounters[maxCounters];     // NOLINT
+static ProfCounter funcCounters[maxCounters];     // NOLINT
+
+static inline uint64_t readCycle() {
+  uint64_t val;
+  asm volatile("rdcycle %0" : "=r"(val));
+  return val;
+}
+static inline uint64_t readInstret() {
+  uint64_t val;
+  asm volatile("rdinstret %0" : "=r"(val));
+  return val;
+}
+static void profEnter(ProfCounter& counter) {
+  counter.count++;
+  if (counter.active++ == 0) {
+    counter.startInstret = readInstret();
+    counter.startCycles = readCycle();
+  }
+}
+static void profLeave(ProfCounter& counter) {
+  const auto cycles = readCycle(), instret = readInstret();
+  if (counter.active == 0 || --counter.active != 0) return;
+  counter.cycles += cycles - counter.startCycles;
+  counter.instret += instret - counter.startInstret;
+}
+
+void sysycProfInit(const int* meta, uint32_t* trips) {
+  profMeta = meta;
+  profTrips = trips;
+}
+void sysycProfFuncEnter(uint32_t fid) {
+  if (fid < maxCounters) profEnter(funcCounters[fid]);
+}
+void sysycProfFuncExit(uint32_t fid) {
+  if (fid < maxCounters) profLeave(funcCounters[fid]);
+}
+void sysycProfLoopEnter(uint32_t lid) {
+  if (lid < maxCounters) profEnter(loopCounters[lid]);
+}
+void sysycProfLoopExit(uint32_t lid) {
+  if (lid >= maxCounters) return;
+  auto& counter = loopCounters[lid];
+  if (profTrips) {
+    counter.trips += profTrips[lid];
+    profTrips[lid] = 0;
+  }
+  profLeave(counter);
+}
+
+static const char* profName(uint32_t fid, char* buf) {
+  const int* src = profMeta + profMeta[2 + fid];
+  uint32_t i = 0;
+  for (; i + 1 < nameBufSize && src[i]; ++i)
+    buf[i] = static_cast<char>(src[i]);
+  buf[i] = '\0';
+  return buf;
+}
+
+/* execute after main() */
+__attribute((destructor)) void sysycProfReport() {
+  if (!profMeta) return;
+  FILE* out = fopen("sysyc.prof", "w");
+  if (!out) out = stderr;
+  const uint32_t funcCount = profMeta[0], loopCount = profMeta[1];
+  const int* loops = profMeta + 2 + funcCount;
+  char name[nameBufSize];
+  fputs("# sysyc loop profile v1\n", out);
+  for (uint32_t fid = 0; fid < funcCount && fid < maxCounters; ++fid) {
+    const auto& counter = funcCounters[fid];
+    if (!counter.count) continue;
+    fprintf(out, "func %s %lu %lu %lu\n", profName(fid, name), counter.count, counter.cycles,
+            counter.instret);
+  }
+  for (uint32_t lid = 0; lid < loopCount && lid < maxCounters; ++lid) {
+    const auto& counter = loopCounters[lid];
+    if (!counter.count) continue;
+    const int* loop = loops + 3 * lid;
+    fprintf(out, "loop %s %d %d %lu %lu %lu %lu\n", profName(loop[0], name), loop[1], loop[2],
+            counter.count, counter.trips, counter.cycles, counter.instret);
+  }
+  if (out != stderr) fclose(out);
+}
+}
@@ -1,75 +1,191 @@
 #!/usr/bin/env python3
+"""
+Generate the runtime components autogen/riscv/Runtime<Component>.hpp from the C++
+sources of this directory, see RISCVTarget::emit_assembly. The build runs it into
+build/runtime (CMakeLists.txt); the output is not checked in.
 
-import sys
-import subprocess
-import os
-
-target = sys.argv[1]
-# infile = sys.argv[2]
-outfile = sys.argv[2]
-# src = os.path.dirname(os.path.abspath(__file__)) + "/LoopParallel.cpp"
-runtime_dir = os.path.dirname(os.path.abspath(__file__))
+    python3 src/runtime/compile.py RISCV <outdir>/autogen/riscv [Component ...]
 
-memset_cpp = os.path.join(runtime_dir, "memset.cpp")
-lookup_cpp = os.path.join(runtime_dir, "Lookup.cpp")
+Every source is compiled once. A source that backs several components (LoopParallel)
+is split by function: a component claims its functions by name, the functions nobody
+claims and all data stay in the component without a claim list, which emit_assembly
+emits whenever one of the others is. Local labels get a per-source prefix, so the
+components of different sources can be concatenated into one file.
+"""
 
-# parallelFor_dir = os.path.join(runtime_dir, "./MultiThreads")
-# parallelFor_cpp = os.path.join(parallelFor_dir, "MultiThreads.cpp")
+import os
+import re
+import subprocess
+import sys
 
-parallelFor_dir = os.path.join(runtime_dir, "./LoopParallel")
-parallelFor_cpp = os.path.join(parallelFor_dir, "LoopParallel.cpp")
-infiles = [memset_cpp, lookup_cpp, parallelFor_cpp]
+runtime_dir = os.path.dirname(os.path.abspath(__file__))
 
 gcc_ref_command = {
     "RISCV": "riscv64-linux-gnu-g++-12 -Ofast -DNDEBUG -march=rv64gc_zba_zbb -fno-stack-protector -fomit-frame-pointer -mcpu=sifive-u74 -mabi=lp64d -mcmodel=medlow -ffp-contract=on -w ".split(),
     "ARM": "arm-linux-gnueabihf-g++-12 -Ofast -DNDEBUG -march=armv7 -fno-stack-protector -fomit-frame-pointer -mcpu=cortex-a72 -mfpu=vfpv4 -ffp-contract=on -w -no-pie ".split(),
-}[target]
-
-# gcc_ref_command = {
-#     "RISCV": "riscv64-linux-gnu-g++-12 -O2 -DNDEBUG -march=rv64gc -fno-stack-protector -fomit-frame-pointer -mabi=lp64d -mcmodel=medlow -ffp-contract=on -w ".split(),
-#     "ARM": "arm-linux-gnueabihf-g++-12 -O3 -DNDEBUG -march=armv7 -fno-stack-protector -fomit-frame-pointer -mcpu=cortex-a72 -mfpu=vfpv4 -ffp-contract=on -w -no-pie ".split(),
-# }[target]
-
-
-def fixHeader(f) -> str:
-    lines = []
-    for line in f.readlines():
-        if line.startswith('#include "'):
-            header = line[10 : line[10:].find('"') + 10]
-            print(header)
-            print(runtime_dir)
-            print(parallelFor_dir)
-            newHeader = os.path.relpath(parallelFor_dir, runtime_dir) + "/" + header
-            newline = '#include "' + newHeader + '"\n'
-            lines.append(newline)
-        else:
-            lines.append(line)
-    return "".join(lines)
-
-
-merge = ""
-for infile in infiles:
-    if not os.path.exists(infile):
-        print(f"Error: {infile} does not exist")
-        sys.exit(1)
-    with open(infile, "r") as f:
-        merge += "// " + infile + "\n"
-        # merge += f.read()
-        merge += fixHeader(f)
-
-mergefile = os.path.join(runtime_dir, ".merge.cpp")
-with open(mergefile, "w") as f:
-    f.write(merge)
-
-runtime = subprocess.check_output(
-    gcc_ref_command + [mergefile, "-S", "-o", "/dev/stdout"]
-).decode("utf-8")
-
-command = gcc_ref_command + [mergefile, "-S", "-o", "/dev/stdout"]
-
-with open(outfile, "w") as f:
-    f.write("// Automatically generated file, do not edit!\n")
-    f.write("// Command: " + " ".join(command) + "\n")
-    f.write('R"(')
-    f.write(runtime)
-    f.write(')"')
+}
+
+# (component, source, claimed functions or None, description), in emit order
+COMPONENTS = [
+    ("Memset", "memset.cpp", None,
+     "_memset, sysycMemfill and sysycMemcpy, emitted when the module references one of them."),
+    ("ParallelFor", "LoopParallel/LoopParallel.cpp", None,
+     "worker pool started by the first call that goes parallel, parallelFor and the state of\n"
+     "the other LoopParallel components, emitted when the module references parallelFor,\n"
+     "parallelForRegion* or parallelInvoke2."),
+    ("LoopProfile", "LoopProfile.cpp", None,
+     "-finstrument-loops hooks, emitted when the module calls sysycProfInit."),
+    ("ParallelRegion", "LoopParallel/LoopParallel.cpp",
+     ["regionBarrier", "regionWorker", "parallelForRegion",
+      "parallelForRegion2", "parallelForRegion3", "parallelForRegion4"],
+     "fork-join regions, emitted after ParallelFor when the module calls parallelForRegion*."),
+    ("TaskParallel", "LoopParallel/LoopParallel.cpp",
+     ["lockDeque", "unlockDeque", "selfIndex", "pushTask", "popTask", "stealTask",
+      "runTask", "taskWorker", "invokeTasks", "parallelInvoke2"],
+     "work-stealing tasks, emitted after ParallelFor when the module calls parallelInvoke2."),
+    ("IO", "IO.cpp", None,
+     "buffered sysycGetint..sysycPutf and the exit-time flush, emitted when the module calls\n"
+     "one of SysYIORuntimeSymbols (runtime.buffered-io)."),
+]
+
+section_directive = re.compile(r"\t\.(text|data|bss|section)\b")
+preamble_directive = re.compile(r"\t\.(text|data|bss|section|align|p2align|balign|globl|local|hidden|weak|set)\b")
+
+
+def compile_source(command, source) -> str:
+    return subprocess.check_output(command + [source, "-S", "-o", "/dev/stdout"]).decode("utf-8")
+
+
+def prologue_of(asm) -> str:
+    """assembler options before the first section, plus the trailer"""
+    lines = asm.splitlines()
+    start = next(idx for idx, line in enumerate(lines) if section_directive.match(line))
+    trailer = [line for line in lines if line.startswith("\t.ident") or ".note.GNU-stack" in line]
+    return "\n".join(lines[:start] + trailer) + "\n"
+
+
+def body_of(asm, tag) -> list:
+    """asm without prologue and trailer, local labels prefixed with the tag of the source"""
+    lines = asm.splitlines()
+    start = next(idx for idx, line in enumerate(lines) if section_directive.match(line))
+    lines = [line for line in lines[start:] if not line.startswith("\t.ident") and ".note.GNU-stack" not in line]
+    return [re.sub(r"\.L(?=\w)", ".L" + tag + "_", line) for line in lines]
+
+
+def plain(symbol) -> str:
+    """source name of a static or anonymous-namespace function"""
+    symbol = re.sub(r"\.(constprop|isra|part|cold)\.\d+$", "", symbol)
+    for prefix in ("_ZL", "_ZN12_GLOBAL__N_1"):
+        if symbol.startswith(prefix):
+            match = re.match(r"(\d+)", symbol[len(prefix):])
+            if match:
+                begin = len(prefix) + len(match.group(1))
+                return symbol[begin : begin + int(match.group(1))]
+    return symbol
+
+
+def split_functions(lines):
+    """[(function or None, lines)]: each function with the directives in front of it"""
+    chunks = []
+    rest = []
+    idx = 0
+    while idx < len(lines):
+        match = re.match(r"\t\.type\t([^,]+), @function", lines[idx])
+        if not match:
+            rest.append(lines[idx])
+            idx += 1
+            continue
+        name = match.group(1)
+        begin = len(rest)
+        while begin > 0 and preamble_directive.match(rest[begin - 1]):
+            begin -= 1
+        head = rest[begin:]
+        del rest[begin:]
+        if rest:
+            chunks.append((None, rest))
+            rest = []
+        end = next(pos for pos in range(idx, len(lines)) if lines[pos] == "\t.size\t" + name + ", .-" + name)
+        body = head + lines[idx : end + 1]
+        if not any(section_directive.match(line) for line in head):
+            body = ["\t.text"] + body
+        chunks.append((name, body))
+        idx = end + 1
+    if rest:
+        chunks.append((None, rest))
+    return chunks
+
+
+def referenced(lines) -> set:
+    return set(re.findall(r"[A-Za-z_.$][\w.$]*", "\n".join(line for line in lines if not line.startswith("\t.type"))))
+
+
+def defined(lines) -> set:
+    return {line[:-1] for line in lines if re.match(r"^[A-Za-z_.$][\w.$]*:$", line)}
+
+
+def split_source(lines, claims) -> dict:
+    """component -> lines; the unclaimed part under None"""
+    owner = {plain(name): component for component, names in claims.items() for name in names}
+    parts = {component: [] for component in claims}
+    parts[None] = []
+    for name, chunk in split_functions(lines):
+        parts[owner.get(plain(name)) if name else None].extend(chunk)
+    # a claimed part is emitted only with the unclaimed one, never with another claimed part
+    for user in parts:
+        for component in claims:
+            leaked = referenced(parts[user]) & defined(parts[component]) if user != component else set()
+            if leaked:
+                sys.exit(f"Error: {user or 'the unclaimed part'} references {sorted(leaked)} of {component}")
+    return parts
+
+
+def compiler_version(command) -> str:
+    return subprocess.check_output([command[0], "--version"]).decode("utf-8").splitlines()[0]
+
+
+def header(title, source, command, version, asm) -> str:
+    return (
+        "// Automatically generated file, do not edit!\n"
+        + "".join(f"// {line}\n" for line in title.splitlines())
+        + f"// Compiler: {version}\n"
+        + "// Command: " + " ".join(command) + f" src/runtime/{source} -S\n"
+        'R"(' + asm + ')"'
+    )
+
+
+def generate(target, outdir, selected):
+    command = gcc_ref_command[target]
+    sources = {}
+    for _, source, _, _ in COMPONENTS:
+        if source in sources:
+            continue
+        path = os.path.join(runtime_dir, source)
+        if not os.path.exists(path):
+            sys.exit(f"Error: {path} does not exist")
+        sources[source] = compile_source(command, path)
+
+    prologue = "Runtime prologue: assembler options shared by the runtime components and the\n" \
+               "compiled module, always emitted first."
+    outputs = {"Prologue": (prologue, "memset.cpp", prologue_of(sources["memset.cpp"]))}
+    for source, asm in sources.items():
+        tag = os.path.splitext(os.path.basename(source))[0].lower()
+        claims = {component: names for component, src, names, _ in COMPONENTS if src == source and names}
+        parts = split_source(body_of(asm, tag), claims)
+        for component, src, names, description in COMPONENTS:
+            if src == source:
+                title = f"Runtime component {component} (src/runtime/{source}):\n{description}"
+                outputs[component] = (title, source, "\n".join(parts[component if names else None]) + "\n")
+
+    version = compiler_version(command)
+    os.makedirs(outdir, exist_ok=True)
+    for component, (title, source, asm) in outputs.items():
+        if selected and component not in selected:
+            continue
+        with open(os.path.join(outdir, f"Runtime{component}.hpp"), "w") as f:
+            f.write(header(title, source, command, version, asm))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        sys.exit(__doc__)
+    generate(sys.argv[1], sys.argv[2], set(sys.argv[3:]))
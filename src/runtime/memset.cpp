@@ -1,4 +1,4 @@
-
+#include <cstring>
 
 extern "C" {
 void _memset(int* a, int len) {
@@ -6,5 +6,28 @@ void _memset(int* a, int len) {
     a[i] = 0;
   }
 }
+
+/* loop idiom runtime (pass/optimize/Loop/LoopIdiom.cpp), len in bytes */
+void sysycMemfill(int* a, int val, int len) {
+  if (val == 0) {
+    _memset(a, len);
+    return;
+  }
+  for (int i = 0; i * 4 < len; i++) {
+    a[i] = val;
+  }
 }
 
+/* same result as dst[i] = src[i] for ascending i, also when the ranges overlap */
+void sysycMemcpy(int* dst, const int* src, int len) {
+  if (len <= 0) return;
+  const int count = (len + 3) / 4;
+  if (dst <= src or dst >= src + count) {
+    memmove(dst, src, static_cast<size_t>(count) * 4);
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    dst[i] = src[i];
+  }
+}
+}
@@ -0,0 +1,38 @@
+#include "support/DataFlow.hpp"
+
+namespace utils {
+std::vector<NodeIndex> reversePostOrder(const Graph& succs, NodeIndex entry) {
+  const auto size = static_cast<NodeIndex>(succs.size());
+  std::vector<NodeIndex> order;
+  order.reserve(size);
+  std::vector<bool> visited(size);
+  /* iterative dfs: (node, next successor to visit) */
+  std::vector<std::pair<NodeIndex, size_t>> stack;
+  const auto visit = [&](NodeIndex root) {
+    visited[root] = true;
+    stack.emplace_back(root, 0);
+    while (not stack.empty()) {
+      auto& [node, next] = stack.back();
+      if (next < succs[node].size()) {
+        const auto succ = succs[node][next++];
+        if (not visited[succ]) {
+          visited[succ] = true;
+          stack.emplace_back(succ, 0);
+        }
+        continue;
+      }
+      order.push_back(node);
+      stack.pop_back();
+    }
+  };
+  if (entry < size) visit(entry);
+  std::reverse(order.begin(), order.end());
+  /* unreachable nodes: behind everything reachable, among themselves in rpo again */
+  const auto reachable = order.size();
+  for (NodeIndex node = 0; node < size; node++) {
+    if (not visited[node]) visit(node);
+  }
+  std::reverse(order.begin() + reachable, order.end());
+  return order;
+}
+}  // namespace utils
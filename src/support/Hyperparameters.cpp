@@ -0,0 +1,154 @@
+#include "support/Hyperparameters.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace utils {
+
+Parameter<uint32_t> ConstantHoistNum{"peephole.constant-hoist-num", 8,
+                                     "max constants hoisted out of the primary path"};
+Parameter<double> PrimaryPathThreshold{"peephole.primary-path-threshold", 0.4,
+                                       "block frequency below which a block is off the primary path"};
+Parameter<bool> VerifyDataFlow{"dataflow.verify", false,
+                               "check liveness and side effects against the round-robin fixpoints"};
+
+ParameterBase::ParameterBase(std::string_view name, std::string_view desc)
+  : mName(name), mDesc(desc) {
+  ParameterRegistry::get().add(this);
+}
+
+static std::string_view trim(std::string_view text) {
+  constexpr std::string_view spaces = " \t\r\n";
+  const auto begin = text.find_first_not_of(spaces);
+  if (begin == std::string_view::npos) return {};
+  const auto end = text.find_last_not_of(spaces);
+  return text.substr(begin, end - begin + 1);
+}
+
+bool parseValue(std::string_view text, bool& val) {
+  if (text == "1" or text == "true" or text == "on") {
+    val = true;
+  } else if (text == "0" or text == "false" or text == "off") {
+    val = false;
+  } else {
+    return false;
+  }
+  return true;
+}
+bool parseValue(std::string_view text, uint32_t& val) {
+  const std::string str{text};
+  char* end = nullptr;
+  const auto parsed = std::strtoul(str.c_str(), &end, 0);
+  if (str.empty() or *end != '\0' or str.front() == '-' or parsed > UINT32_MAX) return false;
+  val = static_cast<uint32_t>(parsed);
+  return true;
+}
+bool parseValue(std::string_view text, double& val) {
+  const std::string str{text};
+  char* end = nullptr;
+  const auto parsed = std::strtod(str.c_str(), &end);
+  if (str.empty() or *end != '\0') return false;
+  val = parsed;
+  return true;
+}
+bool parseValue(std::string_view text, std::string& val) {
+  val = text;
+  return true;
+}
+
+std::string formatValue(bool val) {
+  return val ? "true" : "false";
+}
+std::string formatValue(uint32_t val) {
+  return std::to_string(val);
+}
+std::string formatValue(double val) {
+  std::ostringstream ss;
+  ss << val;
+  return ss.str();
+}
+std::string formatValue(const std::string& val) {
+  return val;
+}
+
+std::string_view typeName(bool) {
+  return "bool";
+}
+std::string_view typeName(uint32_t) {
+  return "uint";
+}
+std::string_view typeName(double) {
+  return "float";
+}
+std::string_view typeName(const std::string&) {
+  return "string";
+}
+
+ParameterRegistry& ParameterRegistry::get() {
+  static ParameterRegistry registry;
+  return registry;
+}
+
+void ParameterRegistry::add(ParameterBase* param) {
+  [[maybe_unused]] const auto inserted = mParams.emplace(param->name(), param).second;
+  assert(inserted && "duplicate parameter name");
+}
+
+ParameterBase* ParameterRegistry::find(std::string_view name) const {
+  const auto iter = mParams.find(name);
+  return iter == mParams.end() ? nullptr : iter->second;
+}
+
+bool ParameterRegistry::set(std::string_view assignment, std::string& error) {
+  const auto pos = assignment.find('=');
+  if (pos == std::string_view::npos) {
+    error = "expected name=value: " + std::string{assignment};
+    return false;
+  }
+  const auto name = trim(assignment.substr(0, pos));
+  const auto value = trim(assignment.substr(pos + 1));
+  const auto param = find(name);
+  if (param == nullptr) {
+    error = "unknown parameter " + std::string{name};
+    return false;
+  }
+  if (not param->parse(value)) {
+    error = "invalid " + std::string{param->typeName()} + " value for " + std::string{name} +
+            ": " + std::string{value};
+    return false;
+  }
+  return true;
+}
+
+bool ParameterRegistry::load(const std::string& path, std::string& error) {
+  std::ifstream in(path);
+  if (not in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  std::string line;
+  uint32_t lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    std::string_view text{line};
+    text = trim(text.substr(0, text.find('#')));
+    if (text.empty()) continue;
+    if (not set(text, error)) {
+      error = path + ":" + std::to_string(lineNo) + ": " + error;
+      return false;
+    }
+  }
+  return true;
+}
+
+void ParameterRegistry::dump(std::ostream& os) const {
+  for (auto [name, param] : mParams) {
+    os << "# " << param->desc() << " (" << param->typeName() << ", default "
+       << param->defaultValue() << ")\n";
+    os << name << " = " << param->value() << "\n";
+  }
+}
+
+}  // namespace utils
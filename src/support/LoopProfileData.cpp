@@ -0,0 +1,70 @@
+#include "support/LoopProfileData.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace utils {
+
+LoopProfileData& LoopProfileData::get() {
+  static LoopProfileData data;
+  return data;
+}
+
+bool LoopProfileData::load(const std::string& path) {
+  std::ifstream in(path);
+  if (not in) {
+    std::cerr << "loop profile: cannot open " << path << std::endl;
+    return false;
+  }
+  decltype(mLoops) loops;
+  decltype(mFunctions) functions;
+  uint64_t totalCycles = 0;
+
+  std::string line;
+  uint32_t lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    if (line.empty() or line.front() == '#') continue;
+    std::istringstream fields(line);
+    std::string kind, func;
+    fields >> kind >> func;
+    bool ok = false;
+    if (kind == "func") {
+      FunctionProfileRecord record;
+      fields >> record.calls >> record.cycles >> record.instret;
+      ok = not fields.fail();
+      functions[func] = record;
+      if (func == "main") totalCycles = record.cycles;
+    } else if (kind == "loop") {
+      uint32_t index = 0;
+      LoopProfileRecord record;
+      fields >> index >> record.depth >> record.entries >> record.trips >> record.cycles >>
+        record.instret;
+      ok = not fields.fail();
+      loops[{func, index}] = record;
+    }
+    if (not ok) {
+      std::cerr << "loop profile: " << path << ":" << lineNo << ": malformed record" << std::endl;
+      return false;
+    }
+  }
+
+  mLoops = std::move(loops);
+  mFunctions = std::move(functions);
+  mHeaders.clear();
+  mTotalCycles = totalCycles;
+  return true;
+}
+
+const LoopProfileRecord* LoopProfileData::loop(const std::string& func, uint32_t index) const {
+  const auto iter = mLoops.find({func, index});
+  return iter == mLoops.end() ? nullptr : &iter->second;
+}
+
+const FunctionProfileRecord* LoopProfileData::function(const std::string& func) const {
+  const auto iter = mFunctions.find(func);
+  return iter == mFunctions.end() ? nullptr : &iter->second;
+}
+
+}  // namespace utils
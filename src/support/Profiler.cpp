@@ -3,19 +3,19 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <sys/resource.h>
+#include "support/arena.hpp"
 using namespace std::string_view_literals;
 
 namespace utils {
 Stage::Stage(const std::string_view& name) {
-  const auto& config = sysy::Config::getInstance();
-  if (config.logLevel >= sysy::LogLevel::DEBUG) {
+  if (Profiler::enabled()) {
     mAlive = true;
     Profiler::get().pushStage(name);
   }
 }
 Stage::~Stage() {
-  const auto& config = sysy::Config::getInstance();
-  if (config.logLevel >= sysy::LogLevel::DEBUG and mAlive) {
+  if (mAlive) {
     Profiler::get().popStage();
     mAlive = false;
   }
@@ -58,9 +58,65 @@ void StageStorage::printNested(uint32_t depth, double total) const {
   }
 }
 
+/* quoted JSON string: ", \\ and control characters escaped */
+static void writeJsonString(std::ostream& os, std::string_view str) {
+  constexpr auto hex = "0123456789abcdef"sv;
+  os << '"';
+  for (const auto ch : str) {
+    switch (ch) {
+      case '"':
+        os << "\\\""sv;
+        break;
+      case '\\':
+        os << "\\\\"sv;
+        break;
+      case '\n':
+        os << "\\n"sv;
+        break;
+      case '\t':
+        os << "\\t"sv;
+        break;
+      default:
+        if (static_cast<unsigned char>(ch) < 0x20) {
+          os << "\\u00"sv << hex[ch >> 4] << hex[ch & 15];
+        } else {
+          os << ch;
+        }
+    }
+  }
+  os << '"';
+}
+
+void StageStorage::dumpNested(std::ostream& os, const std::string& prefix, bool& first) const {
+  constexpr auto ratio =
+    static_cast<double>(Clock::period::num) / static_cast<double>(Clock::period::den);
+  for (auto& [name, stage] : mNestedStages) {
+    const auto path = prefix.empty() ? std::string(name) : prefix + "/" + std::string(name);
+    if (not first) os << ",";
+    first = false;
+    os << "\n    ";
+    writeJsonString(os, path);
+    os << ": {\"ms\": "
+       << (static_cast<double>(stage->duration().count()) * ratio * 1000.0)
+       << ", \"count\": " << stage->count() << "}";
+    stage->dumpNested(os, path, first);
+  }
+}
+
 Profiler::Profiler() {
   pushStage({});
 }
+
+bool Profiler::enabled() {
+  const auto& config = sysy::Config::getInstance();
+  return config.logLevel >= sysy::LogLevel::DEBUG or not config.statsFile.empty();
+}
+
+void Profiler::finish() {
+  if (mFinished) return;
+  popStage();
+  mFinished = true;
+}
 // performance
 void Profiler::pushStage(const std::string_view& name) {
   const auto current = Clock::now();
@@ -76,7 +132,7 @@ void Profiler::popStage() {
   mStageStack.pop_back();
 }
 void Profiler::printStatistics() {
-  popStage();
+  finish();
 
   const auto& config = sysy::Config::getInstance();
   if (config.logLevel >= sysy::LogLevel::DEBUG) {
@@ -98,6 +154,36 @@ void Profiler::printStatistics() {
   }
 }
 
+void Profiler::dumpStatistics(std::ostream& os) {
+  finish();
+  const auto& config = sysy::Config::getInstance();
+  constexpr auto ratio =
+    static_cast<double>(Clock::period::num) / static_cast<double>(Clock::period::den);
+  os.precision(3);
+  os << std::fixed;
+  os << "{\n";
+  os << "  \"file\": ";
+  writeJsonString(os, config.infile);
+  os << ",\n";
+  os << "  \"opt_level\": " << config.optLevel << ",\n";
+  os << "  \"total_ms\": "
+     << (static_cast<double>(mRootStage.duration().count()) * ratio * 1000.0) << ",\n";
+  os << "  \"peak_rss_kb\": " << peakRSSKiB() << ",\n";
+  os << "  \"arena_bytes\": {\"IR\": " << Arena::totalAllocated(Arena::Source::IR)
+     << ", \"MIR\": " << Arena::totalAllocated(Arena::Source::MIR) << "},\n";
+  os << "  \"stages\": {";
+  bool first = true;
+  mRootStage.dumpNested(os, "", first);
+  os << "\n  }\n";
+  os << "}" << std::endl;
+}
+
+size_t peakRSSKiB() {
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return static_cast<size_t>(usage.ru_maxrss);  // KiB on Linux
+}
+
 Profiler& Profiler::get() {
   static Profiler profiler;
   return profiler;
@@ -12,6 +12,7 @@ static constexpr size_t blockSize = 32ULL * 4096ULL;
 
 Arena::Arena() : mBlockPtr{0}, mBlockEndPtr{0} {}
 Arena::Arena(Source source) : Arena{} {
+  mSource = source;
   Arena::setArena(source, this);
 }
 
@@ -30,6 +31,11 @@ Arena::~Arena() {
   }
 }
 
+static size_t& allocatedBytes(Arena::Source source) {
+  static std::array<size_t, static_cast<size_t>(Arena::Source::Max)> bytes{};
+  return bytes[static_cast<size_t>(source)];
+}
+
 /* align the pointer to the given alignment */
 static uintptr_t alloc(uintptr_t ptr, uintptr_t alignment) {
   return (ptr + alignment - 1) / alignment * alignment;
@@ -44,6 +50,7 @@ void* Arena::allocate(size_t size, size_t align) {
     std::cerr << "curBlockRemain: " << mBlockEndPtr - mBlockPtr << std::endl;
   }
   void* ptr = nullptr;
+  if (mSource != Source::Max) allocatedBytes(mSource) += size;
 
   /* align the start pointer to the given alignment */
   auto allocated = alloc(mBlockPtr, align);
@@ -119,4 +126,8 @@ void Arena::setArena(Source source, Arena* arena) {
   getArena(source) = arena;
 }
 
+size_t Arena::totalAllocated(Source source) {
+  return allocatedBytes(source);
+}
+
 }  // namespace utils
\ No newline at end of file
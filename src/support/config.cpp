@@ -1,8 +1,10 @@
 #include "support/config.hpp"
 #include "support/Profiler.hpp"
+#include "support/Hyperparameters.hpp"
 
 #include "ir/ir.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <getopt.h>
 #include <string_view>
@@ -19,6 +21,15 @@ namespace sysy {
 -o {filename}:  output file, default gen.ll (-ir) or gen.s (-S)
 -S: gen assembly
 -O[0-3]: opt level
+-V[0-1]: ir verify level
+-P {filename}: dump compile-time statistics (JSON)
+-R {filename}: run the generated code on the sifive-u74 cycle model, stdin from filename
+-finstrument-loops: count cycles/instret per loop and function, report to sysyc.prof at exit
+-fprofile-use={filename}: read a sysyc.prof report for unrolling and loop parallelization
+-ffast-math: allow float reassociation, reciprocal division and FMA contraction
+-fprefetch-loops: prefetch the strided loads of loops the hardware prefetcher misses
+-X {name}={value}: set a tuning parameter, -X list: print all parameters
+-C {filename}: read tuning parameters (one name = value per line)
 
 ./compiler-f test.c -i -t mem2reg dce -o gen.ll
 ./compiler -f test.c -i -t mem2reg -o gen.ll -O0 -L0
@@ -33,6 +44,20 @@ Usage: ./compiler [options]
   -S                    gen assembly
   -O[0-3]               opt level
   -L[0-2]               log level: 0=SILENT, 1=INFO, 2=DEBUG
+  -V[0-1]               ir verify level: 0=Structural, 1=Thorough
+  -P {filename}         dump compile-time statistics (stage times, peak RSS, arena bytes) as JSON
+  -R {filename}         simulate the generated code on the sifive-u74 cycle model,
+                        program stdin from filename, stdout to stdout, cycle report to stderr
+  -finstrument-loops    instrument loops and functions with rdcycle/rdinstret counters,
+                        the binary writes the per-loop report sysyc.prof at exit
+  -fprofile-use={file}  feed a sysyc.prof report to the unroll cost model and the loop
+                        parallelization (cold loops stay serial)
+  -ffast-math           treat float + and * as associative: balanced reduction trees,
+                        x / d -> x * (1 / d) for loop invariant d, FMA contraction across blocks
+  -fprefetch-loops      prefetch loop loads with strides the hardware prefetcher does not track,
+                        as dummy loads on cores without prefetch instructions
+  -X {name}={value}     set a tuning parameter (pass thresholds, pipelines), -X list: print all
+  -C {filename}         read tuning parameters from a file, one name = value per line
 
 Examples:
 $ ./compiler -f test.c -i -t mem2reg -o gen.ll -O0 -L0
@@ -51,6 +76,8 @@ void Config::print_info() {
     std::cout << "Gen ASM  : " << (genASM ? "Yes" : "No") << std::endl;
     std::cout << "Opt Level: " << optLevel << std::endl;
     std::cout << "Log Level: " << logLevel << std::endl;
+    std::cout << "Verify   : " << (verifyLevel == VerifyLevel::Thorough ? "Thorough" : "Structural")
+              << std::endl;
     if (not passes.empty()) {
       std::cout << "Passes   : ";
       for (const auto& pass : passes) {
@@ -63,10 +90,20 @@ void Config::print_info() {
 
 void Config::parseTestArgs(int argc, char* argv[]) {
   int option;
-  while ((option = getopt(argc, argv, "f:it:o:SO:L:")) != -1) {
+  while ((option = getopt(argc, argv, "f:it:o:SO:L:V:P:R:X:C:")) != -1) {
     switch (option) {
       case 'f':
-        infile = optarg;
+        if (optarg == "instrument-loops"sv) {
+          instrumentLoops = true;
+        } else if (optarg == "fast-math"sv) {
+          fastMath = true;
+        } else if (optarg == "prefetch-loops"sv) {
+          prefetchLoops = true;
+        } else if (std::string_view{optarg}.starts_with("profile-use=")) {
+          profileUse = optarg + "profile-use="sv.size();
+        } else {
+          infile = optarg;
+        }
         break;
       case 'i':
         genIR = true;
@@ -91,6 +128,34 @@ void Config::parseTestArgs(int argc, char* argv[]) {
       case 'L':
         logLevel = static_cast<LogLevel>(std::stoi(optarg));
         break;
+      case 'V':
+        verifyLevel = static_cast<VerifyLevel>(std::stoi(optarg));
+        break;
+      case 'P':
+        statsFile = optarg;
+        break;
+      case 'R':
+        simInput = optarg;
+        break;
+      case 'X': {
+        auto& registry = utils::ParameterRegistry::get();
+        std::string error;
+        if (optarg == "list"sv) {
+          registry.dump(std::cout);
+          exit(EXIT_SUCCESS);
+        }
+        if (not registry.set(optarg, error)) {
+          std::cerr << "-X: " << error << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } break;
+      case 'C': {
+        std::string error;
+        if (not utils::ParameterRegistry::get().load(optarg, error)) {
+          std::cerr << "-C: " << error << std::endl;
+          exit(EXIT_FAILURE);
+        }
+      } break;
       default:
         print_help();
         exit(EXIT_FAILURE);
@@ -112,20 +177,33 @@ static const auto ifCombinePassesList = std::vector<std::string>{
 
 static const auto basePasses = std::vector<std::string>{"mem2reg", "reg2mem"};
 
-static const auto commonOptPasses =
-  std::vector<std::string>{"sccp", "adce", "simplifycfg", "instcombine", "adce"};
+/* O1 pipeline pieces, comma separated pass names (tunable, see Hyperparameters.hpp) */
+static utils::Parameter<std::string> commonOptPasses{
+  "pipeline.common", "sccp,adce,simplifycfg,instcombine,adce", "scalar cleanup passes"};
 
-static const auto loopOptPasses = std::vector<std::string>{"loopsimplify", "gcm", "gvn", "licm"};
+static utils::Parameter<std::string> loopOptPasses{
+  "pipeline.loop", "loopsimplify,gcm,gvn,licm,arraylayout,loopidiom,bitidiom,looprec",
+  "loop invariant, array layout, idiom and recurrence passes"};
 
-static const auto parallelPasses = std::vector<std::string>{
-  "loopsimplify", "gcm", "gvn", "licm",
-  // "markpara",
-  // "LoopInterChange", "inline", 
-  "loopsimplify", 
-  "blocksort",
-  "cfgprint",
-  "parallel",  // "ParallelBodyExtract",
-  "inline", "simplifycfg"};
+static utils::Parameter<std::string> parallelPasses{
+  "pipeline.parallel",
+  // "markpara", "LoopInterChange", "inline", "ParallelBodyExtract"
+  // taskparallel (after parallel) is opt-in until test/regress/taskparallel passes on the board
+  "loopsimplify,gcm,gvn,licm,loopsimplify,blocksort,cfgprint,parallel,inline,simplifycfg",
+  "loop parallelization passes, run last"};
+
+static std::vector<std::string> splitPasses(const std::string& list) {
+  std::vector<std::string> passes;
+  std::string_view rest{list};
+  while (not rest.empty()) {
+    const auto pos = rest.find(',');
+    const auto name = rest.substr(0, pos);
+    if (not name.empty()) passes.emplace_back(name);
+    if (pos == std::string_view::npos) break;
+    rest.remove_prefix(pos + 1);
+  }
+  return passes;
+}
 
 static const auto interProceduralPasses = std::vector<std::string>{
   "inline", "tco", "cache", "inline",  // cant parallel
@@ -162,10 +240,12 @@ auto collectPasses(OptLevel level) {
   }
 
   // O1
+  const auto commonPasses = splitPasses(commonOptPasses);
+  const auto loopPasses = splitPasses(loopOptPasses);
   std::vector<std::string> clcPasses;
-  clcPasses.insert(clcPasses.end(), commonOptPasses.begin(), commonOptPasses.end());
-  clcPasses.insert(clcPasses.end(), loopOptPasses.begin(), loopOptPasses.end());
-  clcPasses.insert(clcPasses.end(), commonOptPasses.begin(), commonOptPasses.end());
+  clcPasses.insert(clcPasses.end(), commonPasses.begin(), commonPasses.end());
+  clcPasses.insert(clcPasses.end(), loopPasses.begin(), loopPasses.end());
+  clcPasses.insert(clcPasses.end(), commonPasses.begin(), commonPasses.end());
 
   std::vector<std::string> passes;
 
@@ -187,7 +267,8 @@ auto collectPasses(OptLevel level) {
   // passes.insert(passes.end(), clcPasses.begin(), clcPasses.end());
 
   // dont add clc after
-  passes.insert(passes.end(), parallelPasses.begin(), parallelPasses.end());
+  const auto parallel = splitPasses(parallelPasses);
+  passes.insert(passes.end(), parallel.begin(), parallel.end());
 
   // passes.insert(passes.end(), gepSplitPasses.begin(), gepSplitPasses.end());
 
@@ -236,6 +317,22 @@ void Config::parseCmdArgs(int argc, char* argv[]) {
     exit(EXIT_FAILURE);
   }
   if (passes.empty()) passes = collectPasses(optLevel);
+  if (instrumentLoops or not profileUse.empty()) {
+    /* right after mem2reg: the loops are the source loops, the same at every opt level */
+    const auto pos = std::find(passes.begin(), passes.end(), "mem2reg");
+    passes.insert(pos == passes.end() ? passes.begin() : std::next(pos),
+                  {"loopsimplify", "loopprofile"});
+  }
+  if (fastMath) {
+    /* last: gvn/licm would merge and hoist the multiplies duplicated for contraction */
+    const auto pos = std::find(passes.begin(), passes.end(), "reg2mem");
+    passes.insert(pos, {"reassociate", "fastmath"});
+  }
+  if (prefetchLoops) {
+    /* last: the loops are final (unrolled, extracted), nothing hoists or merges the hints */
+    const auto pos = std::find(passes.begin(), passes.end(), "reg2mem");
+    passes.insert(pos, {"loopsimplify", "prefetch"});
+  }
 }
 
 }  // namespace sysy
\ No newline at end of file
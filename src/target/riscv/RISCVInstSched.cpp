@@ -6,7 +6,9 @@
 #include "autogen/riscv/ScheduleModelDecl.hpp"
 #include "target/riscv/RISCVScheduleModel.hpp"
 #include "autogen/riscv/ScheduleModelImpl.hpp"
+#include <algorithm>
 #include <deque>
+#include <optional>
 
 namespace mir::RISCV {
 MicroArchInfo& RISCVScheduleModel_sifive_u74::getMicroArchInfo() {
@@ -17,6 +19,8 @@ MicroArchInfo& RISCVScheduleModel_sifive_u74::getMicroArchInfo() {
     .issueWidth = 2,
     .outOfOrder = false,
     .hardwarePrefetch = true,
+    .hasPrefetchInst = false, /* no Zicbop */
+    .memoryIssueWidth = 1, /* loads and stores only issue to pipe A */
     .maxDataStreams = 8,
     .maxStrideByBytes = 256,
   };
@@ -294,83 +298,292 @@ static bool largeImmMaterialize(MIRBlock& block) {
   return modified;
 }
 
-// TODO
-static bool earlyFoldStore(MIRBlock& block, CodeGenContext& ctx) {
-  bool modified = false;
-  auto& instructions = block.insts();
-  auto prevStore = instructions.end();
-  std::unordered_map<MIROperand, MIROperand, MIROperandHasher> addressMap;
-  for (auto iter = instructions.begin(); iter != instructions.end(); iter++) {
-    const auto isStoreWord = [&](MIRInst* inst, uint32_t alignmentReq) {
-      assert(inst->opcode() == SW);
-      const auto alignment = inst->operand(3).imm();
-      return alignment >= alignmentReq;
-    };
+/* cycles to issue ops, memOps of them through the memory pipes, dependencies ignored */
+static uint32_t issueCycles(const MicroArchInfo& info, uint32_t memOps, uint32_t ops) {
+  return std::max((memOps + info.memoryIssueWidth - 1) / info.memoryIssueWidth,
+                  (ops + info.issueWidth - 1) / info.issueWidth);
+}
 
-    auto inst = *iter;
-    /* Other Instructions */
-    if (inst->opcode() != SW) {
+/* the use at operand idx only reads bits [31:0] of the register */
+static bool readsLowWord(const MIRInst* inst, uint32_t idx) {
+  switch (inst->opcode()) {
+    case ADDIW:
+    case ADDW:
+    case SUBW:
+    case MULW:
+    case DIVW:
+    case DIVUW:
+    case REMW:
+    case REMUW:
+    case SLLIW:
+    case SRAIW:
+    case SRLIW:
+    case SLLW:
+    case SRAW:
+    case SRLW:
+    case FCVT_S_W: return true;
+    case SW:
+    case SH:
+    case SB: return idx == 0; /* the stored value, not the base */
+    case ADD_UW: return idx == 1;  /* zext.w rs1 */
+    case SLLI: return idx == 1 and inst->operand(2).isImm() and inst->operand(2).imm() >= 32;
+    default: return false;
+  }
+}
 
-      auto& instInfo = ctx.instInfo.getInstInfo(inst);
-      if (requireOneFlag(instInfo.inst_flag(), InstFlagSideEffect)) {
-        prevStore = instructions.end();
+namespace {
+/* word load/store: root (stack object or global symbol) + offset */
+struct WordAccess final {
+  MIRInstList::iterator iter;
+  MIROperand root;
+  intmax_t offset;
+};
+
+/*
+ * Pairs adjacent lw/sw of the same root into ld/sd, pre-RA in SSA form:
+ *   lw a, 0(p); lw b, 4(p)      -> ld t, 0(p); a = t (sext.w t if a is not only
+ *                                  read as a word); b = srai t, 32
+ *   sw zero, 0(p); sw zero, 4(p) -> sd zero, 0(p)
+ *   sw a, 0(p); sw zero, 4(p)   -> zext.w t, a; sd t, 0(p)
+ *   sw zero, 0(p); sw b, 4(p)   -> slli t, b, 32; sd t, 0(p)
+ * The lower word must be 8 byte aligned (the root is, see lowering.cpp) and the
+ * pair is merged only if it takes fewer issue cycles on the memory pipe.
+ */
+class WordAccessPairing final {
+  MIRFunction& mFunc;
+  CodeGenContext& mCtx;
+  /* vreg -> its only def, nullptr if defined more than once */
+  std::unordered_map<MIROperand, MIRInst*, MIROperandHasher> mDefs;
+  std::unordered_map<MIROperand, std::vector<std::pair<MIRInst*, uint32_t>>, MIROperandHasher>
+    mUses;
+  std::unordered_map<MIRRelocable*, size_t> mGlobalAlign;
+
+  MIRInst* defOf(const MIROperand& op) const {
+    const auto iter = mDefs.find(op);
+    return iter == mDefs.end() ? nullptr : iter->second;
+  }
+
+  uint32_t alignOf(const MIROperand& root) const {
+    if (isOperandStackObject(root)) return mFunc.stackObjs().at(root).alignment;
+    const auto iter = mGlobalAlign.find(root.reloc());
+    return iter == mGlobalAlign.end() ? 1 : iter->second;
+  }
+
+  std::optional<WordAccess> addressOf(MIRInstList::iterator iter) const {
+    const auto inst = *iter;
+    if (not inst->operand(1).isImm()) return std::nullopt;
+    auto base = inst->operand(2);
+    auto offset = inst->operand(1).imm();
+    /* p = addi (addi (lla sym), 8), 4 */
+    for (uint32_t depth = 0; depth < 8; depth++) {
+      if (isOperandStackObject(base)) return WordAccess{iter, base, offset};
+      const auto def = isOperandVReg(base) ? defOf(base) : nullptr;
+      if (def == nullptr) return std::nullopt;
+      switch (def->opcode()) {
+        case InstLoadStackObjectAddr:
+        case LLA: return WordAccess{iter, def->operand(1), offset};
+        case ADDI:
+          if (not def->operand(2).isImm()) return std::nullopt;
+          offset += def->operand(2).imm();
+          base = def->operand(1);
+          break;
+        case MV:
+        case InstCopy: base = def->operand(1); break;
+        default: return std::nullopt;
       }
-      continue;
     }
+    return std::nullopt;
+  }
 
-    /* Store Word Instruction */
-    if (prevStore == instructions.end()) {
-      prevStore = iter;
-      continue;
+  bool isZero(const MIROperand& op) const {
+    if (op.isReg() and op.reg() == RISCV::X0) return true;
+    const auto def = isOperandVReg(op) ? defOf(op) : nullptr;
+    if (def == nullptr) return false;
+    if (def->opcode() == MV or def->opcode() == InstCopy) {
+      return def->operand(1).isReg() and def->operand(1).reg() == RISCV::X0;
     }
-    auto prevIter = prevStore;
-    auto prevInst = *prevStore;
-    prevStore = iter;
+    return def->opcode() == LoadImm12 and def->operand(1).imm() == 0;
+  }
 
-    if (isStoreWord(prevInst, 8) && isStoreWord(inst, 4)) {
-      auto prevBase = prevInst->operand(2);
-      intmax_t prevOffset;
+  bool onlyReadAsWord(const MIROperand& op) const {
+    const auto iter = mUses.find(op);
+    if (iter == mUses.end()) return true;
+    return std::all_of(iter->second.begin(), iter->second.end(),
+                       [](const auto& use) { return readsLowWord(use.first, use.second); });
+  }
 
+  /* 12 bit offset of the pair when addressed through the base of access */
+  static std::optional<MIROperand> pairOffset(const WordAccess& access, intmax_t low) {
+    const auto imm = (*access.iter)->operand(1).imm() - (access.offset - low);
+    if (not isSignedImm<12>(imm)) return std::nullopt;
+    return MIROperand::asImm(imm, OperandType::Int64);
+  }
+
+  MIROperand newVReg() { return MIROperand::asVReg(mCtx.nextId(), OperandType::Int64); }
+
+  void record(MIRInst* inst) {
+    auto& instInfo = mCtx.instInfo.getInstInfo(inst);
+    for (uint32_t idx = 0; idx < instInfo.operand_num(); idx++) {
+      const auto op = inst->operand(idx);
+      if (not isOperandVReg(op)) continue;
+      const auto flag = instInfo.operand_flag(idx);
+      if (flag & OperandFlagDef) {
+        const auto [iter, inserted] = mDefs.emplace(op, inst);
+        if (not inserted) iter->second = nullptr;
+      }
+      if (flag & OperandFlagUse) mUses[op].emplace_back(inst, idx);
     }
   }
 
-  return modified;
-}
+  /* before inst is rewritten or erased; a vreg defined more than once stays unknown */
+  void forget(MIRInst* inst) {
+    auto& instInfo = mCtx.instInfo.getInstInfo(inst);
+    for (uint32_t idx = 0; idx < instInfo.operand_num(); idx++) {
+      const auto op = inst->operand(idx);
+      if (not isOperandVReg(op)) continue;
+      const auto flag = instInfo.operand_flag(idx);
+      if (flag & OperandFlagDef) {
+        if (const auto iter = mDefs.find(op); iter != mDefs.end() and iter->second == inst)
+          mDefs.erase(iter);
+      }
+      if (flag & OperandFlagUse) {
+        auto& uses = mUses[op];
+        uses.erase(std::remove_if(uses.begin(), uses.end(),
+                                  [&](const auto& use) { return use.first == inst; }),
+                   uses.end());
+      }
+    }
+  }
 
-// TODO
-static bool earlyFoldLoad(MIRBlock& block, CodeGenContext& ctx) {
-  bool modified = false;
-  auto& instructions = block.insts();
-  auto prevLoad = instructions.end();
-  std::unordered_map<MIROperand, MIROperand, MIROperandHasher> addressMap;
-  for (auto iter = instructions.begin(); iter != instructions.end(); iter++) {
-    const auto isLoadWord = [&](MIRInst* inst, uint32_t alignmentReq) {
-      assert(inst->opcode() == LW);
-      const auto alignment = inst->operand(3).imm();
-      return alignment >= alignmentReq;
+  bool pairLoads(MIRBlock& block, const WordAccess& first, const WordAccess& second) {
+    const auto low = std::min(first.offset, second.offset);
+    const auto firstInst = *first.iter, secondInst = *second.iter;
+    const auto lowDst = (first.offset == low ? firstInst : secondInst)->operand(0);
+    const bool lowAsWord = onlyReadAsWord(lowDst);
+    const auto& info = mCtx.scheduleModel->getMicroArchInfo();
+    /* ld, srai (, sext.w) */
+    if (issueCycles(info, 1, lowAsWord ? 2 : 3) >= issueCycles(info, 2, 2)) return false;
+    const auto offset = pairOffset(first, low);
+    if (not offset) return false;
+
+    const auto word = newVReg();
+    const auto extract = [&](MIRInst* inst) {
+      const auto dst = inst->operand(0);
+      if (inst->operand(0) != lowDst) return MIRInst{SRAI, {dst, word, getImm(32)}};
+      if (lowAsWord) return MIRInst{InstCopy, {dst, word}};
+      return MIRInst{ADDIW, {dst, word, getImm(0)}};
     };
+    forget(firstInst);
+    forget(secondInst);
+    const auto firstExtract = utils::make<MIRInst>(extract(firstInst));
+    block.insts().insert(std::next(first.iter), firstExtract);
+    *secondInst = extract(secondInst);
+    firstInst->set_opcode(LD);
+    firstInst->set_operand(0, word);
+    firstInst->set_operand(1, *offset);
+    for (auto inst : {firstInst, firstExtract, secondInst})
+      record(inst);
+    return true;
+  }
 
-    auto inst = *iter;
-    /* Other Instructions */
-    if (inst->opcode() != LW) {
-      
+  bool pairStores(MIRBlock& block, const WordAccess& first, const WordAccess& second) {
+    const auto low = std::min(first.offset, second.offset);
+    const auto firstInst = *first.iter, secondInst = *second.iter;
+    auto lowVal = firstInst->operand(0), highVal = secondInst->operand(0);
+    if (first.offset != low) std::swap(lowVal, highVal);
+    const bool lowZero = isZero(lowVal), highZero = isZero(highVal);
+    const auto& info = mCtx.scheduleModel->getMicroArchInfo();
+    /* sd (, slli) (, add.uw) */
+    const uint32_t ops = 1 + (highZero ? 0 : 1) + (lowZero ? 0 : 1);
+    if (issueCycles(info, 1, ops) >= issueCycles(info, 2, 2)) return false;
+    const auto offset = pairOffset(second, low);
+    if (not offset) return false;
+
+    auto& insts = block.insts();
+    forget(firstInst);
+    forget(secondInst);
+    auto val = MIROperand::asISAReg(RISCV::X0, OperandType::Int64);
+    if (not highZero) {
+      const auto shifted = newVReg();
+      const auto inst = utils::make<MIRInst>(SLLI, {shifted, highVal, getImm(32)});
+      insts.insert(second.iter, inst);
+      record(inst);
+      val = shifted;
     }
-
-    /* Load Word Instruction */
-    if (prevLoad == instructions.end()) {
-      prevLoad = iter;
-      continue;
+    if (not lowZero) {
+      /* zext.w lowVal + val */
+      const auto packed = newVReg();
+      const auto inst = utils::make<MIRInst>(ADD_UW, {packed, lowVal, val});
+      insts.insert(second.iter, inst);
+      record(inst);
+      val = packed;
     }
+    secondInst->set_opcode(SD);
+    secondInst->set_operand(0, val);
+    secondInst->set_operand(1, *offset);
+    record(secondInst);
+    insts.erase(first.iter);
+    return true;
+  }
 
-    auto prevIter = prevLoad;
-    auto prevInst = *prevLoad;
-    prevLoad = iter;
+  static MIROperand getImm(intmax_t val) { return MIROperand::asImm(val, OperandType::Int32); }
 
-    if (isLoadWord(prevInst, 8) && isLoadWord(inst, 4)) {
-      auto prevBase = prevInst->operand(2);
-      intmax_t prevOffset;
+public:
+  WordAccessPairing(MIRFunction& func, CodeGenContext& ctx) : mFunc(func), mCtx(ctx) {
+    for (auto& gobj : func.module()->global_objs())
+      mGlobalAlign.emplace(gobj->reloc.get(), gobj->align);
+    for (auto& block : func.blocks()) {
+      for (auto inst : block->insts())
+        record(inst);
+    }
+  }
+
+  bool run(MIRBlock& block) {
+    bool modified = false;
+    auto& insts = block.insts();
+    std::optional<WordAccess> prev;
+    for (auto iter = insts.begin(); iter != insts.end();) {
+      const auto next = std::next(iter);
+      const auto inst = *iter;
+      /* lw x0: a prefetch hint (LoopPrefetch), nothing to pair */
+      const bool isLoad = inst->opcode() == LW and isOperandVReg(inst->operand(0));
+      if (not isLoad and inst->opcode() != SW) {
+        auto& instInfo = mCtx.instInfo.getInstInfo(inst);
+        if (requireOneFlag(instInfo.inst_flag(), InstFlagSideEffect)) prev.reset();
+        iter = next;
+        continue;
+      }
+      const auto access = addressOf(iter);
+      if (access and prev and (*prev->iter)->opcode() == inst->opcode() and
+          prev->root == access->root and std::abs(prev->offset - access->offset) == 4 and
+          std::min(prev->offset, access->offset) % 8 == 0 and alignOf(access->root) >= 8) {
+        const bool paired = inst->opcode() == LW ? pairLoads(block, *prev, *access)
+                                                 : pairStores(block, *prev, *access);
+        if (paired) {
+          modified = true;
+          prev.reset();
+          iter = next;
+          continue;
+        }
+      }
+      prev = access;
+      iter = next;
     }
+    return modified;
   }
+};
+}  // namespace
+
+/*
+ * @brief: pairWordAccesses function
+ * @note: pre RegisterAllocation, in SSA form
+ *    相邻的两条32位访存合并为一条64位访存 (see WordAccessPairing)
+ */
+static bool pairWordAccesses(MIRFunction& func, CodeGenContext& ctx) {
+  WordAccessPairing pairing{func, ctx};
+  bool modified = false;
+  for (auto& block : func.blocks())
+    modified |= pairing.run(*block);
   return modified;
 }
 
@@ -642,8 +855,9 @@ bool RISCVScheduleModel_sifive_u74::peepholeOpt(MIRFunction& func, CodeGenContex
       if (!context.flags.inSSAForm) {
         modified |= largeImmMaterialize(*block);
       }
-      // modified |= earlyFoldStore(*block, context); // TODO
-      // modified |= earlyFoldLoad(*block, context);  // TODO
+    }
+    if (context.flags.inSSAForm) {
+      modified |= pairWordAccesses(func, context);
     }
   }
   /* postSA optimize */
@@ -293,11 +293,20 @@ static bool legalizeInst(MIRInst* inst, ISelContext& ctx) {
       inst->set_operand(2, val);
       break;
     }
-    case InstAbs: {
-      /* abs dst, val */
+    case InstAbs:
+    case InstCPop:
+    case InstClz:
+    case InstCtz: {
+      /* abs/cpop/clz/ctz dst, val */
       imm2reg(inst->operand(1));
       break;
     }
+    case InstSMin:
+    case InstSMax: {
+      imm2reg(inst->operand(1));
+      imm2reg(inst->operand(2));
+      break;
+    }
     case InstMul: {
       auto selectCode = [code = inst->opcode()] {
         switch (code) {
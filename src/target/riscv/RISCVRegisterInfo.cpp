@@ -75,9 +75,18 @@ static const std::unordered_set<RegNum> callerSavedRISCVFPR = {
   RISCV::F29, RISCV::F30, RISCV::F31, RISCV::F16, RISCV::F17
 };
 static const auto externalOnlyGPR = std::vector<std::string>{
-  "_memset", "putint", "getch", "getint", "getarray", "putch", "putarray"};
+  "_memset", "putint", "getch", "getint", "getarray", "putch", "putarray",
+  /* loop idiom runtime */
+  "sysycMemfill", "sysycMemcpy",
+  /* -finstrument-loops hooks */
+  "sysycProfInit", "sysycProfFuncEnter", "sysycProfFuncExit", "sysycProfLoopEnter",
+  "sysycProfLoopExit"};
 static const auto externalFloat = std::vector<std::string>{
-  "getfloat", "putfloat", "getfarray", "putfarray", "putf"};
+  "getfloat", "putfloat", "getfarray", "putfarray", "putf", "sysycPutf"};
+/* buffered I/O runtime (RuntimeIO.hpp, compiled by gcc): all caller-saved registers */
+static const auto bufferedIORuntime = std::vector<std::string>{
+  "sysycGetint", "sysycGetch", "sysycGetfloat", "sysycGetarray", "sysycGetfarray",
+  "sysycPutint", "sysycPutch", "sysycPutfloat", "sysycPutarray", "sysycPutfarray"};
 /* 保存Runtime相关的Caller-Saved Registers */
 void addExternalIPRAInfo(IPRAUsageCache& infoIPRA) {
   for (auto name : externalOnlyGPR) {
@@ -91,6 +100,10 @@ void addExternalIPRAInfo(IPRAUsageCache& infoIPRA) {
   for (auto name : externalFloat) {
     infoIPRA.add(name, callerSavedRISCVRegs);
   }
+
+  for (auto name : bufferedIORuntime) {
+    infoIPRA.add(name, callerSavedRISCVRegs);
+  }
 }
 
 }  // namespace mir
\ No newline at end of file
@@ -0,0 +1,865 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include "target/riscv/RISCVSimulator.hpp"
+#include "target/riscv/RISCVTarget.hpp"
+#include "autogen/riscv/InstInfoDecl.hpp"
+
+RISCV_NAMESPACE_BEGIN
+
+static constexpr uint64_t codeBase = 0x1000;
+static constexpr uint64_t dataBase = 0x10000;
+static constexpr uint64_t stackTop = 0x80000000;
+/* x0 as a def: written latencies must never be seen by readers of x0 */
+static constexpr uint32_t zeroSinkReg = FPREnd + 1;
+
+SimCache::SimCache(uint32_t sizeBytes, uint32_t ways, uint32_t lineBytes)
+  : mLineBits(__builtin_ctz(lineBytes)), mSets(sizeBytes / lineBytes / ways), mWays(ways) {
+  mTags.assign(static_cast<size_t>(mSets) * mWays, 0);
+  mStamp.assign(static_cast<size_t>(mSets) * mWays, 0);
+}
+
+bool SimCache::access(uint64_t addr) {
+  const auto line = addr >> mLineBits;
+  const auto tag = line + 1;  // 0 is reserved for invalid ways
+  const auto base = static_cast<size_t>(line % mSets) * mWays;
+  ++mClock;
+  size_t victim = base;
+  for (size_t way = base; way < base + mWays; way++) {
+    if (mTags[way] == tag) {
+      mStamp[way] = mClock;
+      return true;
+    }
+    if (mStamp[way] < mStamp[victim]) victim = way;
+  }
+  mTags[victim] = tag;
+  mStamp[victim] = mClock;
+  return false;
+}
+
+/* opcodes without a sifive-u74 schedule class are timed as their closest relative */
+static uint32_t timingOpcode(uint32_t opcode) {
+  switch (opcode) {
+    case DIVU:
+      return DIV;
+    case DIVUW:
+    case REMUW:
+      return DIVW;
+    case ANDN:
+    case ORN:
+    case XNOR:
+    case MIN:
+    case MAX:
+    case MINU:
+    case MAXU:
+    case CLZW:
+    case CTZW:
+    case CPOPW:
+      return ADD;
+    case FSQRT_S:
+      return FDIV_S;
+    case FCLASS_S:
+      return FMV_X_W;
+    default:
+      return opcode;
+  }
+}
+
+static int64_t sext32(int64_t val) {
+  return static_cast<int32_t>(static_cast<uint32_t>(val));
+}
+static int64_t zext32(int64_t val) {
+  return static_cast<uint32_t>(val);
+}
+static int64_t wrapAdd(int64_t lhs, int64_t rhs) {
+  return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs));
+}
+static int64_t wrapSub(int64_t lhs, int64_t rhs) {
+  return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs));
+}
+static int64_t wrapMul(int64_t lhs, int64_t rhs) {
+  return static_cast<int64_t>(static_cast<uint64_t>(lhs) * static_cast<uint64_t>(rhs));
+}
+
+/* RISC-V M semantics: no traps on division by zero or overflow */
+template <typename T>
+static T riscvDiv(T lhs, T rhs) {
+  if (rhs == 0) return static_cast<T>(-1);
+  if constexpr (std::is_signed_v<T>) {
+    if (lhs == std::numeric_limits<T>::min() && rhs == -1) return lhs;
+  }
+  return lhs / rhs;
+}
+template <typename T>
+static T riscvRem(T lhs, T rhs) {
+  if (rhs == 0) return lhs;
+  if constexpr (std::is_signed_v<T>) {
+    if (lhs == std::numeric_limits<T>::min() && rhs == -1) return 0;
+  }
+  return lhs % rhs;
+}
+
+static int64_t fcvtWS(float val, bool truncate) {
+  if (std::isnan(val)) return std::numeric_limits<int32_t>::max();
+  const auto rounded = truncate ? std::trunc(val) : std::nearbyint(val);
+  if (rounded >= 2147483648.0f) return std::numeric_limits<int32_t>::max();
+  if (rounded < -2147483648.0f) return std::numeric_limits<int32_t>::min();
+  return static_cast<int32_t>(rounded);
+}
+static int64_t fcvtWUS(float val) {
+  if (std::isnan(val)) return sext32(std::numeric_limits<uint32_t>::max());
+  const auto rounded = std::nearbyint(val);
+  if (rounded >= 4294967296.0f) return sext32(std::numeric_limits<uint32_t>::max());
+  if (rounded <= 0.0f) return 0;
+  return sext32(static_cast<uint32_t>(rounded));
+}
+static int64_t fclass(float val) {
+  const bool neg = std::signbit(val);
+  switch (std::fpclassify(val)) {
+    case FP_INFINITE:
+      return neg ? 1 << 0 : 1 << 7;
+    case FP_NORMAL:
+      return neg ? 1 << 1 : 1 << 6;
+    case FP_SUBNORMAL:
+      return neg ? 1 << 2 : 1 << 5;
+    case FP_ZERO:
+      return neg ? 1 << 3 : 1 << 4;
+    default:
+      return 1 << 9;  // quiet NaN
+  }
+}
+
+Simulator::Simulator(MIRModule& module, Target& target, SimConfig config)
+  : mModule(module),
+    mTarget(target),
+    mConfig(config),
+    mL1D(config.l1dSize, config.l1dWays, config.lineBytes),
+    mL2(config.l2Size, config.l2Ways, config.lineBytes) {
+  layoutProgram();
+}
+
+void Simulator::layoutProgram() {
+  auto& instInfo = mTarget.getTargetInstInfo();
+  /* functions: fake code addresses, only used as function pointers (parallelFor) */
+  uint64_t codeAddr = codeBase;
+  for (auto& func : mModule.functions()) {
+    mFunctionByName.emplace(func->name(), func.get());
+    mSymbolAddr.emplace(func.get(), codeAddr);
+    mFunctionAt.emplace(codeAddr, func.get());
+    codeAddr += 16;
+
+    auto& blocks = mLayout[func.get()];
+    for (auto& block : func->blocks()) {
+      mBlockIndex.emplace(block.get(), blocks.size());
+      blocks.push_back(block.get());
+      for (auto inst : block->insts()) {
+        /* ISA registers are the rename indices of the schedule state */
+        auto& info = instInfo.getInstInfo(inst->opcode());
+        auto& rename = mRenameMap[inst];
+        for (uint32_t idx = 0; idx < info.operand_num(); idx++) {
+          const auto op = inst->operand(idx);
+          if (not op.isReg()) continue;
+          const bool isDef = info.operand_flag(idx) & OperandFlagDef;
+          rename[idx] = (op.reg() == X0 && isDef) ? zeroSinkReg : op.reg();
+        }
+      }
+    }
+  }
+
+  /* globals: same section order as dumpAssembly (.data, .rodata, .bss) */
+  std::vector<MIRGlobalObject*> ordered;
+  for (auto pass : {0, 1, 2}) {
+    for (auto& gobj : mModule.global_objs()) {
+      const auto reloc = gobj->reloc.get();
+      int section = 2;
+      if (auto data = reloc->dynCast<MIRDataStorage>()) section = data->is_readonly() ? 1 : 0;
+      if (section == pass) ordered.push_back(gobj.get());
+    }
+  }
+  mDataBase = dataBase;
+  for (auto gobj : ordered) {
+    const auto align = std::max<size_t>(gobj->align, 1);
+    const auto offset = (mData.size() + align - 1) / align * align;
+    mSymbolAddr.emplace(gobj->reloc.get(), mDataBase + offset);
+    if (auto data = gobj->reloc->dynCast<MIRDataStorage>()) {
+      const auto& words = data->data();
+      mData.resize(offset + words.size() * sizeof(uint32_t), 0);
+      memcpy(mData.data() + offset, words.data(), words.size() * sizeof(uint32_t));
+    } else if (auto zero = gobj->reloc->dynCast<MIRZeroStorage>()) {
+      mData.resize(offset + zero->size(), 0);
+    }
+  }
+  mDataSize = mData.size();
+
+  /* calloc: untouched stack pages are never materialized */
+  mStack = std::unique_ptr<uint8_t, void (*)(void*)>(
+    static_cast<uint8_t*>(std::calloc(mConfig.stackSize, 1)), std::free);
+}
+
+uint8_t* Simulator::translate(uint64_t addr, uint32_t size) {
+  if (addr >= mDataBase && addr + size <= mDataBase + mDataSize) {
+    return mData.data() + (addr - mDataBase);
+  }
+  const auto stackBase = stackTop - mConfig.stackSize;
+  if (addr >= stackBase && addr + size <= stackTop) {
+    return mStack.get() + (addr - stackBase);
+  }
+  return nullptr;
+}
+
+template <typename T>
+bool Simulator::load(uint64_t addr, T& val) {
+  const auto ptr = translate(addr, sizeof(T));
+  if (ptr == nullptr) return false;
+  memcpy(&val, ptr, sizeof(T));
+  return true;
+}
+
+template <typename T>
+bool Simulator::store(uint64_t addr, T val) {
+  const auto ptr = translate(addr, sizeof(T));
+  if (ptr == nullptr) return false;
+  memcpy(ptr, &val, sizeof(T));
+  return true;
+}
+
+bool Simulator::fault(const std::string& msg, const Cursor& cur) {
+  mError = msg + " in " + cur.func->name() + ":" + mLayout.at(cur.func).at(cur.block)->name();
+  return false;
+}
+
+int64_t Simulator::readGPR(const MIROperand& op) const {
+  return mGPR[op.reg() - GPRBegin];
+}
+void Simulator::writeGPR(const MIROperand& op, int64_t val) {
+  if (op.reg() != X0) mGPR[op.reg() - GPRBegin] = val;
+}
+
+int64_t Simulator::immOrAddr(const MIROperand& op) const {
+  if (op.isImm()) return op.imm();
+  assert(op.isReloc());
+  /* %pcrel_lo: the paired auipc already produced the full address */
+  if (op.type() == OperandType::LowBits) return 0;
+  return static_cast<int64_t>(mSymbolAddr.at(op.reloc()));
+}
+
+void Simulator::advance(uint64_t cycles, BlockStats& stats) {
+  for (uint64_t i = 0; i < cycles; i++) {
+    mState->nextCycle();
+  }
+  mCycles += cycles;
+  stats.cycles += cycles;
+  /* ScheduleState counts in 32 bits: restart it well before it wraps */
+  mEpochCycles += cycles;
+  if (mEpochCycles >= (1ULL << 31)) {
+    mState.emplace(mRenameMap);
+    mEpochCycles = 0;
+  }
+}
+
+void Simulator::issue(const MIRInst& inst, BlockStats& stats) {
+  auto& sclass = mTarget.getScheduleModel().getInstScheClass(timingOpcode(inst.opcode()));
+  auto& info = mTarget.getTargetInstInfo().getInstInfo(inst.opcode());
+  while (not sclass.schedule(*mState, inst, info)) {
+    advance(1, stats);
+  }
+}
+
+uint32_t Simulator::dataAccess(uint64_t addr, BlockStats& stats) {
+  mMemAccesses++;
+  if (mL1D.access(addr)) return 0;
+  mL1DMisses++;
+  stats.cacheMisses++;
+  if (mL2.access(addr)) return mConfig.l2Latency;
+  mL2Misses++;
+  return mConfig.memLatency;
+}
+
+bool Simulator::predict(const MIRInst& inst, bool taken, bool backward) {
+  /* 2-bit saturating counter, 0/1: not taken, 2/3: taken */
+  auto [iter, inserted] = mBHT.try_emplace(&inst, backward ? 2 : 1);
+  auto& counter = iter->second;
+  const bool hit = (counter >= 2) == taken;
+  if (taken && counter < 3) counter++;
+  if (not taken && counter > 0) counter--;
+  return hit;
+}
+
+void Simulator::enterFunction(MIRFunction* func) {
+  auto& stats = mFuncStats[func];
+  stats.calls++;
+  if (stats.active++ == 0) stats.entryCycle = mCycles;
+}
+
+void Simulator::leaveFunction(MIRFunction* func) {
+  auto& stats = mFuncStats[func];
+  if (--stats.active == 0) stats.totalCycles += mCycles - stats.entryCycle;
+}
+
+bool Simulator::callRuntime(MIRFunction* callee, std::istream& in, std::ostream& out) {
+  auto name = callee->name();
+  /* the buffered I/O runtime behaves like sylib */
+  for (auto& [sylib, runtime] : SysYIORuntimeSymbols)
+    if (name == runtime) name = sylib;
+  auto& a0 = mGPR[X10 - GPRBegin];
+  const auto a1 = mGPR[X11 - GPRBegin];
+  const auto a2 = mGPR[X12 - GPRBegin];
+  auto& fa0 = mFPR[F10 - FPRBegin];
+  uint64_t cost = mConfig.runtimeCallCycles;
+  auto memFault = [&] {
+    mError = "invalid memory access in " + name;
+    return false;
+  };
+
+  auto readFloat = [&] {
+    std::string token;
+    in >> token;
+    return std::strtof(token.c_str(), nullptr);
+  };
+  auto printFloat = [&](float val) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%a", val);
+    out << buf;
+  };
+
+  if (name == "getint") {
+    int32_t val = 0;
+    in >> val;
+    a0 = val;
+  } else if (name == "getch") {
+    const auto ch = in.get();
+    a0 = ch == std::char_traits<char>::eof() ? -1 : ch;
+  } else if (name == "getfloat") {
+    fa0 = readFloat();
+  } else if (name == "getarray" || name == "getfarray") {
+    int32_t len = 0;
+    in >> len;
+    for (int32_t i = 0; i < len; i++) {
+      const auto addr = static_cast<uint64_t>(a0) + 4 * i;
+      bool ok;
+      if (name == "getarray") {
+        int32_t val = 0;
+        in >> val;
+        ok = store(addr, val);
+      } else {
+        ok = store(addr, readFloat());
+      }
+      if (not ok) return memFault();
+    }
+    cost += static_cast<uint64_t>(std::max(len, 0)) * mConfig.ioElementCycles;
+    a0 = len;
+  } else if (name == "putint") {
+    out << static_cast<int32_t>(a0);
+  } else if (name == "putch") {
+    out.put(static_cast<char>(a0));
+  } else if (name == "putfloat") {
+    printFloat(fa0);
+  } else if (name == "putarray" || name == "putfarray") {
+    const auto len = static_cast<int32_t>(a0);
+    out << len << ":";
+    for (int32_t i = 0; i < len; i++) {
+      const auto addr = static_cast<uint64_t>(a1) + 4 * i;
+      out << " ";
+      if (name == "putarray") {
+        int32_t val;
+        if (not load(addr, val)) return memFault();
+        out << val;
+      } else {
+        float val;
+        if (not load(addr, val)) return memFault();
+        printFloat(val);
+      }
+    }
+    out << "\n";
+    cost += static_cast<uint64_t>(std::max(len, 0)) * mConfig.ioElementCycles;
+  } else if (name == "_sysy_starttime" || name == "starttime") {
+    mTimerStart = mCycles;
+  } else if (name == "_sysy_stoptime" || name == "stoptime") {
+    mTimedCycles += mCycles - mTimerStart;
+  } else if (name == "_memset") {
+    /* for (i = 0; i * 4 < len; i++) a[i] = 0; */
+    const auto base = static_cast<uint64_t>(a0);
+    const auto len = static_cast<int32_t>(a1);
+    for (int64_t offset = 0; offset < len; offset += 4) {
+      if (not store(base + offset, int32_t{0})) return memFault();
+      if ((base + offset) % mConfig.lineBytes == 0 || offset == 0) {
+        dataAccess(base + offset, mRuntimeStats);
+      }
+    }
+    cost += std::max(len, 0) / 8;
+  } else if (name == "sysycMemfill" or name == "sysycMemcpy") {
+    /* dst[k] = val / src[k] for ascending k, as the loops LoopIdiom replaced */
+    const auto dst = static_cast<uint64_t>(a0);
+    const auto len = static_cast<int32_t>(a2);
+    for (int64_t offset = 0; offset < len; offset += 4) {
+      int32_t val = static_cast<int32_t>(a1);
+      if (name == "sysycMemcpy") {
+        if (not load(static_cast<uint64_t>(a1) + offset, val)) return memFault();
+      }
+      if (not store(dst + offset, val)) return memFault();
+      if ((dst + offset) % mConfig.lineBytes == 0 || offset == 0) {
+        dataAccess(dst + offset, mRuntimeStats);
+      }
+    }
+    cost += std::max(len, 0) / (name == "sysycMemcpy" ? 4 : 8);
+  } else if (name.starts_with("sysycProf")) {
+    /* -finstrument-loops hooks: only their cost, the report is the simulator's own */
+    cost = mConfig.profileHookCycles;
+  } else {
+    return false;
+  }
+  mRuntimeCycles[name] += cost;
+  advance(cost, mRuntimeStats);
+  return true;
+}
+
+bool Simulator::run(std::istream& in, std::ostream& out) {
+  const auto mainIter = mFunctionByName.find("main");
+  if (mainIter == mFunctionByName.end() || mainIter->second->blocks().empty()) {
+    mError = "no main function";
+    return false;
+  }
+  mState.emplace(mRenameMap);
+  mGPR[X2 - GPRBegin] = static_cast<int64_t>(stackTop);
+
+  Cursor cur{mainIter->second, 0, mLayout.at(mainIter->second).front()->insts().begin()};
+  const std::vector<MIRBlock*>* blocks = &mLayout.at(cur.func);
+  BlockStats* stats = &mBlockStats[blocks->front()];
+  stats->execCount++;
+  enterFunction(cur.func);
+
+  auto jumpTo = [&](MIRFunction* func, uint32_t block) {
+    if (func != cur.func) blocks = &mLayout.at(func);
+    cur = Cursor{func, block, (*blocks)[block]->insts().begin()};
+    stats = &mBlockStats[(*blocks)[block]];
+    stats->execCount++;
+  };
+
+  while (true) {
+    const auto block = (*blocks)[cur.block];
+    if (cur.inst == block->insts().end()) {
+      /* fall through */
+      if (cur.block + 1 >= blocks->size()) return fault("fell off the end of the function", cur);
+      jumpTo(cur.func, cur.block + 1);
+      continue;
+    }
+    const auto& inst = **cur.inst;
+    const auto next = std::next(cur.inst);
+    issue(inst, *stats);
+    mInsts++;
+    stats->instCount++;
+
+    const auto opcode = inst.opcode();
+    const auto op0 = inst.operand(0);
+    const auto op1 = inst.operand(1);
+    const auto op2 = inst.operand(2);
+
+    /* integer ops on (rs1, rs2 | imm) */
+    auto rs1 = [&] { return readGPR(op1); };
+    auto rs2 = [&] { return readGPR(op2); };
+    auto imm = [&] { return immOrAddr(op2); };
+    auto loadTo = [&](auto tag) {
+      using T = decltype(tag);
+      const auto addr = static_cast<uint64_t>(wrapAdd(readGPR(op2), immOrAddr(op1)));
+      T val;
+      if (not load(addr, val)) return fault("invalid load address " + std::to_string(addr), cur);
+      if (const auto extra = dataAccess(addr, *stats)) {
+        const auto latency = mState->queryRegisterLatency(inst, 0);
+        mState->makeRegisterReady(inst, 0, latency + extra);
+      }
+      if constexpr (std::is_same_v<T, float>) {
+        writeFPR(op0, val);
+      } else {
+        writeGPR(op0, static_cast<int64_t>(val));
+      }
+      return true;
+    };
+    auto storeFrom = [&](auto val) {
+      const auto addr = static_cast<uint64_t>(wrapAdd(readGPR(op2), immOrAddr(op1)));
+      if (not store(addr, val)) return fault("invalid store address " + std::to_string(addr), cur);
+      /* write-allocate, the store buffer hides the miss */
+      dataAccess(addr, *stats);
+      return true;
+    };
+    auto amo = [&](auto functor) {
+      const auto addr = static_cast<uint64_t>(readGPR(op2));
+      int32_t old;
+      if (not load(addr, old)) return fault("invalid atomic address " + std::to_string(addr), cur);
+      if (const auto extra = dataAccess(addr, *stats)) {
+        const auto latency = mState->queryRegisterLatency(inst, 0);
+        mState->makeRegisterReady(inst, 0, latency + extra);
+      }
+      store(addr, static_cast<int32_t>(functor(old, static_cast<int32_t>(readGPR(op1)))));
+      writeGPR(op0, old);
+      return true;
+    };
+    auto branch = [&](bool taken) {
+      const auto target = mBlockIndex.at(
+        const_cast<MIRBlock*>(op2.reloc()->dynCast<MIRBlock>()));
+      mBranches++;
+      if (not predict(inst, taken, target <= cur.block)) {
+        mMispredicts++;
+        stats->mispredicts++;
+        advance(mConfig.mispredictPenalty, *stats);
+      }
+      if (taken) {
+        /* a taken control transfer ends the issue group */
+        advance(1, *stats);
+        jumpTo(cur.func, target);
+      } else {
+        cur.inst = next;
+      }
+    };
+    auto call = [&](MIRFunction* callee) {
+      mCallStack.push_back(Cursor{cur.func, cur.block, next});
+      enterFunction(callee);
+      advance(1, *stats);
+      jumpTo(callee, 0);
+    };
+
+    bool ok = true;
+    bool fallThrough = true;  // continue with the next instruction
+    switch (opcode) {
+      /* RV64I register-register */
+      case ADD: writeGPR(op0, wrapAdd(rs1(), rs2())); break;
+      case ADDW: writeGPR(op0, sext32(wrapAdd(rs1(), rs2()))); break;
+      case SUB: writeGPR(op0, wrapSub(rs1(), rs2())); break;
+      case SUBW: writeGPR(op0, sext32(wrapSub(rs1(), rs2()))); break;
+      case XOR: writeGPR(op0, rs1() ^ rs2()); break;
+      case OR: writeGPR(op0, rs1() | rs2()); break;
+      case AND: writeGPR(op0, rs1() & rs2()); break;
+      case SLL: writeGPR(op0, static_cast<int64_t>(static_cast<uint64_t>(rs1()) << (rs2() & 63))); break;
+      case SRL: writeGPR(op0, static_cast<int64_t>(static_cast<uint64_t>(rs1()) >> (rs2() & 63))); break;
+      case SRA: writeGPR(op0, rs1() >> (rs2() & 63)); break;
+      case SLT: writeGPR(op0, rs1() < rs2()); break;
+      case SLTU: writeGPR(op0, static_cast<uint64_t>(rs1()) < static_cast<uint64_t>(rs2())); break;
+      case SLLW: writeGPR(op0, sext32(static_cast<uint32_t>(rs1()) << (rs2() & 31))); break;
+      case SRLW: writeGPR(op0, sext32(static_cast<uint32_t>(rs1()) >> (rs2() & 31))); break;
+      case SRAW: writeGPR(op0, sext32(static_cast<int32_t>(rs1()) >> (rs2() & 31))); break;
+      /* RV64I register-immediate */
+      case ADDI: writeGPR(op0, wrapAdd(rs1(), imm())); break;
+      case ADDIW: writeGPR(op0, sext32(wrapAdd(rs1(), imm()))); break;
+      case XORI: writeGPR(op0, rs1() ^ imm()); break;
+      case ORI: writeGPR(op0, rs1() | imm()); break;
+      case ANDI: writeGPR(op0, rs1() & imm()); break;
+      case SLTI: writeGPR(op0, rs1() < imm()); break;
+      case SLTIU: writeGPR(op0, static_cast<uint64_t>(rs1()) < static_cast<uint64_t>(imm())); break;
+      case SLLI: writeGPR(op0, static_cast<int64_t>(static_cast<uint64_t>(rs1()) << (imm() & 63))); break;
+      case SRLI: writeGPR(op0, static_cast<int64_t>(static_cast<uint64_t>(rs1()) >> (imm() & 63))); break;
+      case SRAI: writeGPR(op0, rs1() >> (imm() & 63)); break;
+      case SLLIW: writeGPR(op0, sext32(static_cast<uint32_t>(rs1()) << (imm() & 31))); break;
+      case SRLIW: writeGPR(op0, sext32(static_cast<uint32_t>(rs1()) >> (imm() & 31))); break;
+      case SRAIW: writeGPR(op0, sext32(static_cast<int32_t>(rs1()) >> (imm() & 31))); break;
+      /* Zba / Zbb */
+      case ADD_UW: writeGPR(op0, wrapAdd(zext32(rs1()), rs2())); break;
+      case SH1ADD: writeGPR(op0, wrapAdd(wrapMul(rs1(), 2), rs2())); break;
+      case SH2ADD: writeGPR(op0, wrapAdd(wrapMul(rs1(), 4), rs2())); break;
+      case SH3ADD: writeGPR(op0, wrapAdd(wrapMul(rs1(), 8), rs2())); break;
+      case SH1ADD_UW: writeGPR(op0, wrapAdd(zext32(rs1()) << 1, rs2())); break;
+      case SH2ADD_UW: writeGPR(op0, wrapAdd(zext32(rs1()) << 2, rs2())); break;
+      case SH3ADD_UW: writeGPR(op0, wrapAdd(zext32(rs1()) << 3, rs2())); break;
+      case SLLI_UW: writeGPR(op0, static_cast<int64_t>(static_cast<uint64_t>(zext32(rs1())) << (imm() & 63))); break;
+      case ANDN: writeGPR(op0, rs1() & ~rs2()); break;
+      case ORN: writeGPR(op0, rs1() | ~rs2()); break;
+      case XNOR: writeGPR(op0, ~(rs1() ^ rs2())); break;
+      case MIN: writeGPR(op0, std::min(rs1(), rs2())); break;
+      case MAX: writeGPR(op0, std::max(rs1(), rs2())); break;
+      case MINU: writeGPR(op0, static_cast<int64_t>(std::min<uint64_t>(rs1(), rs2()))); break;
+      case MAXU: writeGPR(op0, static_cast<int64_t>(std::max<uint64_t>(rs1(), rs2()))); break;
+      case CLZW: writeGPR(op0, std::countl_zero(static_cast<uint32_t>(rs1()))); break;
+      case CTZW: writeGPR(op0, std::countr_zero(static_cast<uint32_t>(rs1()))); break;
+      case CPOPW: writeGPR(op0, std::popcount(static_cast<uint32_t>(rs1()))); break;
+      /* RV64M */
+      case MUL: writeGPR(op0, wrapMul(rs1(), rs2())); break;
+      case MULW: writeGPR(op0, sext32(wrapMul(rs1(), rs2()))); break;
+      case MULH:
+        writeGPR(op0, static_cast<int64_t>((static_cast<__int128>(rs1()) * rs2()) >> 64));
+        break;
+      case MULHSU:
+        writeGPR(op0, static_cast<int64_t>(
+                        (static_cast<__int128>(rs1()) * static_cast<__int128>(static_cast<uint64_t>(rs2()))) >> 64));
+        break;
+      case MULHU:
+        writeGPR(op0, static_cast<int64_t>((static_cast<unsigned __int128>(static_cast<uint64_t>(rs1())) *
+                                            static_cast<uint64_t>(rs2())) >> 64));
+        break;
+      case DIV: writeGPR(op0, riscvDiv<int64_t>(rs1(), rs2())); break;
+      case DIVU: writeGPR(op0, static_cast<int64_t>(riscvDiv<uint64_t>(rs1(), rs2()))); break;
+      case REM: writeGPR(op0, riscvRem<int64_t>(rs1(), rs2())); break;
+      case REMU: writeGPR(op0, static_cast<int64_t>(riscvRem<uint64_t>(rs1(), rs2()))); break;
+      case DIVW: writeGPR(op0, riscvDiv<int32_t>(rs1(), rs2())); break;
+      case DIVUW: writeGPR(op0, sext32(riscvDiv<uint32_t>(rs1(), rs2()))); break;
+      case REMW: writeGPR(op0, riscvRem<int32_t>(rs1(), rs2())); break;
+      case REMUW: writeGPR(op0, sext32(riscvRem<uint32_t>(rs1(), rs2()))); break;
+      /* constants and addresses */
+      case LUI: writeGPR(op0, sext32(static_cast<uint64_t>(immOrAddr(op1)) << 12)); break;
+      case AUIPC:
+      case LLA:
+      case LoadImm12:
+      case LoadImm32:
+      case LoadImm64: writeGPR(op0, immOrAddr(op1)); break;
+      case MV: writeGPR(op0, rs1()); break;
+      /* memory */
+      case LB: ok = loadTo(int8_t{}); break;
+      case LH: ok = loadTo(int16_t{}); break;
+      case LW: ok = loadTo(int32_t{}); break;
+      case LBU: ok = loadTo(uint8_t{}); break;
+      case LHU: ok = loadTo(uint16_t{}); break;
+      case LD: ok = loadTo(int64_t{}); break;
+      case FLW: ok = loadTo(float{}); break;
+      case SB: ok = storeFrom(static_cast<int8_t>(readGPR(op0))); break;
+      case SH: ok = storeFrom(static_cast<int16_t>(readGPR(op0))); break;
+      case SW: ok = storeFrom(static_cast<int32_t>(readGPR(op0))); break;
+      case SD: ok = storeFrom(readGPR(op0)); break;
+      case FSW: ok = storeFrom(readFPR(op0)); break;
+      /* a hint: fills the line, nothing waits for it */
+      case PREFETCH_R:
+        dataAccess(static_cast<uint64_t>(wrapAdd(readGPR(op1), immOrAddr(op0))), *stats);
+        break;
+      case AMOSWAP_W: ok = amo([](int32_t, int32_t val) { return val; }); break;
+      case AMOADD_W:
+        ok = amo([](int32_t old, int32_t val) { return static_cast<int32_t>(wrapAdd(old, val)); });
+        break;
+      case AMOAND_W: ok = amo([](int32_t old, int32_t val) { return old & val; }); break;
+      case AMOOR_W: ok = amo([](int32_t old, int32_t val) { return old | val; }); break;
+      case AMOXOR_W: ok = amo([](int32_t old, int32_t val) { return old ^ val; }); break;
+      /* RV32F */
+      case FADD_S: writeFPR(op0, readFPR(op1) + readFPR(op2)); break;
+      case FSUB_S: writeFPR(op0, readFPR(op1) - readFPR(op2)); break;
+      case FMUL_S: writeFPR(op0, readFPR(op1) * readFPR(op2)); break;
+      case FDIV_S: writeFPR(op0, readFPR(op1) / readFPR(op2)); break;
+      case FMIN_S: writeFPR(op0, std::fmin(readFPR(op1), readFPR(op2))); break;
+      case FMAX_S: writeFPR(op0, std::fmax(readFPR(op1), readFPR(op2))); break;
+      case FMADD_S: writeFPR(op0, std::fma(readFPR(op1), readFPR(op2), readFPR(inst.operand(3)))); break;
+      case FMSUB_S: writeFPR(op0, std::fma(readFPR(op1), readFPR(op2), -readFPR(inst.operand(3)))); break;
+      case FNMSUB_S: writeFPR(op0, std::fma(-readFPR(op1), readFPR(op2), readFPR(inst.operand(3)))); break;
+      case FNMADD_S: writeFPR(op0, std::fma(-readFPR(op1), readFPR(op2), -readFPR(inst.operand(3)))); break;
+      case FNEG_S: writeFPR(op0, -readFPR(op1)); break;
+      case FABS_S: writeFPR(op0, std::fabs(readFPR(op1))); break;
+      case FMV_S:
+      case FSGNJ_S: writeFPR(op0, readFPR(op1)); break;
+      case FSQRT_S: writeFPR(op0, std::sqrt(readFPR(op1))); break;
+      case FCLASS_S: writeGPR(op0, fclass(readFPR(op1))); break;
+      case FMV_X_W: {
+        int32_t bits;
+        const auto val = readFPR(op1);
+        memcpy(&bits, &val, sizeof(bits));
+        writeGPR(op0, bits);
+      } break;
+      case FMV_W_X: {
+        const auto bits = static_cast<uint32_t>(rs1());
+        float val;
+        memcpy(&val, &bits, sizeof(val));
+        writeFPR(op0, val);
+      } break;
+      case FCVT_W_S: writeGPR(op0, fcvtWS(readFPR(op1), true)); break;
+      case FCVT_WU_S: writeGPR(op0, fcvtWUS(readFPR(op1))); break;
+      case FCVT_S_W: writeFPR(op0, static_cast<float>(static_cast<int32_t>(rs1()))); break;
+      case FCVT_S_WU: writeFPR(op0, static_cast<float>(static_cast<uint32_t>(rs1()))); break;
+      case FEQ_S: writeGPR(op0, readFPR(op1) == readFPR(op2)); break;
+      case FLT_S: writeGPR(op0, readFPR(op1) < readFPR(op2)); break;
+      case FLE_S: writeGPR(op0, readFPR(op1) <= readFPR(op2)); break;
+      /* control flow */
+      case BEQ: fallThrough = false; branch(readGPR(op0) == rs1()); break;
+      case BNE: fallThrough = false; branch(readGPR(op0) != rs1()); break;
+      case BLT: fallThrough = false; branch(readGPR(op0) < rs1()); break;
+      case BGE: fallThrough = false; branch(readGPR(op0) >= rs1()); break;
+      case BLE: fallThrough = false; branch(readGPR(op0) <= rs1()); break;
+      case BGT: fallThrough = false; branch(readGPR(op0) > rs1()); break;
+      case BLTU: fallThrough = false; branch(static_cast<uint64_t>(readGPR(op0)) < static_cast<uint64_t>(rs1())); break;
+      case BGEU: fallThrough = false; branch(static_cast<uint64_t>(readGPR(op0)) >= static_cast<uint64_t>(rs1())); break;
+      case BLEU: fallThrough = false; branch(static_cast<uint64_t>(readGPR(op0)) <= static_cast<uint64_t>(rs1())); break;
+      case BGTU: fallThrough = false; branch(static_cast<uint64_t>(readGPR(op0)) > static_cast<uint64_t>(rs1())); break;
+      case J: {
+        fallThrough = false;
+        advance(1, *stats);
+        if (auto target = op0.reloc()->dynCast<MIRBlock>()) {
+          jumpTo(cur.func, mBlockIndex.at(const_cast<MIRBlock*>(target)));
+        } else if (auto callee = op0.reloc()->dynCast<MIRFunction>()) {
+          /* tail call */
+          leaveFunction(cur.func);
+          enterFunction(const_cast<MIRFunction*>(callee));
+          jumpTo(const_cast<MIRFunction*>(callee), 0);
+        } else {
+          ok = fault("unknown jump target", cur);
+        }
+      } break;
+      case JAL: {
+        fallThrough = false;
+        const auto callee = const_cast<MIRFunction*>(op0.reloc()->dynCast<MIRFunction>());
+        if (callee == nullptr) {
+          ok = fault("unknown call target", cur);
+        } else if (not callee->blocks().empty()) {
+          call(callee);
+        } else if (callee->name() == "parallelFor") {
+          /* parallelFor(beg, end, body, payload): body(beg, end, payload) on this hart */
+          const auto body = mFunctionAt.find(static_cast<uint64_t>(mGPR[X12 - GPRBegin]));
+          if (body == mFunctionAt.end() || body->second->blocks().empty()) {
+            ok = fault("invalid parallelFor body", cur);
+          } else {
+            mRuntimeCycles["parallelFor"] += mConfig.runtimeCallCycles;
+            advance(mConfig.runtimeCallCycles, mRuntimeStats);
+            mGPR[X12 - GPRBegin] = mGPR[X13 - GPRBegin];
+            call(body->second);
+          }
+        } else if (callee->name().rfind("parallelForRegion", 0) == 0) {
+          /* parallelForRegionN(beg0, end0, body0, payload0, ...): the bodies in order on
+           * this hart, a0-a7 then 8-byte stack slots */
+          const auto count = std::stoul(callee->name().substr(sizeof("parallelForRegion") - 1));
+          auto argument = [&](uint32_t idx) {
+            int64_t val = 0;
+            if (idx < 8) return mGPR[X10 - GPRBegin + idx];
+            load(static_cast<uint64_t>(mGPR[X2 - GPRBegin]) + (idx - 8) * 8, val);
+            return val;
+          };
+          std::vector<RegionBody> bodies;
+          for (uint32_t idx = 0; idx < count * 4; idx += 4) {
+            const auto body = mFunctionAt.find(static_cast<uint64_t>(argument(idx + 2)));
+            if (body == mFunctionAt.end() || body->second->blocks().empty()) break;
+            bodies.push_back(RegionBody{mCallStack.size(), static_cast<int32_t>(argument(idx)),
+                                        static_cast<int32_t>(argument(idx + 1)),
+                                        argument(idx + 3), body->second});
+          }
+          if (bodies.size() != count) {
+            ok = fault("invalid parallelForRegion body", cur);
+          } else {
+            mRuntimeCycles[callee->name()] += mConfig.runtimeCallCycles;
+            advance(mConfig.runtimeCallCycles, mRuntimeStats);
+            mRegionBodies.insert(mRegionBodies.end(), bodies.rbegin(), std::prev(bodies.rend()));
+            mGPR[X10 - GPRBegin] = bodies.front().beg;
+            mGPR[X11 - GPRBegin] = bodies.front().end;
+            mGPR[X12 - GPRBegin] = bodies.front().payload;
+            call(bodies.front().body);
+          }
+        } else if (callee->name() == "parallelInvoke2") {
+          /* parallelInvoke2(task0, payload0, task1, payload1): task0 then task1 on this hart */
+          const auto task0 = mFunctionAt.find(static_cast<uint64_t>(mGPR[X10 - GPRBegin]));
+          const auto task1 = mFunctionAt.find(static_cast<uint64_t>(mGPR[X12 - GPRBegin]));
+          if (task0 == mFunctionAt.end() || task0->second->blocks().empty() ||
+              task1 == mFunctionAt.end() || task1->second->blocks().empty()) {
+            ok = fault("invalid parallelInvoke2 task", cur);
+          } else {
+            mRuntimeCycles["parallelInvoke2"] += mConfig.runtimeCallCycles;
+            advance(mConfig.runtimeCallCycles, mRuntimeStats);
+            mRegionBodies.push_back(
+              RegionBody{mCallStack.size(), 0, 0, mGPR[X13 - GPRBegin], task1->second, true});
+            mGPR[X10 - GPRBegin] = mGPR[X11 - GPRBegin];
+            call(task0->second);
+          }
+        } else if (callRuntime(callee, in, out)) {
+          cur.inst = next;
+        } else {
+          ok = fault(mError.empty() ? "unsupported runtime call " + callee->name() : mError, cur);
+        }
+      } break;
+      case RET: {
+        fallThrough = false;
+        advance(1, *stats);
+        leaveFunction(cur.func);
+        if (mCallStack.empty()) {
+          mExitCode = static_cast<int32_t>(mGPR[X10 - GPRBegin]);
+          return true;
+        }
+        const auto ret = mCallStack.back();
+        mCallStack.pop_back();
+        if (not mRegionBodies.empty() && mRegionBodies.back().depth == mCallStack.size()) {
+          /* next loop of a fork-join region (second task), the barrier costs a runtime call */
+          const auto next = mRegionBodies.back();
+          mRegionBodies.pop_back();
+          advance(mConfig.runtimeCallCycles, mRuntimeStats);
+          if (next.task) {
+            mGPR[X10 - GPRBegin] = next.payload;
+          } else {
+            mGPR[X10 - GPRBegin] = next.beg;
+            mGPR[X11 - GPRBegin] = next.end;
+            mGPR[X12 - GPRBegin] = next.payload;
+          }
+          mCallStack.push_back(ret);
+          enterFunction(next.body);
+          jumpTo(next.body, 0);
+          break;
+        }
+        blocks = &mLayout.at(ret.func);
+        cur = ret;
+        stats = &mBlockStats[(*blocks)[cur.block]];
+      } break;
+      default: {
+        auto& info = mTarget.getTargetInstInfo().getInstInfo(opcode);
+        ok = fault("unsupported instruction " + std::string(info.name()), cur);
+      }
+    }
+    if (not ok) return false;
+    if (fallThrough) cur.inst = next;
+  }
+}
+
+void Simulator::report(std::ostream& os, size_t topBlocks) const {
+  auto percent = [&](uint64_t part) {
+    return mCycles == 0 ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(mCycles);
+  };
+  auto ratio = [](uint64_t part, uint64_t whole) {
+    return whole == 0 ? 0.0 : static_cast<double>(part) / static_cast<double>(whole);
+  };
+  const auto flags = os.flags();
+  os << std::fixed << std::setprecision(2);
+  os << "==== sifive-u74 cycle-approximate simulation ====\n";
+  if (not mError.empty()) os << "error        : " << mError << "\n";
+  os << "exit code    : " << mExitCode << "\n";
+  os << "instructions : " << mInsts << "\n";
+  os << "cycles       : " << mCycles << " (IPC " << ratio(mInsts, mCycles) << ")\n";
+  os << "timed cycles : " << mTimedCycles << " (starttime/stoptime)\n";
+  os << "branches     : " << mBranches << ", mispredicted " << mMispredicts << " ("
+     << 100.0 * ratio(mMispredicts, mBranches) << "%)\n";
+  os << "L1D accesses : " << mMemAccesses << ", misses " << mL1DMisses << " ("
+     << 100.0 * ratio(mL1DMisses, mMemAccesses) << "%), L2 misses " << mL2Misses << "\n";
+
+  /* functions, by inclusive cycles; self cycles are those of the function's own blocks */
+  std::unordered_map<MIRFunction*, uint64_t> selfCycles;
+  for (auto& [block, stats] : mBlockStats) {
+    selfCycles[block->parent()] += stats.cycles;
+  }
+  std::vector<std::pair<MIRFunction*, FunctionStats>> funcs(mFuncStats.begin(), mFuncStats.end());
+  std::sort(funcs.begin(), funcs.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.totalCycles > rhs.second.totalCycles;
+  });
+  os << "\n" << std::left << std::setw(32) << "function" << std::right << std::setw(12) << "calls"
+     << std::setw(16) << "self" << std::setw(9) << "self%" << std::setw(16) << "total"
+     << std::setw(9) << "total%" << "\n";
+  for (auto& [func, stats] : funcs) {
+    const auto self = selfCycles[func];
+    os << std::left << std::setw(32) << func->name() << std::right << std::setw(12) << stats.calls
+       << std::setw(16) << self << std::setw(9) << percent(self) << std::setw(16)
+       << stats.totalCycles << std::setw(9) << percent(stats.totalCycles) << "\n";
+  }
+  for (auto& [name, cycles] : mRuntimeCycles) {
+    os << std::left << std::setw(32) << ("[runtime] " + name) << std::right << std::setw(12) << "-"
+       << std::setw(16) << cycles << std::setw(9) << percent(cycles) << "\n";
+  }
+
+  /* hottest blocks */
+  std::vector<std::pair<MIRBlock*, BlockStats>> blocks(mBlockStats.begin(), mBlockStats.end());
+  std::sort(blocks.begin(), blocks.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.cycles > rhs.second.cycles;
+  });
+  if (blocks.size() > topBlocks) blocks.resize(topBlocks);
+  os << "\n" << std::left << std::setw(40) << "block" << std::right << std::setw(12) << "execs"
+     << std::setw(14) << "insts" << std::setw(16) << "cycles" << std::setw(9) << "%"
+     << std::setw(12) << "cyc/exec" << std::setw(12) << "mispred" << std::setw(12) << "L1D miss"
+     << "\n";
+  for (auto& [block, stats] : blocks) {
+    os << std::left << std::setw(40) << (block->parent()->name() + ":" + block->name())
+       << std::right << std::setw(12) << stats.execCount << std::setw(14) << stats.instCount
+       << std::setw(16) << stats.cycles << std::setw(9) << percent(stats.cycles) << std::setw(12)
+       << ratio(stats.cycles, stats.execCount) << std::setw(12) << stats.mispredicts
+       << std::setw(12) << stats.cacheMisses << "\n";
+  }
+  os.flags(flags);
+}
+
+RISCV_NAMESPACE_END
@@ -5,6 +5,7 @@
 #include "autogen/riscv/InstInfoDecl.hpp"
 #include "autogen/riscv/ISelInfoDecl.hpp"
 #include "support/StaticReflection.hpp"
+#include <unordered_set>
 
 namespace mir {
 /**
@@ -114,7 +115,38 @@ void RISCVTarget::emit_assembly(std::ostream& out, MIRModule& module) {
   // out
   //   << R"(.attribute arch, "rv64i2p1_m2p0_a2p1_f2p2_d2p2_c2p0_zicsr2p0_zifencei2p0_zba1p0_zbb1p0")"
   //   << '\n';
-  out << SysYRuntime << std::endl;
+  /* runtime symbols referenced by the code (calls, address loads); declarations alone are
+   * not enough: _memset is declared by every LoweringContext */
+  std::unordered_set<std::string> referenced;
+  for (auto& func : module.functions()) {
+    for (auto& block : func->blocks()) {
+      for (auto inst : block->insts()) {
+        auto& info = target.getTargetInstInfo().getInstInfo(inst->opcode());
+        for (uint32_t idx = 0; idx < info.operand_num(); idx++) {
+          const auto op = inst->operand(idx);
+          if (op.isReloc()) referenced.insert(op.reloc()->name());
+        }
+      }
+    }
+  }
+  bool profile = false, region = false, io = false;
+  const bool task = referenced.count("parallelInvoke2") > 0;
+  for (auto& name : referenced) {
+    profile |= name == "sysycProfInit";
+    region |= name.rfind("parallelForRegion", 0) == 0;
+  }
+  for (auto& [sylib, runtime] : SysYIORuntimeSymbols)
+    io |= referenced.count(runtime) > 0;
+  out << SysYRuntimePrologue << std::endl;
+  if (referenced.count("_memset") or referenced.count("sysycMemfill") or
+      referenced.count("sysycMemcpy"))
+    out << SysYMemsetRuntime << std::endl;
+  /* serial programs skip the thread pool */
+  if (region or task or referenced.count("parallelFor")) out << SysYParallelForRuntime << std::endl;
+  if (profile) out << SysYLoopProfileRuntime << std::endl;
+  if (region) out << SysYParallelRegionRuntime << std::endl;
+  if (task) out << SysYTaskParallelRuntime << std::endl;
+  if (io) out << SysYIORuntime << std::endl;
   CodeGenContext codegen_ctx{target, target.getDataLayout(), target.getTargetInstInfo(),
                              target.getTargetFrameInfo(), MIRFlags{false, false}};
   dumpAssembly(out, module, codegen_ctx);
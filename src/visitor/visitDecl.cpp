@@ -98,6 +98,7 @@ Value* SysYIRGenerator::visitGlobalArray(SysYParser::VarDefContext* ctx,
   auto global_var = GlobalVariable::gen(btype, Arrayinit, mModule, name, is_const, dims, is_init, capacity);
   mTables.insert(name, global_var);
   mModule->addGlobalVar(name, global_var);
+  if (is_const) recordConstArray(global_var, Arrayinit, btype);
 
   return dyn_cast_Value(global_var);
 }
@@ -191,6 +192,8 @@ Value* SysYIRGenerator::visitLocalArray(SysYParser::VarDefContext* ctx,
     }
   }
 
+  if (is_const) recordConstArray(alloca_ptr, Arrayinit, btype);
+
   //! assign
   if (!isAssign) return dyn_cast_Value(alloca_ptr);
   Value* element_ptr = dyn_cast<Value>(alloca_ptr);
@@ -214,6 +217,23 @@ Value* SysYIRGenerator::visitLocalArray(SysYParser::VarDefContext* ctx,
   return dyn_cast_Value(alloca_ptr);
 }
 
+/*
+ * @brief: recordConstArray
+ * @details:
+ *    keep the initializer of a const array (missing elements are zero) for
+ *    visitVarExp, which reads constant-index elements without gep/load
+ */
+void SysYIRGenerator::recordConstArray(Value* array, const std::vector<Value*>& init, Type* btype) {
+  const auto zero = ConstantValue::get(btype, static_cast<intmax_t>(0));
+  std::vector<Value*> values;
+  values.reserve(init.size());
+  for (auto val : init) {
+    if (val and not val->isa<ConstantValue>()) return;
+    values.push_back(val ? val : zero);
+  }
+  mConstArrays.emplace(array, std::move(values));
+}
+
 /*
  * @brief: visitLocalScalar
  * @details:
@@ -1,4 +1,5 @@
 #include <any>
+#include <cstdint>
 #include "visitor/visitor.hpp"
 #include "ir/ConstantValue.hpp"
 using namespace ir;
@@ -29,6 +30,22 @@ std::any SysYIRGenerator::visitNumberExp(SysYParser::NumberExpContext* ctx) {
   return dyn_cast_Value(res);
 }
 
+/* element of a const array at constant indices, nullptr if not known at compile time */
+Value* SysYIRGenerator::constArrayElement(Value* array, const std::vector<Value*>& indices) {
+  const auto iter = mConstArrays.find(array);
+  if (iter == mConstArrays.end()) return nullptr;
+  const auto& dims = array->type()->as<PointerType>()->baseType()->as<ArrayType>()->dims();
+  if (indices.size() != dims.size()) return nullptr;
+  size_t offset = 0;
+  for (size_t i = 0; i < dims.size(); i++) {
+    const auto idx = indices[i]->dynCast<ConstantInteger>();
+    if (idx == nullptr or not idx->type()->isInt32()) return nullptr;
+    if (idx->i32() < 0 or static_cast<size_t>(idx->i32()) >= dims[i]) return nullptr;
+    offset = offset * dims[i] + idx->i32();
+  }
+  return offset < iter->second.size() ? iter->second[offset] : nullptr;
+}
+
 /*
  * @brief: visitVarExp
  * @details:
@@ -65,8 +82,13 @@ std::any SysYIRGenerator::visitVarExp(SysYParser::VarExpContext* ctx) {
       auto dims = atype->dims(), cur_dims(dims);
 
       int delta = dims.size() - ctx->var()->exp().size();
-      for (auto expr : ctx->var()->exp()) {
-        auto idx = any_cast_Value(visit(expr));
+      std::vector<Value*> indices;
+      for (auto expr : ctx->var()->exp())
+        indices.push_back(any_cast_Value(visit(expr)));
+      /* const array read with constant indices -> element value, no gep/load */
+      if (auto element = constArrayElement(ptr, indices)) return dyn_cast_Value(element);
+
+      for (auto idx : indices) {
         dims.erase(dims.begin());
         ptr = mBuilder.makeGetElementPtr(base_type, ptr, idx, dims, cur_dims);
         cur_dims.erase(cur_dims.begin());
@@ -244,7 +266,26 @@ std::any SysYIRGenerator::visitParenExp(SysYParser::ParenExpContext* ctx) {
   return any_cast_Value(visit(ctx->exp()));
 }
 
+/* constant to the type of the other operand: i1 -> i32 -> float */
+static Value* promoteConstant(IRBuilder& builder, Value* val, Type* type) {
+  if (val->type()->isBool()) val = ConstantInteger::gen_i32(val->as<ConstantValue>()->i1());
+  if (val->type()->btype() >= type->btype()) return val;
+  return builder.castConstantType(val, type);
+}
+
 ir::Value* SysYIRGenerator::visitBinaryExp(ir::BinaryOp op, ir::Value* lhs, ir::Value* rhs) {
+  if (lhs->isa<ConstantValue>() and rhs->isa<ConstantValue>()) {
+    const auto clhs = promoteConstant(mBuilder, lhs, rhs->type());
+    const auto crhs = promoteConstant(mBuilder, rhs, clhs->type());
+    const auto type = clhs->type();
+    if (type->isSame(crhs->type()) and (type->isInt32() or type->isFloat32()) and
+        not(type->isFloat32() and op == BinaryOp::REM)) {
+      const auto kind = IRBuilder::binaryValueId(op, type);
+      if (auto res = BinaryInst::foldConstant(kind, clhs->as<ConstantValue>(),
+                                              crhs->as<ConstantValue>()))
+        return res;
+    }
+  }
   lhs = mBuilder.promoteTypeBeta(lhs, rhs->type());
   rhs = mBuilder.promoteTypeBeta(rhs, lhs->type());
   return mBuilder.makeBinary(op, lhs, rhs);
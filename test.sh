@@ -21,6 +21,11 @@ PASSES=()
 OPT_LEVEL="-O0"
 LOG_LEVEL="-L0"
 
+# -F <tol>: compile with -ffast-math, numbers with a fraction or exponent may differ from the
+# strict reference by tol relative (absolute below 1), everything else must match exactly
+FLOAT_TOL=""
+FAST_MATH=""
+
 # Color setting
 RED=$(tput setaf 1)
 GREEN=$(tput setaf 2)
@@ -60,14 +65,15 @@ usage() {
     echo "  -t <test_path>  Specify the directory containing test files or single file (default: test/local_test)"
     echo "  -o <output_dir>     Specify the output directory (default: test/.out/)"
     echo "  -r <result_file>    Specify the file to store the test results (default: test/result.txt)"
+    echo "  -F <tol>            Compile with -ffast-math, compare floats within relative tolerance tol"
     echo "  -h                  Print this help message"
 }
 # ./test.sh -t test/2021/functional/001_var_defn.sy -p mem2reg -p dce
 # Parse command line arguments
 
 # getopt
-SHORT="h,t:,o:,r:,p:,O:,L:"
-LONG="help,test_path:,output_dir:,result_file:,pass:opt_level:,log_level:"
+SHORT="h,t:,o:,r:,p:,O:,L:,F:"
+LONG="help,test_path:,output_dir:,result_file:,pass:,opt_level:,log_level:,fast_math:"
 OPTS=$(getopt --options $SHORT --longoptions $LONG --name "$0" -- "$@")
 
 if [ $? -ne 0 ]; then
@@ -109,6 +115,11 @@ while true; do
         LOG_LEVEL="-L$2"
         shift 2
         ;;
+    -F | --fast_math)
+        FLOAT_TOL="$2"
+        FAST_MATH="-ffast-math"
+        shift 2
+        ;;
     --)
         shift
         break
@@ -170,7 +181,12 @@ function run_llvm_test() {
     cat "${sy_h}" >"${llvm_c}"
     cat "${single_file}" >>"${llvm_c}"
 
-    clang --no-warnings -emit-llvm -S "${llvm_c}" -o "${llvm_ll}"  -O3 -std=c90 
+    # the reference stays strict: no fma contraction either when comparing with -F
+    if [ -n "${FLOAT_TOL}" ]; then
+        clang --no-warnings -emit-llvm -S "${llvm_c}" -o "${llvm_ll}" -O3 -std=c90 -ffp-contract=off
+    else
+        clang --no-warnings -emit-llvm -S "${llvm_c}" -o "${llvm_ll}"  -O3 -std=c90 
+    fi
     # # ./compiler -f "${llvm_c}" -i -o "${llvm_ll}"
     # opt -O3 -debug-pass-manager "${llvm_ll}" -o "${llvm_ll}"
     # ./compiler -f "${single_file}" -i  -o "${llvm_ll}" "${OPT_LEVEL}" "${LOG_LEVEL}"
@@ -211,7 +227,7 @@ function run_gen_test() {
     cat "${single_file}" >"${gen_c}"
 
     # ./compiler "$single_file" >"${gen_ll}"
-    $compiler_path -f "${single_file}" -i -t ${PASSES_STR} -o "${gen_ll}" "${OPT_LEVEL}" "${LOG_LEVEL}"
+    $compiler_path -f "${single_file}" -i -t ${PASSES_STR} -o "${gen_ll}" "${OPT_LEVEL}" "${LOG_LEVEL}" ${FAST_MATH}
     if [ $? != 0 ]; then
         return $EC_MAIN
     fi
@@ -240,6 +256,38 @@ function run_gen_test() {
     # gen compiler end
     return ${res}
 }
+# diff of two outputs, numbers with a fraction or exponent (%a or decimal) within FLOAT_TOL
+function diff_float() {
+    python3 - "$1" "$2" "${FLOAT_TOL}" <<'EOF'
+import sys
+
+
+def parse(token):
+    if not any(c in token for c in ".pPeE"):
+        return None
+    try:
+        return float.fromhex(token) if "x" in token.lower() else float(token)
+    except ValueError:
+        return None
+
+
+gen, ref = (open(path).read().split() for path in sys.argv[1:3])
+tol = float(sys.argv[3])
+if len(gen) != len(ref):
+    print(f"{len(gen)} tokens, expected {len(ref)}")
+    sys.exit(1)
+for idx, (lhs, rhs) in enumerate(zip(gen, ref)):
+    a, b = parse(lhs), parse(rhs)
+    if a is None or b is None:
+        if lhs != rhs:
+            print(f"token {idx}: {lhs} != {rhs}")
+            sys.exit(1)
+    elif abs(a - b) > tol * max(1.0, abs(a), abs(b)):
+        print(f"token {idx}: {lhs} ({a}) vs {rhs} ({b}) beyond {tol}")
+        sys.exit(1)
+EOF
+}
+
 # define a function that test one file
 function run_test() {
     local single_file="$1"
@@ -256,7 +304,11 @@ function run_test() {
         local res=$?
 
         # diff "${output_dir}/gen.out" "${output_dir}/llvm.out" >"/dev/null"
-        diff "${gen_out}" "${llvm_out}" >"${output_dir}/diff.out"
+        if [ -n "${FLOAT_TOL}" ]; then
+            diff_float "${gen_out}" "${llvm_out}" >"${output_dir}/diff.out"
+        else
+            diff "${gen_out}" "${llvm_out}" >"${output_dir}/diff.out"
+        fi
         local diff_res=$?
         # diff res or diff stdout
         echo "[RESULT] res (${RED}${res}${RESET}), llvmres (${RED}${llvmres}${RESET})"
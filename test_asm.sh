@@ -32,6 +32,7 @@ SKIP_CNT=0
 WRONG_FILES=()
 TIMEOUT_FILES=()
 PASSES=()
+COMPILER_FLAGS=()
 
 OPT_LEVEL="-O0"
 LOG_LEVEL="-L0"
@@ -62,11 +63,12 @@ usage() {
     echo "  -t <test_path>  Specify the directory containing test files or single file (default: test/local_test)"
     echo "  -o <output_dir>     Specify the output directory (default: test/.out/)"
     echo "  -r <result_file>    Specify the file to store the test results (default: test/result.txt)"
+    echo "  -c <flag>           Extra compiler flag, e.g. -c -fprefetch-loops -c -Xprefetch.max-distance=4"
     echo "  -h                  Print this help message"
 }
 
-SHORT="h,t:,o:,r:,p:,O:,L:"
-LONG="help,test_path:,output_dir:,result_file:,pass:opt_level:,log_level:"
+SHORT="h,t:,o:,r:,p:,O:,L:,c:"
+LONG="help,test_path:,output_dir:,result_file:,pass:opt_level:,log_level:,compiler_flag:"
 OPTS=$(getopt --options $SHORT --longoptions $LONG --name "$0" -- "$@")
 if [ $? -ne 0 ]; then
     echo "Error parsing command line arguments" >&2
@@ -105,6 +107,10 @@ while true; do
         LOG_LEVEL="-L$2"
         shift 2
         ;;
+    -c | --compiler_flag)
+        COMPILER_FLAGS+=("$2")
+        shift 2
+        ;;
     --)
         shift
         break
@@ -194,16 +200,16 @@ function run_compiler_test() {
     cat "${single_file}" >"${gen_c}"
 
     # emit llvm ir
-    timeout $TIMEOUT $compiler_path -f "${single_file}" -i -t ${PASSES_STR} -o "${gen_ll}" "${OPT_LEVEL}" "${LOG_LEVEL}"
+    timeout $TIMEOUT $compiler_path -f "${single_file}" -i -t ${PASSES_STR} -o "${gen_ll}" "${OPT_LEVEL}" "${LOG_LEVEL}" "${COMPILER_FLAGS[@]}"
     if [ $? != 0 ]; then
-        echo "${RED}[TIMEOUT]${RESET}: $compiler_path -f ${single_file} -i -t ${PASSES_STR} -o ${gen_ll} ${OPT_LEVEL} ${LOG_LEVEL}"
+        echo "${RED}[TIMEOUT]${RESET}: $compiler_path -f ${single_file} -i -t ${PASSES_STR} -o ${gen_ll} ${OPT_LEVEL} ${LOG_LEVEL} ${COMPILER_FLAGS[*]}"
         return $EC_MAIN
     fi
     # emit assembly code
-    timeout $TIMEOUT $compiler_path -f "${single_file}" -S -t ${PASSES_STR} -o "${gen_s}" "${OPT_LEVEL}" "${LOG_LEVEL}"
+    timeout $TIMEOUT $compiler_path -f "${single_file}" -S -t ${PASSES_STR} -o "${gen_s}" "${OPT_LEVEL}" "${LOG_LEVEL}" "${COMPILER_FLAGS[@]}"
     mainres=$?
     if [ $mainres == $EC_TIMEOUT ]; then
-        echo "${RED}[TIMEOUT]${RESET}: $compiler_path -f ${single_file} -S -t ${PASSES_STR} -o ${gen_s} ${OPT_LEVEL} ${LOG_LEVEL}"
+        echo "${RED}[TIMEOUT]${RESET}: $compiler_path -f ${single_file} -S -t ${PASSES_STR} -o ${gen_s} ${OPT_LEVEL} ${LOG_LEVEL} ${COMPILER_FLAGS[*]}"
         return $EC_TIMEOUT
     fi
     if [ $mainres != 0 ]; then